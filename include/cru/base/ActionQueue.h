@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Base.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cru {
+/**
+ * Lock-free multi-producer single-consumer queue of void() actions. Push is
+ * wait-free apart from one allocation, in which a callable of up to
+ * kInlineSize bytes is stored directly. Only one thread may call RunSome.
+ * Actions left when the queue is destroyed are dropped without running.
+ */
+class MpscActionQueue : public Object {
+ public:
+  constexpr static std::size_t kInlineSize = 6 * sizeof(void*);
+
+  MpscActionQueue() : head_(&stub_), tail_(&stub_) {}
+
+  CRU_DELETE_COPY(MpscActionQueue)
+  CRU_DELETE_MOVE(MpscActionQueue)
+
+  ~MpscActionQueue() override {
+    while (auto node = Pop()) {
+      delete node;
+    }
+  }
+
+  /**
+   * Thread-safe. Returns the approximate number of queued actions before this
+   * one, so the producer that makes the queue non-empty can wake the consumer.
+   */
+  template <typename F>
+  Index Push(F&& action) {
+    auto node = new Node(std::forward<F>(action));
+    auto previous_size = size_.fetch_add(1, std::memory_order_relaxed);
+    auto previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+    return previous_size;
+  }
+
+  /**
+   * Consumer only. Run at most max_count actions in order and return how many
+   * ran. An action being pushed concurrently may be left for the next call.
+   */
+  Index RunSome(Index max_count) {
+    Index count = 0;
+    while (count < max_count) {
+      auto node = Pop();
+      if (node == nullptr) break;
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      count++;
+      // Freed even if the action throws.
+      std::unique_ptr<Node> guard(node);
+      node->Invoke();
+    }
+    return count;
+  }
+
+  /** Approximate when called concurrently with Push. */
+  Index GetSize() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node {
+    Node() = default;
+
+    template <typename F>
+    explicit Node(F&& action) {
+      using T = std::decay_t<F>;
+      if constexpr (sizeof(T) <= kInlineSize &&
+                    alignof(T) <= alignof(std::max_align_t)) {
+        new (storage) T(std::forward<F>(action));
+        invoke = [](Node* node) {
+          (*std::launder(reinterpret_cast<T*>(node->storage)))();
+        };
+        destroy = [](Node* node) {
+          std::launder(reinterpret_cast<T*>(node->storage))->~T();
+        };
+      } else {
+        new (storage) T*(new T(std::forward<F>(action)));
+        invoke = [](Node* node) {
+          (**std::launder(reinterpret_cast<T**>(node->storage)))();
+        };
+        destroy = [](Node* node) {
+          delete *std::launder(reinterpret_cast<T**>(node->storage));
+        };
+      }
+    }
+
+    CRU_DELETE_COPY(Node)
+    CRU_DELETE_MOVE(Node)
+
+    ~Node() {
+      if (destroy) destroy(this);
+    }
+
+    void Invoke() { invoke(this); }
+
+    std::atomic<Node*> next = nullptr;
+    void (*invoke)(Node* node) = nullptr;
+    void (*destroy)(Node* node) = nullptr;
+    alignas(std::max_align_t) std::byte storage[kInlineSize];
+  };
+
+  // Vyukov's intrusive queue. Producers swap head_, the consumer walks from
+  // tail_, and stub_ keeps the list non-empty.
+  Node* Pop() {
+    auto tail = tail_;
+    auto next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) {
+      if (next == nullptr) return nullptr;
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+
+    // A producer swapped head_ but has not linked its node yet.
+    if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+    auto previous = head_.exchange(&stub_, std::memory_order_acq_rel);
+    previous->next.store(&stub_, std::memory_order_release);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+ private:
+  std::atomic<Node*> head_;
+  Node* tail_;
+  Node stub_;
+  std::atomic<Index> size_ = 0;
+};
+}  // namespace cru
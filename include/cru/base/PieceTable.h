@@ -0,0 +1,152 @@
+#pragma once
+#include "Base.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cru {
+/**
+ * Text storage for editing large documents. The text is the concatenation of
+ * pieces, each of which refers to a range of the original text or of an
+ * append-only buffer of inserted text. Pieces are kept in a treap ordered by
+ * position, so insert, erase, and mapping between position and line are
+ * O(log n) in piece count. Positions are UTF-8 code unit indexes.
+ */
+class CRU_BASE_API PieceTable {
+ public:
+  PieceTable();
+  explicit PieceTable(std::string text);
+
+  CRU_DELETE_COPY(PieceTable)
+
+  PieceTable(PieceTable&& other) noexcept;
+  PieceTable& operator=(PieceTable&& other) noexcept;
+
+  ~PieceTable();
+
+ public:
+  Index GetSize() const { return GetLength(root_.get()); }
+  bool IsEmpty() const { return GetSize() == 0; }
+
+  /**
+   * Line count is line feed count plus 1, so an empty text has one line.
+   */
+  Index GetLineCount() const { return GetNewlineCount(root_.get()) + 1; }
+  /**
+   * Position right after the \p line th line feed, or 0 for line 0.
+   */
+  Index GetLineStart(Index line) const;
+  /**
+   * Count of line feeds before \p position.
+   */
+  Index GetLineIndex(Index position) const;
+
+  char At(Index position) const;
+
+  void SetText(std::string text);
+  void Insert(Index position, std::string_view text);
+  void Erase(Index position, Index count);
+  void Replace(Index position, Index count, std::string_view text) {
+    Erase(position, count);
+    Insert(position, text);
+  }
+
+  std::string Substring(Index position, Index count) const;
+  std::string ToString() const { return Substring(0, GetSize()); }
+
+  /**
+   * Call \p f with each contiguous std::string_view of the range in order. No
+   * text is copied.
+   */
+  template <typename F>
+  void ForEachChunk(Index position, Index count, F&& f) const {
+    CheckArgumentRange(position, 0, GetSize(), "position", true);
+    CheckArgumentRange(count, 0, GetSize() - position, "count", true);
+    ForEachChunkImpl(root_.get(), position, position + count, f);
+  }
+
+ private:
+  struct Buffer {
+    std::string text;
+    // Sorted positions of line feeds in text.
+    std::vector<Index> newlines;
+
+    void Append(std::string_view text);
+    Index CountNewlines(Index start, Index length) const;
+  };
+
+  enum BufferKind : unsigned char { kOriginal, kAdd };
+
+  struct Piece {
+    BufferKind buffer;
+    Index start;
+    Index length;
+    Index newline_count;
+  };
+
+  struct Node {
+    Piece piece;
+    std::uint32_t priority;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+    // Sums of the subtree.
+    Index length;
+    Index newline_count;
+  };
+
+  static Index GetLength(const Node* node) { return node ? node->length : 0; }
+  static Index GetNewlineCount(const Node* node) {
+    return node ? node->newline_count : 0;
+  }
+  static void Update(Node* node);
+
+  const Buffer& GetBuffer(BufferKind kind) const {
+    return kind == kOriginal ? original_buffer_ : add_buffer_;
+  }
+
+  Piece MakePiece(BufferKind buffer, Index start, Index length) const;
+  std::unique_ptr<Node> NewNode(const Piece& piece);
+
+  std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> Split(
+      std::unique_ptr<Node> node, Index position);
+  static std::unique_ptr<Node> Merge(std::unique_ptr<Node> left,
+                                     std::unique_ptr<Node> right);
+
+  // Typing appends to the add buffer right after the last inserted text, so
+  // just grow the piece instead of adding one piece per key.
+  bool TryGrowPiece(Node* node, Index position, Index add_start,
+                    const Piece& piece);
+
+  template <typename F>
+  void ForEachChunkImpl(const Node* node, Index begin, Index end,
+                        F& f) const {
+    if (node == nullptr || begin >= end) return;
+    const auto left_length = GetLength(node->left.get());
+    if (begin < left_length) {
+      ForEachChunkImpl(node->left.get(), begin, std::min(end, left_length), f);
+    }
+    const auto piece_end = left_length + node->piece.length;
+    const auto chunk_begin = std::max(begin, left_length);
+    const auto chunk_end = std::min(end, piece_end);
+    if (chunk_begin < chunk_end) {
+      f(std::string_view(GetBuffer(node->piece.buffer).text)
+            .substr(node->piece.start + chunk_begin - left_length,
+                    chunk_end - chunk_begin));
+    }
+    if (end > piece_end) {
+      ForEachChunkImpl(node->right.get(), std::max(begin, piece_end) - piece_end,
+                       end - piece_end, f);
+    }
+  }
+
+ private:
+  Buffer original_buffer_;
+  Buffer add_buffer_;
+  std::unique_ptr<Node> root_;
+  std::uint32_t random_state_ = 2463534242u;
+};
+}  // namespace cru
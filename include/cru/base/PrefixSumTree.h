@@ -0,0 +1,92 @@
+#pragma once
+#include "Base.h"
+
+#include <vector>
+
+namespace cru {
+/**
+ * A Fenwick tree of values, which supports O(log n) update of a value, prefix
+ * sum and finding the index where a prefix sum is reached. Useful for mapping
+ * between item index and position when items have different extents.
+ */
+template <typename T>
+class PrefixSumTree {
+ public:
+  PrefixSumTree() = default;
+  PrefixSumTree(Index count, T value) { Reset(count, value); }
+  explicit PrefixSumTree(std::vector<T> values) { Assign(std::move(values)); }
+
+  Index GetCount() const { return static_cast<Index>(values_.size()); }
+
+  /**
+   * Set count of values and set all of them to \p value. O(n).
+   */
+  void Reset(Index count, T value) { Assign(std::vector<T>(count, value)); }
+
+  /**
+   * Replace all values. O(n).
+   */
+  void Assign(std::vector<T> values) {
+    values_ = std::move(values);
+    const auto count = GetCount();
+    tree_.assign(count + 1, T{});
+    for (Index i = 1; i <= count; i++) {
+      tree_[i] += values_[i - 1];
+      auto parent = i + (i & -i);
+      if (parent <= count) tree_[parent] += tree_[i];
+    }
+  }
+
+  T Get(Index index) const {
+    CheckArgumentRange(index, 0, GetCount(), "index");
+    return values_[index];
+  }
+
+  void Set(Index index, T value) {
+    CheckArgumentRange(index, 0, GetCount(), "index");
+    auto delta = value - values_[index];
+    values_[index] = value;
+    for (auto i = index + 1; i <= GetCount(); i += i & -i) {
+      tree_[i] += delta;
+    }
+  }
+
+  /**
+   * Sum of values in [0, end).
+   */
+  T GetPrefixSum(Index end) const {
+    CheckArgumentRange(end, 0, GetCount(), "end", true);
+    T result{};
+    for (auto i = end; i > 0; i -= i & -i) {
+      result += tree_[i];
+    }
+    return result;
+  }
+
+  T GetTotal() const { return GetPrefixSum(GetCount()); }
+
+  /**
+   * Find the index whose range [prefix sum before it, prefix sum after it)
+   * contains \p sum. Values must be non-negative. Return GetCount() if \p sum
+   * is not less than total.
+   */
+  Index FindIndex(T sum) const {
+    Index position = 0;
+    Index step = 1;
+    while (step * 2 <= GetCount()) step *= 2;
+    for (; step > 0; step /= 2) {
+      auto next = position + step;
+      if (next <= GetCount() && !(sum < tree_[next])) {
+        position = next;
+        sum -= tree_[next];
+      }
+    }
+    return position;
+  }
+
+ private:
+  std::vector<T> values_;
+  // 1-based.
+  std::vector<T> tree_;
+};
+}  // namespace cru
@@ -24,11 +24,20 @@ class CRU_BASE_API TextEncodeException : public Exception {
   using Exception::Exception;
 };
 
+/**
+ * ASCII text is compared directly. ICU case folding is only used from the
+ * first non-ASCII byte.
+ */
 bool CRU_BASE_API CaseInsensitiveEqual(std::string_view left,
                                        std::string_view right);
+
+// Spaces are the same as u_isspace. ICU is only called for non-ASCII bytes.
 std::string CRU_BASE_API TrimBegin(std::string_view str);
 std::string CRU_BASE_API TrimEnd(std::string_view str);
 std::string CRU_BASE_API Trim(std::string_view str);
+std::string_view CRU_BASE_API TrimBeginView(std::string_view str);
+std::string_view CRU_BASE_API TrimEndView(std::string_view str);
+std::string_view CRU_BASE_API TrimView(std::string_view str);
 bool CRU_BASE_API IsSpace(std::string_view str);
 
 CRU_DEFINE_BITMASK(SplitOption) {
@@ -59,6 +68,10 @@ std::string Join(std::string_view sep, const R& range) {
 std::vector<std::string> CRU_BASE_API Split(std::string_view str,
                                             std::string_view sep,
                                             SplitOption options = {});
+// Same as Split but results refer to str.
+std::vector<std::string_view> CRU_BASE_API SplitView(std::string_view str,
+                                                     std::string_view sep,
+                                                     SplitOption options = {});
 
 namespace details {
 template <typename T>
@@ -535,23 +548,86 @@ inline Index Utf16IndexCodePointToCodeUnit(std::wstring_view str,
 }
 #endif
 
+/**
+ * Bulk routines below process 16 or 32 code units at a time with SSE2 or AVX2,
+ * chosen at runtime, and fall back to scalar code on other CPUs.
+ */
+enum class UtfSimdLevel { Scalar, Sse2, Avx2 };
+
+UtfSimdLevel CRU_BASE_API GetUtfSimdLevel();
+/**
+ * Use a lower level than detected, mainly for tests and benchmarks. Levels the
+ * CPU doesn't support are lowered to the detected one.
+ */
+void CRU_BASE_API SetUtfSimdLevel(UtfSimdLevel level);
+
+/**
+ * Strict validation: overlong forms, surrogates and code points over U+10FFFF
+ * are invalid.
+ */
+bool CRU_BASE_API Utf8IsValid(const Utf8CodeUnit* ptr, Index size);
+
+inline bool Utf8IsValid(Utf8StringView str) {
+  return Utf8IsValid(str.data(), str.size());
+}
+
+/**
+ * Count of code points, assuming the text is valid.
+ */
+Index CRU_BASE_API Utf8CountCodePoints(const Utf8CodeUnit* ptr, Index size);
+
+inline Index Utf8CountCodePoints(Utf8StringView str) {
+  return Utf8CountCodePoints(str.data(), str.size());
+}
+
+Index CRU_BASE_API Utf16CountCodePoints(const Utf16CodeUnit* ptr, Index size);
+
+inline Index Utf16CountCodePoints(Utf16StringView str) {
+  return Utf16CountCodePoints(str.data(), str.size());
+}
+
+/**
+ * @throws TextEncodeException if str is not valid UTF-8.
+ */
+std::u16string CRU_BASE_API Utf8ToUtf16(Utf8StringView str);
+
 #ifdef _WIN32
 std::wstring CRU_BASE_API ToUtf16WString(std::string_view str);
 std::string CRU_BASE_API ToUtf8String(std::wstring_view str);
 #endif
 
+/**
+ * ICU iterates the UTF-8 storage directly, so positions need no conversion and
+ * setting or editing text copies nothing but the string itself. ICU finds
+ * boundaries lazily around the queried position, so only text near the
+ * position is examined after an edit.
+ */
 class CRU_BASE_API StringBreakIterator {
  public:
   explicit StringBreakIterator(std::string str = {});
 
+  // Iterators refer to the storage of the string.
+  CRU_DELETE_COPY(StringBreakIterator)
+  CRU_DELETE_MOVE(StringBreakIterator)
+
+  ~StringBreakIterator();
+
   std::string GetText() const { return str_; }
+  std::string_view GetTextView() const { return str_; }
 
   /**
    * Set the text to iterate. This will reset the current position to 0.
    */
   void SetText(std::string str);
 
-  Index GetCurrentPosition() const { return utf8_position_; }
+  /**
+   * Replace \p count code units at \p position with \p text. Current position
+   * is moved to the end of the inserted text. Both ends of the range must be
+   * code point boundaries.
+   */
+  void Replace(Index position, Index count, std::string_view text);
+
+  Index GetCurrentPosition() const { return position_; }
 
   /**
    * position must be a valid code unit position (not in the middle of a code
@@ -567,13 +643,11 @@ class CRU_BASE_API StringBreakIterator {
   Index PreviousLine();
 
  private:
-  void SetCurrentPositionByUtf16(Index position);
+  void ResetIteratorText();
 
  private:
   std::string str_;
-  icu::UnicodeString icu_str_;
-  Index utf8_position_;
-  Index utf16_position_;
+  Index position_;
   std::unique_ptr<icu::BreakIterator> character_break_iterator_;
   std::unique_ptr<icu::BreakIterator> word_break_iterator_;
   std::unique_ptr<icu::BreakIterator> line_break_iterator_;
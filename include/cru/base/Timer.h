@@ -4,59 +4,42 @@
 
 #include <algorithm>
 #include <chrono>
-#include <list>
 #include <mutex>
 #include <optional>
-#include <ranges>
+#include <unordered_map>
+#include <vector>
 
 namespace cru {
+/**
+ * Timers ordered by a binary min-heap of their next trigger. Add, Remove and
+ * popping a fired timer are O(log n) and NextTimeout is O(1). Removed timers
+ * are dropped lazily from the heap, which is compacted once stale entries
+ * outnumber live ones. Ids are never reused. All methods are thread-safe.
+ */
 template <typename D>
 class TimerRegistry : public Object {
  private:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
   struct TimerData {
-    int id;
     D data;
-    std::chrono::steady_clock::time_point created;
-    std::chrono::steady_clock::time_point last_check;
     std::chrono::milliseconds interval;
     bool repeat;
+    TimePoint next_trigger;
+  };
 
-    TimerData(int id, std::chrono::milliseconds interval, bool repeat,
-              std::chrono::steady_clock::time_point created, D data)
-        : id(id),
-          created(created),
-          last_check(created),
-          interval(interval),
-          repeat(repeat),
-          data(std::move(data)) {}
-
-    std::chrono::steady_clock::time_point NextTrigger() const {
-      return interval == std::chrono::milliseconds::zero()
-                 ? last_check
-                 : last_check - (last_check - created) % interval + interval;
-    }
-
-    std::chrono::milliseconds NextTimeout(
-        std::chrono::steady_clock::time_point now) const {
-      auto next_trigger = NextTrigger();
-      return now >= next_trigger
-                 ? std::chrono::milliseconds::zero()
-                 : std::chrono::duration_cast<std::chrono::milliseconds>(
-                       next_trigger - now);
-    }
-
-    bool Update(std::chrono::steady_clock::time_point now) {
-      auto next_trigger = NextTrigger();
-      if (now >= next_trigger) {
-        last_check = next_trigger;
-        return true;
-      } else {
-        last_check = now;
-        return false;
-      }
-    }
+  struct HeapEntry {
+    TimePoint trigger;
+    int id;
   };
 
+  // Reversed for std::push_heap, which builds a max-heap. Timers with the
+  // same trigger fire in the order they are added.
+  static bool FiresLater(const HeapEntry& left, const HeapEntry& right) {
+    return left.trigger != right.trigger ? left.trigger > right.trigger
+                                         : left.id > right.id;
+  }
+
  public:
   struct UpdateResult {
     int id;
@@ -69,8 +52,7 @@ class TimerRegistry : public Object {
   TimerRegistry() : next_id_(1) {}
 
   int Add(D data, std::chrono::milliseconds interval, bool repeat,
-          std::chrono::steady_clock::time_point created =
-              std::chrono::steady_clock::now()) {
+          TimePoint created = std::chrono::steady_clock::now()) {
     if (interval < std::chrono::milliseconds::zero()) {
       throw Exception("Timer interval can't be negative.");
     }
@@ -80,51 +62,109 @@ class TimerRegistry : public Object {
 
     std::unique_lock lock(mutex_);
     auto id = next_id_++;
-    timers_.emplace_back(id, interval, repeat, created, std::move(data));
+    auto trigger = created + interval;
+    timers_.emplace(id, TimerData{std::move(data), interval, repeat, trigger});
+    PushHeap({trigger, id});
     return id;
   }
 
   void Remove(int id) {
     std::unique_lock lock(mutex_);
-    timers_.remove_if([id](const TimerData& timer) { return timer.id == id; });
+    if (timers_.erase(id) == 0) {
+      return;
+    }
+
+    if (heap_.size() > kMinCompactSize && heap_.size() > timers_.size() * 2) {
+      std::erase_if(heap_, [this](const HeapEntry& entry) {
+        return !timers_.contains(entry.id);
+      });
+      std::make_heap(heap_.begin(), heap_.end(), FiresLater);
+    }
   }
 
   /**
    * Returns nullopt if there is no timer.
    */
-  std::optional<std::chrono::milliseconds> NextTimeout(
-      std::chrono::steady_clock::time_point now) {
+  std::optional<std::chrono::milliseconds> NextTimeout(TimePoint now) {
     std::unique_lock lock(mutex_);
 
-    if (timers_.empty()) return std::nullopt;
+    auto top = Top();
+    if (!top) return std::nullopt;
 
-    return std::ranges::min(
-        timers_ | std::views::transform([now](const TimerData& timer) {
-          return timer.NextTimeout(now);
-        }));
+    return now >= top->trigger
+               ? std::chrono::milliseconds::zero()
+               : std::chrono::duration_cast<std::chrono::milliseconds>(
+                     top->trigger - now);
   }
 
-  std::optional<UpdateResult> Update(
-      std::chrono::steady_clock::time_point new_time) {
+  /**
+   * Pop the earliest timer that fires at new_time.
+   */
+  std::optional<UpdateResult> Update(TimePoint new_time) {
     std::unique_lock lock(mutex_);
-    for (auto iter = timers_.begin(); iter != timers_.end(); ++iter) {
-      auto& timer = *iter;
-      if (timer.Update(new_time)) {
-        if (timer.repeat) {
-          return UpdateResult{timer.id, timer.data};
-        } else {
-          UpdateResult result{timer.id, std::move(timer.data)};
-          timers_.erase(iter);  // We will return, so it's safe to erase here.
-          return result;
-        }
-      }
+    return PopFired(new_time);
+  }
+
+  /**
+   * Pop every timer that fires at new_time into results, in trigger order. A
+   * repeat timer behind by several intervals appears once per interval. As
+   * results are collected before any of them runs, callers that let an
+   * action cancel another timer should use Update instead.
+   */
+  void UpdateAll(TimePoint new_time, std::vector<UpdateResult>& results) {
+    std::unique_lock lock(mutex_);
+    while (auto result = PopFired(new_time)) {
+      results.push_back(std::move(*result));
+    }
+  }
+
+ private:
+  constexpr static std::size_t kMinCompactSize = 64;
+
+  void PushHeap(HeapEntry entry) {
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), FiresLater);
+  }
+
+  void PopHeap() {
+    std::pop_heap(heap_.begin(), heap_.end(), FiresLater);
+    heap_.pop_back();
+  }
+
+  /** Drop removed timers on the top and return the live one. */
+  const HeapEntry* Top() {
+    while (!heap_.empty() && !timers_.contains(heap_.front().id)) {
+      PopHeap();
+    }
+    return heap_.empty() ? nullptr : &heap_.front();
+  }
+
+  std::optional<UpdateResult> PopFired(TimePoint new_time) {
+    auto top = Top();
+    if (!top || top->trigger > new_time) {
+      return std::nullopt;
+    }
+
+    auto id = top->id;
+    PopHeap();
+
+    auto iter = timers_.find(id);
+    auto& timer = iter->second;
+    if (timer.repeat) {
+      timer.next_trigger += timer.interval;
+      PushHeap({timer.next_trigger, id});
+      return UpdateResult{id, timer.data};
+    } else {
+      UpdateResult result{id, std::move(timer.data)};
+      timers_.erase(iter);
+      return result;
     }
-    return std::nullopt;
   }
 
  private:
   std::mutex mutex_;
   int next_id_;
-  std::list<TimerData> timers_;
+  std::unordered_map<int, TimerData> timers_;
+  std::vector<HeapEntry> heap_;
 };
 }  // namespace cru
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Stream.h"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace cru::io {
+/**
+ * Read-only stream over a whole file mapped into memory. GetSpan exposes the
+ * content directly so it can be parsed without copying. Where mapping is not
+ * available the file is read into memory once instead.
+ */
+class CRU_BASE_API MappedFileStream : public Stream {
+ public:
+  explicit MappedFileStream(const char* path);
+
+  CRU_DELETE_COPY(MappedFileStream)
+  CRU_DELETE_MOVE(MappedFileStream)
+
+  ~MappedFileStream() override;
+
+ public:
+  /** Valid until the stream is closed. */
+  std::span<const std::byte> GetSpan() const { return {data_, data_ + size_}; }
+  std::string_view GetStringView() const {
+    return {reinterpret_cast<const char*>(data_),
+            static_cast<std::size_t>(size_)};
+  }
+
+ protected:
+  Index DoSeek(Index offset, SeekOrigin origin) override;
+  Index DoGetSize() override { return size_; }
+  Index DoRead(std::byte* buffer, Index offset, Index size) override;
+  void DoClose() override;
+
+ private:
+  void Release();
+
+ private:
+  const std::byte* data_ = nullptr;
+  Index size_ = 0;
+  Index position_ = 0;
+  bool mapped_ = false;
+  std::vector<std::byte> fallback_buffer_;
+};
+}  // namespace cru::io
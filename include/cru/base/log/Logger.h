@@ -2,11 +2,14 @@
 #include "../Base.h"
 #include "../Guard.h"
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <format>
-#include <list>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <string_view>
 #include <thread>
 #include <unordered_set>
 #include <utility>
@@ -15,6 +18,44 @@
 namespace cru::log {
 enum class LogLevel { Debug, Info, Warn, Error };
 
+/**
+ * Logs below this level are compiled out by CruLog* calls, and their arguments
+ * are not evaluated. Define CRU_LOG_MIN_LEVEL as one of Debug, Info, Warn and
+ * Error to change it.
+ */
+#ifdef CRU_LOG_MIN_LEVEL
+constexpr LogLevel kMinLogLevel = LogLevel::CRU_LOG_MIN_LEVEL;
+#else
+constexpr LogLevel kMinLogLevel = LogLevel::Debug;
+#endif
+
+/**
+ * A trie of tags, to check whether any of them is a prefix of a given tag in
+ * time linear to the length of the given tag.
+ */
+class CRU_BASE_API LogTagTrie {
+ public:
+  LogTagTrie();
+
+  bool IsEmpty() const { return tag_count_ == 0; }
+
+  void Add(std::string_view tag);
+  bool MatchPrefix(std::string_view tag) const;
+
+ private:
+  struct Node {
+    // Sorted by char.
+    std::vector<std::pair<char, int>> children;
+    bool is_end = false;
+  };
+
+  int FindChild(int node, char c) const;
+
+ private:
+  std::vector<Node> nodes_;
+  int tag_count_ = 0;
+};
+
 struct CRU_BASE_API LogInfo {
   LogInfo(LogLevel level, std::string tag, std::string message)
       : level(level), tag(std::move(tag)), message(std::move(message)) {}
@@ -35,6 +76,13 @@ struct CRU_BASE_API DefaultLogFormatter : public Object,
 
 struct CRU_BASE_API ILogWriter : virtual Interface {
   virtual void Write(const LogInfo& log_info, std::string log_str) = 0;
+
+  /**
+   * \p log_strs[i] is the formatted \p log_infos[i]. Default implementation
+   * calls Write for each log. Override it if a batch can be written cheaper.
+   */
+  virtual void WriteBatch(std::span<const LogInfo> log_infos,
+                          std::span<const std::string> log_strs);
 };
 
 struct CRU_BASE_API ILogger : virtual Interface {
@@ -50,6 +98,12 @@ struct CRU_BASE_API ILogger : virtual Interface {
   virtual void AddWriter(std::unique_ptr<ILogWriter> source) = 0;
   virtual void RemoveWriter(ILogWriter* source) = 0;
 
+  /**
+   * Whether a log of \p level and \p tag will be written. Check it before
+   * building an expensive log message.
+   */
+  virtual bool IsEnabled(LogLevel level, std::string_view tag) = 0;
+
   virtual void Log(LogInfo log_info) = 0;
 
   void Log(LogLevel level, std::string tag, std::string message) {
@@ -67,11 +121,17 @@ class CRU_BASE_API LoggerConfigurationMixin : public virtual ILogger {
   void AddWriter(std::unique_ptr<ILogWriter> writer) override;
   void RemoveWriter(ILogWriter* writer) override;
 
+  bool IsEnabled(LogLevel level, std::string_view tag) override;
+
  protected:
   struct LoggerConfig {
     std::shared_ptr<ILogFormatter> formatter;
     std::unordered_set<std::string> debug_tags;
+    // Built from debug_tags on every config update.
+    LogTagTrie debug_tag_trie;
     std::vector<std::shared_ptr<ILogWriter>> writers;
+
+    bool IsEnabled(LogLevel level, std::string_view tag) const;
   };
 
   std::shared_ptr<LoggerConfig> GetConfigSnapshot();
@@ -82,11 +142,18 @@ class CRU_BASE_API LoggerConfigurationMixin : public virtual ILogger {
     std::lock_guard lock(config_mutex_);
     std::shared_ptr<LoggerConfig> new_config(new LoggerConfig(*config_));
     updater(new_config.get());
+    new_config->debug_tag_trie = LogTagTrie();
+    for (const auto& tag : new_config->debug_tags) {
+      new_config->debug_tag_trie.Add(tag);
+    }
+    has_debug_tags_ = !new_config->debug_tags.empty();
     config_ = new_config;
   }
 
   std::mutex config_mutex_;
   std::shared_ptr<LoggerConfig> config_;
+  // Most debug logs are dropped, so check it without taking the lock.
+  std::atomic<bool> has_debug_tags_ = false;
 };
 
 class CRU_BASE_API SynchronousLogger : public Object,
@@ -95,25 +162,93 @@ class CRU_BASE_API SynchronousLogger : public Object,
   void Log(LogInfo log_info) override;
 };
 
+enum class AsynchronousLogOverflowPolicy {
+  // Drop new logs when the buffer is full.
+  Drop,
+  // Wait for space when the buffer is full.
+  Block,
+  // When the buffer is full, wait for space for one of every sample interval
+  // logs and drop the others.
+  Sample,
+};
+
+struct AsynchronousLoggerStatistics {
+  std::uint64_t enqueued;
+  std::uint64_t dropped;
+  std::uint64_t flushed;
+};
+
+/**
+ * Logs are put into a bounded lock-free ring buffer by any thread, and written
+ * in batches by a log thread. Each log is formatted once for all writers.
+ */
 class CRU_BASE_API AsynchronousLogger : public Object,
                                         public virtual ILogger,
                                         public LoggerConfigurationMixin {
  public:
-  AsynchronousLogger();
+  constexpr static Index kDefaultCapacity = 4096;
+  constexpr static int kDefaultSampleInterval = 16;
+
+  explicit AsynchronousLogger(
+      Index capacity = kDefaultCapacity,
+      AsynchronousLogOverflowPolicy overflow_policy =
+          AsynchronousLogOverflowPolicy::Block,
+      int sample_interval = kDefaultSampleInterval);
+
+  CRU_DELETE_COPY(AsynchronousLogger)
+  CRU_DELETE_MOVE(AsynchronousLogger)
+
   ~AsynchronousLogger() override;
 
  public:
   void Log(LogInfo log_info) override;
 
+  /**
+   * Wait until all logs enqueued before are written.
+   */
+  void Flush();
+
+  AsynchronousLoggerStatistics GetStatistics() const;
+
  private:
+  struct Slot {
+    // Equals to position when empty, position + 1 when filled.
+    std::atomic<std::uint64_t> sequence;
+    LogInfo log_info{LogLevel::Debug, {}, {}};
+  };
+
+  bool TryEnqueue(LogInfo& log_info);
+  void EnqueueBlocking(LogInfo& log_info);
+  bool TryDequeue(LogInfo& log_info);
+  bool IsQueueEmpty() const;
+
   void LogThreadRun();
 
  private:
+  Index capacity_;
+  AsynchronousLogOverflowPolicy overflow_policy_;
+  int sample_interval_;
+
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::uint64_t> enqueue_position_ = 0;
+  // Only accessed by log thread.
+  std::uint64_t dequeue_position_ = 0;
+
+  std::atomic<std::uint64_t> enqueued_count_ = 0;
+  std::atomic<std::uint64_t> dropped_count_ = 0;
+  std::atomic<std::uint64_t> flushed_count_ = 0;
+  std::atomic<std::uint64_t> overflow_count_ = 0;
+
   std::mutex mutex_;
+  // Log thread waits on it for logs or stop.
   std::condition_variable condition_variable_;
-
-  std::list<LogInfo> log_queue_;
-  bool log_stop_;
+  // Flush waits on it for log thread progress.
+  std::condition_variable flush_condition_variable_;
+  // Blocked producers wait on it for slots freed by log thread.
+  std::condition_variable space_condition_variable_;
+  std::atomic<int> blocked_producer_count_ = 0;
+  std::atomic<bool> log_thread_waiting_ = false;
+  bool log_stop_ = false;
   std::thread log_thread_;
 };
 
@@ -121,13 +256,19 @@ CRU_BASE_API Guard MeasureTimeAndLog(std::string_view tag,
                                      std::string_view name);
 }  // namespace cru::log
 
-#define CRU_DEFINE_LOG_FUNC(level)                                             \
-  template <typename... Args>                                                  \
-  void CruLog##level(std::string tag, std::format_string<Args...> message_fmt, \
-                     Args&&... args) {                                         \
-    cru::log::ILogger::GetInstance()->Log(                                     \
-        cru::log::LogLevel::level, std::move(tag),                             \
-        std::format(message_fmt, std::forward<Args>(args)...));                \
+// Message is only formatted if the log is enabled.
+#define CRU_DEFINE_LOG_FUNC(level)                                         \
+  template <typename... Args>                                              \
+  void CruLog##level(std::string_view tag,                                 \
+                     std::format_string<Args...> message_fmt,              \
+                     Args&&... args) {                                     \
+    if constexpr (cru::log::LogLevel::level >= cru::log::kMinLogLevel) {   \
+      auto logger = cru::log::ILogger::GetInstance();                      \
+      if (logger->IsEnabled(cru::log::LogLevel::level, tag)) {             \
+        logger->Log(cru::log::LogLevel::level, std::string(tag),           \
+                    std::format(message_fmt, std::forward<Args>(args)...)); \
+      }                                                                    \
+    }                                                                      \
   }
 
 CRU_DEFINE_LOG_FUNC(Debug)
@@ -136,3 +277,17 @@ CRU_DEFINE_LOG_FUNC(Warn)
 CRU_DEFINE_LOG_FUNC(Error)
 
 #undef CRU_DEFINE_LOG_FUNC
+
+// Calls are wrapped so that logs below kMinLogLevel don't evaluate arguments.
+// The name inside is not expanded again, so it calls the function above.
+#define CRU_LOG_CALL(level, ...)                                          \
+  do {                                                                   \
+    if constexpr (cru::log::LogLevel::level >= cru::log::kMinLogLevel) { \
+      CruLog##level(__VA_ARGS__);                                        \
+    }                                                                    \
+  } while (false)
+
+#define CruLogDebug(...) CRU_LOG_CALL(Debug, __VA_ARGS__)
+#define CruLogInfo(...) CRU_LOG_CALL(Info, __VA_ARGS__)
+#define CruLogWarn(...) CRU_LOG_CALL(Warn, __VA_ARGS__)
+#define CruLogError(...) CRU_LOG_CALL(Error, __VA_ARGS__)
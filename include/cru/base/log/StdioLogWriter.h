@@ -9,5 +9,8 @@ class StdioLogWriter : public Object, public virtual ILogWriter {
 
  public:
   void Write(const LogInfo& log_info, std::string log_str) override;
+  // Flush once per batch instead of once per log.
+  void WriteBatch(std::span<const LogInfo> log_infos,
+                  std::span<const std::string> log_strs) override;
 };
 }  // namespace cru::log
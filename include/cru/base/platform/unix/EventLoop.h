@@ -4,6 +4,7 @@
 #error "This file can only be included on unix."
 #endif
 
+#include "../../ActionQueue.h"
 #include "../../Base.h"
 #include "../../Event.h"
 #include "../../Timer.h"
@@ -12,9 +13,13 @@
 #include <poll.h>
 #include <unistd.h>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace cru::platform::unix {
 class UnixTimerFile : public Object {
@@ -45,6 +50,13 @@ class UnixTimerFile : public Object {
   std::thread thread_;
 };
 
+struct UnixEventLoopRoundInfo {
+  /** Queued actions run in this round. */
+  Index action_count;
+  /** Actions still queued by other threads when the round ends. */
+  Index queued_action_count;
+};
+
 class UnixEventLoop : public Object {
  private:
   constexpr static auto kLogTag = "cru::platform::unix::UnixEventLoop";
@@ -54,13 +66,45 @@ class UnixEventLoop : public Object {
   using PollRevents = decltype(std::declval<pollfd>().revents);
   using PollHandler = std::function<void(PollEvents revent)>;
 
-  UnixEventLoop();
+  enum class Backend {
+    /** Portable ::poll over every registered fd. */
+    Poll,
+    /** Linux only. epoll, with an eventfd to wake and a timerfd for timers. */
+    Epoll,
+  };
+
+#ifdef __linux__
+  constexpr static auto kDefaultBackend = Backend::Epoll;
+#else
+  constexpr static auto kDefaultBackend = Backend::Poll;
+#endif
+
+  explicit UnixEventLoop(Backend backend = kDefaultBackend);
+
+  CRU_DELETE_COPY(UnixEventLoop)
+  CRU_DELETE_MOVE(UnixEventLoop)
+
+  ~UnixEventLoop() override;
+
+  Backend GetBackend() const { return backend_; }
 
   /**
-   * Thread-safe.
+   * Cap of queued actions run in one round, so a flood of actions from other
+   * threads can't delay timers and fds for long. The rest run in next rounds.
+   */
+  Index GetMaxActionsPerRound() const { return max_actions_per_round_; }
+  void SetMaxActionsPerRound(Index count);
+
+  /**
+   * Thread-safe. Actions from other threads are batched, and the loop is only
+   * woken by the one that finds the queue empty.
    */
   void QueueAction(std::function<void()> action);
 
+  /**
+   * Each round runs queued actions and expired timers, then waits and
+   * dispatches every ready fd.
+   */
   int Run();
 
   /**
@@ -103,25 +147,57 @@ class UnixEventLoop : public Object {
     return this->SetTimer(std::move(action), std::move(interval), true);
   }
 
+  /**
+   * Register or update the handler of fd. Both are O(1), and it is safe to
+   * call them from a handler.
+   */
   void SetPoll(int fd, PollEvents events, PollHandler action);
   void RemovePoll(int fd);
 
-  CRU_DEFINE_EVENT(AfterEachRound, std::nullptr_t)
+  CRU_DEFINE_EVENT(AfterEachRound, const UnixEventLoopRoundInfo&)
 
  private:
-  bool CheckPoll();
-  bool CheckActionPipe();
+  struct PollEntry {
+    PollEvents events;
+    // Shared so that a handler can remove itself while running.
+    std::shared_ptr<PollHandler> handler;
+    // Index in polls_. Only used by poll backend.
+    Index index;
+  };
+
+  bool IsInLoopThread() const;
+  void Wake();
+  void DrainWakeFd();
+
+  void RunQueuedActions();
+  void RunTimers();
+  void Wait(std::optional<std::chrono::milliseconds> timeout);
+  void DispatchReadyPolls();
+
+  void ArmTimerFd(std::optional<std::chrono::milliseconds> timeout);
 
  private:
+  Backend backend_;
   std::optional<std::thread::id> running_thread_;
 
+  std::unordered_map<int, PollEntry> poll_entries_;
+  // Wake fd comes first, then every fd in poll_entries_.
   std::vector<pollfd> polls_;
-  std::vector<PollHandler> poll_actions_;
+  std::vector<std::pair<int, PollRevents>> ready_polls_;
+
+  UnixFileDescriptor epoll_fd_;
+  UnixFileDescriptor timer_fd_;
+  bool timer_fd_armed_ = false;
+
+  // The same eventfd on linux, a non-blocking pipe elsewhere.
+  UnixFileDescriptor wake_read_fd_;
+  UnixFileDescriptor wake_write_fd_;
 
   TimerRegistry<std::function<void()>> timer_registry_;
 
-  UnixFileDescriptor action_pipe_read_end_;
-  UnixFileDescriptor action_pipe_write_end_;
+  MpscActionQueue queued_actions_;
+  Index max_actions_per_round_ = 1024;
+  UnixEventLoopRoundInfo round_info_{};
 
   std::optional<int> exit_code_;
 };
@@ -4,6 +4,8 @@
 #include "TomlDocument.h"
 
 #include <optional>
+#include <span>
+#include <string_view>
 
 namespace cru::toml {
 // A very simple and tolerant TOML parser.
@@ -15,6 +17,8 @@ class CRU_BASE_API TomlParsingException : public Exception {
 class CRU_BASE_API TomlParser : public Object {
  public:
   explicit TomlParser(std::string input);
+  /** Parse utf-8 bytes in place. The caller keeps input alive while parsing. */
+  explicit TomlParser(std::span<const std::byte> input);
   ~TomlParser();
 
  public:
@@ -25,7 +29,8 @@ class CRU_BASE_API TomlParser : public Object {
   void DoParse(TomlDocument& document);
 
  private:
-  std::string input_;
+  std::string owned_input_;
+  std::string_view input_;
 
   std::optional<TomlDocument> cache_;
 };
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../Base.h"
+#include "XmlNode.h"
+#include "XmlParser.h"
+
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace cru::xml {
+class XmlDocument;
+
+/**
+ * A read-only node of XmlDocument. Strings are slices of the document source
+ * and nodes are owned by the document, so none of them outlive it.
+ */
+class CRU_BASE_API XmlNodeView {
+  friend XmlDocument;
+
+ public:
+  using Type = XmlNode::Type;
+
+  XmlNodeView(const XmlNodeView&) = delete;
+  XmlNodeView& operator=(const XmlNodeView&) = delete;
+
+  Type GetType() const { return type_; }
+  bool IsTextNode() const { return type_ == Type::Text; }
+  bool IsElementNode() const { return type_ == Type::Element; }
+  bool IsCommentNode() const { return type_ == Type::Comment; }
+
+  const XmlNodeView* GetParent() const { return parent_; }
+
+  /** Tag of element node. */
+  std::string_view GetTag() const { return value_; }
+  /** Text of text or comment node. */
+  std::string_view GetText() const { return value_; }
+  bool HasTag(std::string_view tag, bool case_sensitive = false) const;
+
+  std::span<const XmlAttributeView> GetAttributes() const {
+    return attributes_;
+  }
+  std::optional<std::string_view> GetOptionalAttributeValue(
+      std::string_view name) const;
+  std::optional<std::string_view> GetOptionalAttributeValueCaseInsensitive(
+      std::string_view name) const;
+
+  Index GetChildCount() const { return child_count_; }
+  const XmlNodeView* GetFirstChild() const { return first_child_; }
+  const XmlNodeView* GetNextSibling() const { return next_sibling_; }
+  const XmlNodeView* GetFirstChildElement() const;
+  Index GetChildElementCount() const;
+
+  /** Copy the subtree into a new owning XmlNode tree. */
+  XmlNode* ToXmlNode() const;
+
+ private:
+  XmlNodeView(Type type, std::string_view value) : type_(type), value_(value) {}
+
+ private:
+  Type type_;
+  std::string_view value_;
+  std::span<const XmlAttributeView> attributes_;
+  XmlNodeView* parent_ = nullptr;
+  XmlNodeView* first_child_ = nullptr;
+  XmlNodeView* last_child_ = nullptr;
+  XmlNodeView* next_sibling_ = nullptr;
+  Index child_count_ = 0;
+};
+
+/**
+ * Parses xml into XmlNodeView tree without copying any string. The document
+ * keeps an owned source alive and allocates every node and attribute list
+ * from a single arena, which is released at once when the document is
+ * destroyed.
+ */
+class CRU_BASE_API XmlDocument : private IXmlSaxHandler {
+ public:
+  /** @throws XmlParsingException if xml is malformed. */
+  explicit XmlDocument(std::string xml);
+  /**
+   * Parse utf-8 bytes without taking a copy, e.g. a mapped file. The caller
+   * keeps xml alive as long as the document.
+   * @throws XmlParsingException if xml is malformed.
+   */
+  explicit XmlDocument(std::span<const std::byte> xml);
+
+  ~XmlDocument() override;
+
+  std::string_view GetSource() const { return source_; }
+  /** The only top-level node, which may be a comment. */
+  const XmlNodeView* GetRoot() const { return root_; }
+
+ private:
+  void OnStartElement(std::string_view tag,
+                      std::span<const XmlAttributeView> attributes) override;
+  void OnEndElement(std::string_view tag) override;
+  void OnText(std::string_view text) override;
+  void OnComment(std::string_view text) override;
+
+  void Parse();
+  XmlNodeView* AddNode(XmlNode::Type type, std::string_view value);
+
+ private:
+  std::string owned_source_;
+  std::string_view source_;
+  std::pmr::monotonic_buffer_resource arena_;
+  XmlNodeView* root_ = nullptr;
+  // Only used while parsing.
+  XmlNodeView* current_ = nullptr;
+};
+}  // namespace cru::xml
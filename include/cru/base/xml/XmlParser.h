@@ -3,41 +3,61 @@
 #include "../Base.h"
 #include "XmlNode.h"
 
+#include <span>
+#include <string_view>
+
 namespace cru::xml {
 class CRU_BASE_API XmlParsingException : public Exception {
  public:
   using Exception::Exception;
 };
 
+struct XmlAttributeView {
+  std::string_view name;
+  std::string_view value;
+};
+
+/**
+ * Receives events of a single pass over xml. All views refer to the source
+ * passed to ParseXml and are only valid as long as it is.
+ */
+struct CRU_BASE_API IXmlSaxHandler : virtual Interface {
+  virtual void OnStartElement(std::string_view tag,
+                              std::span<const XmlAttributeView> attributes) {
+    CRU_UNUSED(tag)
+    CRU_UNUSED(attributes)
+  }
+  virtual void OnEndElement(std::string_view tag) { CRU_UNUSED(tag) }
+  virtual void OnText(std::string_view text) { CRU_UNUSED(text) }
+  virtual void OnComment(std::string_view text) { CRU_UNUSED(text) }
+};
+
+/**
+ * Scan xml once and report to handler without building any tree. Self-closing
+ * element reports both start and end.
+ * @throws XmlParsingException if xml is malformed.
+ */
+void CRU_BASE_API ParseXml(std::string_view xml, IXmlSaxHandler* handler);
+
 class CRU_BASE_API XmlParser {
  public:
   explicit XmlParser(std::string xml);
+  /** Parse utf-8 bytes in place. The caller keeps xml alive while parsing. */
+  explicit XmlParser(std::span<const std::byte> xml);
 
   CRU_DELETE_COPY(XmlParser)
   CRU_DELETE_MOVE(XmlParser)
 
   ~XmlParser();
 
+  /**
+   * Build a new tree owned by the caller. The root is the only top-level
+   * node, which may be a comment.
+   */
   XmlElementNode* Parse();
 
  private:
-  XmlElementNode* DoParse();
-
-  char16_t Read1();
-  std::string ReadWithoutAdvance(int count = 1);
-  void ReadSpacesAndDiscard();
-  std::string ReadSpaces();
-  std::string ReadIdenitifier();
-  std::string ReadAttributeString();
-
- private:
-  std::string xml_;
-
-  XmlElementNode* cache_ = nullptr;
-
-  // Consider the while file enclosed by a single tag called $root.
-  XmlElementNode* pseudo_root_node_ = new XmlElementNode("$root");
-  XmlElementNode* current_ = pseudo_root_node_;
-  int current_position_ = 0;
+  std::string owned_xml_;
+  std::string_view xml_;
 };
 }  // namespace cru::xml
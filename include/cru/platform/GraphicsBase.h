@@ -2,6 +2,8 @@
 #include <cru/base/Range.h>
 #include <cru/base/StringUtil.h>
 
+#include <algorithm>
+#include <cmath>
 #include <format>
 #include <limits>
 
@@ -259,6 +261,27 @@ struct Rect final {
                         std::max(GetBottom(), other.GetBottom()));
   }
 
+  /**
+   * Returns an empty rect (all zero) if two rects do not intersect.
+   */
+  constexpr Rect Intersect(const Rect& other) const {
+    if (!IsIntersect(other)) {
+      return {};
+    }
+    return FromVertices(std::max(left, other.left), std::max(top, other.top),
+                        std::min(GetRight(), other.GetRight()),
+                        std::min(GetBottom(), other.GetBottom()));
+  }
+
+  /**
+   * Expand the rect to the smallest rect with integer vertices that contains
+   * it. Useful for clipping to whole pixels.
+   */
+  Rect RoundOut() const {
+    return FromVertices(std::floor(left), std::floor(top),
+                        std::ceil(GetRight()), std::ceil(GetBottom()));
+  }
+
   std::string ToString() const {
     return std::format("Rect(left: {}, top: {}, width: {}, height: {})", left,
                        top, width, height);
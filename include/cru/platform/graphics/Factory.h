@@ -7,7 +7,17 @@
 #include "ImageFactory.h"
 #include "TextLayout.h"
 
+#include <string_view>
+
 namespace cru::platform::graphics {
+struct TextMeasure {
+  // Width when wrapping at every opportunity, i.e. width of the widest word.
+  float min_content_width;
+  // Size without wrapping.
+  float max_content_width;
+  float max_content_height;
+};
+
 // Entry point of the graphics module.
 struct CRU_PLATFORM_GRAPHICS_API IGraphicsFactory : virtual IPlatformResource {
   virtual std::unique_ptr<ISolidColorBrush> CreateSolidColorBrush() = 0;
@@ -20,6 +30,19 @@ struct CRU_PLATFORM_GRAPHICS_API IGraphicsFactory : virtual IPlatformResource {
   virtual std::unique_ptr<ITextLayout> CreateTextLayout(
       std::shared_ptr<IFont> font, std::string text) = 0;
 
+  /**
+   * Measure text without keeping a text layout. Default implementation lays
+   * out a temporary text layout. Backends may compute it from cached shaping.
+   */
+  virtual TextMeasure MeasureText(std::shared_ptr<IFont> font,
+                                  std::string_view text);
+  /**
+   * Size of text wrapped at \p max_width, same as text bounds of a text layout
+   * with that max width.
+   */
+  virtual Size MeasureTextForWidth(std::shared_ptr<IFont> font,
+                                   std::string_view text, float max_width);
+
   std::unique_ptr<ISolidColorBrush> CreateSolidColorBrush(const Color& color) {
     std::unique_ptr<ISolidColorBrush> brush = CreateSolidColorBrush();
     brush->SetColor(color);
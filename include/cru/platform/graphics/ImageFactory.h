@@ -3,6 +3,8 @@
 
 #include <cru/base/io/Stream.h>
 
+#include <span>
+
 namespace cru::platform::graphics {
 enum class ImageFormat { Jpeg, Png, Gif };
 
@@ -10,6 +12,14 @@ struct CRU_PLATFORM_GRAPHICS_API IImageFactory
     : public virtual IGraphicsResource {
   virtual std::unique_ptr<IImage> DecodeFromStream(io::Stream* stream) = 0;
 
+  /**
+   * \brief Decode an image from encoded bytes in memory, e.g. a mapped file.
+   * \remarks Default implementation wraps data in a MemoryStream. Override it
+   * to read data directly.
+   */
+  virtual std::unique_ptr<IImage> DecodeFromMemory(
+      std::span<const std::byte> data);
+
   /**
    *  \brief Encode an image to a stream.
    *  \param image The image to encode.
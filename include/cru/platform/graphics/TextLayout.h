@@ -1,15 +1,46 @@
 #pragma once
 #include "Base.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace cru::platform::graphics {
+enum class FontWeight { Normal, Bold };
+enum class FontStyle { Normal, Italic };
+
+/**
+ * Style of a range of text. Null foreground uses the brush the text is drawn
+ * with. Null background draws no background.
+ */
+struct TextAttribute {
+  TextRange range;
+  std::shared_ptr<IBrush> foreground;
+  std::shared_ptr<IBrush> background;
+  FontWeight weight = FontWeight::Normal;
+  FontStyle style = FontStyle::Normal;
+  bool underline = false;
+};
+
 // Requirement:
 // All text must be left-top aligned.
 struct CRU_PLATFORM_GRAPHICS_API ITextLayout : virtual IGraphicsResource {
   virtual std::string GetText() = 0;
+  // Valid until text changes. Use it to read text without copying.
+  virtual std::string_view GetTextView() = 0;
   virtual void SetText(std::string new_text) = 0;
+  /**
+   * Replace \p count bytes at \p position with \p text. Default
+   * implementation copies the whole text. Backends that relayout only changed
+   * paragraphs should override it, so an edit costs the edited paragraphs.
+   */
+  virtual void ReplaceText(Index position, Index count,
+                           std::string_view text) {
+    auto new_text = GetText();
+    new_text.replace(position, count, text);
+    SetText(std::move(new_text));
+  }
 
   virtual std::shared_ptr<IFont> GetFont() = 0;
   virtual void SetFont(std::shared_ptr<IFont> font) = 0;
@@ -20,6 +51,16 @@ struct CRU_PLATFORM_GRAPHICS_API ITextLayout : virtual IGraphicsResource {
   virtual bool IsEditMode() = 0;
   virtual void SetEditMode(bool enable) = 0;
 
+  /**
+   * Ranges must not overlap. They move with text when it changes, and new text
+   * only joins a range around both of its sides. Changing only brushes never
+   * reshapes text, and other attributes only reshape paragraphs whose
+   * attributes change. Default implementation ignores attributes.
+   */
+  virtual void SetAttributes(std::vector<TextAttribute> attributes) {
+    CRU_UNUSED(attributes)
+  }
+
   /**
    * @brief Get the line index from the character index.
    * @param char_index The character index in code units.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base.h"
+#include "PangoTextLayoutCache.h"
 
 #include <cru/platform/graphics/Factory.h>
 
@@ -21,6 +22,9 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API CairoGraphicsFactory
   cairo_surface_t* GetDefaultCairoSurface() { return default_cairo_surface_; }
   cairo_t* GetDefaultCairo() { return default_cairo_; }
   PangoContext* GetDefaultPangoContext() { return default_pango_context_; }
+  PangoTextLayoutCache* GetTextLayoutCache() {
+    return text_layout_cache_.get();
+  }
 
  public:
   std::unique_ptr<ISolidColorBrush> CreateSolidColorBrush() override;
@@ -33,12 +37,19 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API CairoGraphicsFactory
   std::unique_ptr<ITextLayout> CreateTextLayout(std::shared_ptr<IFont> font,
                                                 std::string text) override;
 
+  // Computed from shaped paragraphs in text layout cache.
+  TextMeasure MeasureText(std::shared_ptr<IFont> font,
+                          std::string_view text) override;
+  Size MeasureTextForWidth(std::shared_ptr<IFont> font, std::string_view text,
+                           float max_width) override;
+
   IImageFactory* GetImageFactory() override;
 
  private:
   cairo_surface_t* default_cairo_surface_;
   cairo_t* default_cairo_;
   PangoContext* default_pango_context_;
+  std::unique_ptr<PangoTextLayoutCache> text_layout_cache_;
 
   std::unique_ptr<CairoImageFactory> image_factory_;
 };
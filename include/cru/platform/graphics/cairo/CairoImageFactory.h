@@ -11,6 +11,8 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API CairoImageFactory : public CairoResource,
 
  public:
   std::unique_ptr<IImage> DecodeFromStream(io::Stream* stream) override;
+  std::unique_ptr<IImage> DecodeFromMemory(
+      std::span<const std::byte> data) override;
   void EncodeToStream(IImage* image, io::Stream* stream, ImageFormat format,
                       float quality) override;
 
@@ -1,12 +1,28 @@
 #pragma once
 #include "Base.h"
 #include "PangoFont.h"
+#include "PangoTextLayoutCache.h"
 
+#include <cru/base/PrefixSumTree.h>
 #include <cru/platform/graphics/TextLayout.h>
 
 #include <pango/pango.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace cru::platform::graphics::cairo {
+/**
+ * Text is split into paragraphs at line feeds and each paragraph has its own
+ * shaped text from the PangoTextLayoutCache of the factory. Setting text only
+ * reshapes paragraphs that changed. Paragraph heights and line counts are kept
+ * in prefix sum trees, so mapping between position, line and y is O(log n) in
+ * paragraph count.
+ *
+ * Weight, style and underline of attributes are shaped into paragraphs. Brushes
+ * of attributes are applied when drawing by clipping to their ranges, so
+ * changing them never reshapes text.
+ */
 class CRU_PLATFORM_GRAPHICS_CAIRO_API PangoTextLayout
     : public CairoResource,
       public virtual ITextLayout {
@@ -17,7 +33,9 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API PangoTextLayout
 
  public:
   std::string GetText() override;
+  std::string_view GetTextView() override;
   void SetText(std::string new_text) override;
+  void ReplaceText(Index position, Index count, std::string_view text) override;
 
   std::shared_ptr<IFont> GetFont() override;
   void SetFont(std::shared_ptr<IFont> font) override;
@@ -28,6 +46,8 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API PangoTextLayout
   bool IsEditMode() override;
   void SetEditMode(bool enable) override;
 
+  void SetAttributes(std::vector<TextAttribute> attributes) override;
+
   Index GetLineIndexFromCharIndex(Index char_index) override;
   Index GetLineCount() override;
   float GetLineHeight(Index line_index) override;
@@ -38,15 +58,78 @@ class CRU_PLATFORM_GRAPHICS_CAIRO_API PangoTextLayout
   Rect TextSinglePoint(Index position, bool trailing) override;
   TextHitTestResult HitTest(const Point& point) override;
 
-  PangoLayout* GetPangoLayout() { return pango_layout_; }
+  /**
+   * Draw paragraphs intersecting the clip of \p cairo with current source.
+   */
+  void Draw(cairo_t* cairo, const Point& offset);
+
+ private:
+  struct Paragraph {
+    // Byte offset in text. Line feed after the paragraph is not included.
+    Index start;
+    Index length;
+    // Length of shaped text, which excludes carriage return before line feed.
+    Index text_length;
+    bool dirty;
+    // Relative to paragraph start.
+    std::vector<PangoShapingAttribute> attributes;
+    // Null before first shaped.
+    std::shared_ptr<const PangoShapedText> shaped;
+  };
+
+  // Index of the paragraph containing position. Line feed belongs to the
+  // paragraph before it.
+  Index GetParagraphIndex(Index position);
+  Index GetParagraphIndexAtY(float y);
+  float GetParagraphTop(Index paragraph_index) {
+    return paragraph_heights_.GetPrefixSum(paragraph_index);
+  }
+  PangoLayout* GetParagraphLayout(Index paragraph_index) {
+    return paragraphs_[paragraph_index].shaped->layout;
+  }
+  // Index in shaped text of the paragraph. Line break maps to end of it.
+  int GetParagraphTextIndex(Index paragraph_index, Index position) {
+    const auto& paragraph = paragraphs_[paragraph_index];
+    return static_cast<int>(
+        std::min(position - paragraph.start, paragraph.text_length));
+  }
+  // Replace paragraphs [first, last] with paragraphs split from new text in
+  // [start, end).
+  void ReplaceParagraphs(Index first, Index last, Index start, Index end);
+  void InvalidateAllParagraphs();
+  // Update shaping attributes of paragraphs [first, last] from attributes and
+  // mark changed ones dirty.
+  void UpdateParagraphAttributes(Index first, Index last);
+  void MarkParagraphDirty(Index paragraph_index);
+  // Move attributes for text [position, position + count) replaced by
+  // new_count bytes.
+  void MoveAttributes(Index position, Index count, Index new_count);
+  // Index of the first attribute ending after position.
+  Index GetAttributeIndex(Index position);
+  void DrawParagraph(cairo_t* cairo, Index paragraph_index, const Point& offset,
+                     double clip_left, double clip_right);
+  // Get shaped text of dirty paragraphs and update prefix sums.
+  void EnsureLayout();
 
  private:
   std::string text_;
 
   bool edit_mode_ = false;
+  float max_width_ = -1.f;
 
   std::shared_ptr<PangoFont> font_;
 
-  PangoLayout* pango_layout_;
+  // Normalized and sorted by start.
+  std::vector<TextAttribute> attributes_;
+
+  PangoTextLayoutCache* cache_;
+  Index cache_generation_;
+  std::vector<Paragraph> paragraphs_;
+  std::vector<Index> dirty_paragraphs_;
+  // Rebuild prefix sums from all paragraphs instead of updating dirty ones.
+  bool prefix_sums_stale_ = true;
+  PrefixSumTree<float> paragraph_heights_;
+  PrefixSumTree<Index> paragraph_line_counts_;
+  float max_paragraph_width_ = 0.f;
 };
 }  // namespace cru::platform::graphics::cairo
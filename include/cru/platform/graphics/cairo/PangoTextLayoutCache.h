@@ -0,0 +1,142 @@
+#pragma once
+#include "Base.h"
+
+#include <cru/platform/graphics/TextLayout.h>
+
+#include <pango/pango.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cru::platform::graphics::cairo {
+class PangoFont;
+
+/**
+ * Shaped text shared by all users of the same text, font and width. Layout
+ * must not be modified.
+ */
+struct CRU_PLATFORM_GRAPHICS_CAIRO_API PangoShapedText {
+  // Take ownership of layout and measure it.
+  explicit PangoShapedText(PangoLayout* layout);
+
+  CRU_DELETE_COPY(PangoShapedText)
+  CRU_DELETE_MOVE(PangoShapedText)
+
+  ~PangoShapedText();
+
+  PangoLayout* layout;
+  Index line_count;
+  float width;
+  float height;
+};
+
+/**
+ * Attributes changing glyphs of a byte range [start, end) in the shaped text.
+ * Brushes are not here because they are applied when drawing.
+ */
+struct PangoShapingAttribute {
+  int start;
+  int end;
+  FontWeight weight;
+  FontStyle style;
+  bool underline;
+
+  bool operator==(const PangoShapingAttribute& other) const = default;
+};
+
+struct PangoTextLayoutCacheStatistics {
+  Index hit_count;
+  Index miss_count;
+  Index entry_count;
+  std::size_t byte_size;
+};
+
+/**
+ * LRU cache of shaped text keyed by text, font, max width and shaping
+ * attributes. Labels and rows
+ * with the same text share one shaped layout instead of shaping their own.
+ * Byte size of an entry is estimated from its text size.
+ */
+class CRU_PLATFORM_GRAPHICS_CAIRO_API PangoTextLayoutCache {
+ public:
+  constexpr static std::size_t kDefaultMaxByteSize = 8 * 1024 * 1024;
+
+  // All layouts are created in context, which is shared.
+  explicit PangoTextLayoutCache(PangoContext* context,
+                                std::size_t max_byte_size = kDefaultMaxByteSize);
+
+  CRU_DELETE_COPY(PangoTextLayoutCache)
+  CRU_DELETE_MOVE(PangoTextLayoutCache)
+
+  ~PangoTextLayoutCache();
+
+ public:
+  std::shared_ptr<const PangoShapedText> Get(
+      std::string_view text, PangoFont* font, float max_width,
+      std::span<const PangoShapingAttribute> attributes = {});
+
+  std::size_t GetMaxByteSize() const { return max_byte_size_; }
+  void SetMaxByteSize(std::size_t max_byte_size);
+
+  /**
+   * Drop all entries and increase generation. Call it when fonts change.
+   * Users should get their shaped text again when generation changes.
+   */
+  void Clear();
+  Index GetGeneration() const { return generation_; }
+
+  /**
+   * Update the shared context for \p cairo. If font options or transform
+   * changes shaping, all entries are cleared.
+   */
+  void UpdateContext(cairo_t* cairo);
+
+  PangoTextLayoutCacheStatistics GetStatistics() const;
+
+ private:
+  struct Key {
+    std::string_view text;
+    std::string_view font_family;
+    float font_size;
+    int width;
+    std::span<const PangoShapingAttribute> attributes;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::string text;
+    std::string font_family;
+    std::vector<PangoShapingAttribute> attributes;
+    Key key;
+    std::shared_ptr<const PangoShapedText> value;
+    std::size_t byte_size;
+  };
+
+  void Evict(std::size_t max_byte_size);
+
+ private:
+  PangoContext* context_;
+  std::size_t max_byte_size_;
+
+  // Most recently used first.
+  std::list<Entry> entries_;
+  // Keys refer to strings and attributes in entries, whose nodes never move.
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> map_;
+  std::size_t byte_size_ = 0;
+
+  Index generation_ = 0;
+  Index hit_count_ = 0;
+  Index miss_count_ = 0;
+};
+}  // namespace cru::platform::graphics::cairo
@@ -26,6 +26,7 @@ class CRU_WIN_GRAPHICS_DIRECT_API DWriteTextLayout
 
  public:
   std::string GetText() override;
+  std::string_view GetTextView() override;
   void SetText(std::string new_text) override;
 
   std::shared_ptr<IFont> GetFont() override;
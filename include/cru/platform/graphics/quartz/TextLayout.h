@@ -16,6 +16,7 @@ class OsxCTTextLayout : public OsxQuartzResource, public virtual ITextLayout {
 
  public:
   std::string GetText() override { return text_; }
+  std::string_view GetTextView() override { return text_; }
   void SetText(std::string new_text) override;
 
   std::shared_ptr<IFont> GetFont() override { return font_; }
@@ -0,0 +1,76 @@
+#pragma once
+#include "Base.h"
+#include "UiApplication.h"
+
+#include <cru/base/Event.h>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace cru::platform::gui {
+struct FrameLateEventArgs {
+  // How much later than scheduled the frame began.
+  std::chrono::steady_clock::duration late;
+  // How long handlers of the frame took.
+  std::chrono::steady_clock::duration duration;
+  // Count of whole frame intervals missed because of the two above.
+  int dropped_frame_count;
+};
+
+/**
+ * Paces the frames of a window. All requests arriving before the next frame
+ * begins are coalesced into that one frame, and frames never begin more often
+ * than the target rate.
+ */
+class CRU_PLATFORM_GUI_API FrameClock : public Object {
+ private:
+  constexpr static auto kLogTag = "cru::platform::gui::FrameClock";
+
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  constexpr static double kDefaultFrameRate = 60;
+
+  explicit FrameClock(double frame_rate = kDefaultFrameRate);
+
+  CRU_DELETE_COPY(FrameClock)
+  CRU_DELETE_MOVE(FrameClock)
+
+  ~FrameClock() override;
+
+  /**
+   * 0 means no throttling, i.e. a requested frame begins on next immediate.
+   * Use it when present already blocks on vsync.
+   */
+  double GetFrameRate() const { return frame_rate_; }
+  void SetFrameRate(double frame_rate);
+  Clock::duration GetFrameInterval() const;
+
+  bool IsFramePending() const { return frame_canceler_.IsValid(); }
+  void RequestFrame();
+  void CancelFrame();
+
+  /**
+   * Time the next frame should begin if it is requested at \p now.
+   */
+  static Clock::time_point CalculateNextFrameTime(
+      Clock::time_point now, std::optional<Clock::time_point> last_frame_time,
+      Clock::duration interval) {
+    if (!last_frame_time) return now;
+    return std::max(now, *last_frame_time + interval);
+  }
+
+  CRU_DEFINE_EVENT(Frame, std::nullptr_t)
+  CRU_DEFINE_EVENT(FrameLate, const FrameLateEventArgs&)
+
+ private:
+  void RunFrame();
+
+ private:
+  double frame_rate_;
+  std::optional<Clock::time_point> last_frame_time_;
+  Clock::time_point scheduled_frame_time_;
+  TimerAutoCanceler frame_canceler_;
+};
+}  // namespace cru::platform::gui
@@ -1,6 +1,7 @@
 #pragma once
 #include "Base.h"
 
+#include "FrameClock.h"
 #include "Input.h"
 
 #include <cru/base/Bitmask.h>
@@ -126,6 +127,21 @@ struct CRU_PLATFORM_GUI_API INativeWindow : virtual IPlatformResource {
 
   virtual void RequestRepaint() = 0;
 
+  /**
+   * Request to repaint only the given area, which is relative to client
+   * lefttop. Areas requested before the paint happens are merged and the union
+   * is passed as NativePaintEventArgs::repaint_area.
+   *
+   * Default implementation repaints the whole window.
+   */
+  virtual void RequestPartialRepaint(const Rect& area);
+
+  /**
+   * The clock that paces repaints of this window. Return nullptr if the
+   * platform paces repaints itself, which is the default.
+   */
+  virtual FrameClock* GetFrameClock();
+
   // Remember to call EndDraw on return value and destroy it.
   virtual std::unique_ptr<graphics::IPainter> BeginPaint() = 0;
 
@@ -10,6 +10,7 @@
 
 #include <SDL3/SDL_video.h>
 #include <cairo.h>
+#include <optional>
 
 namespace cru::platform::gui::sdl {
 class SdlWindow;
@@ -23,11 +24,21 @@ class SdlOpenGLRenderer {
   ~SdlOpenGLRenderer();
 
   void Resize(int width, int height);
-  std::unique_ptr<graphics::IPainter> BeginPaint();
+  /**
+   * \param paint_area The area that is going to be painted, which is uploaded
+   * to the texture on next present. Null means the whole surface.
+   */
+  std::unique_ptr<graphics::IPainter> BeginPaint(
+      const std::optional<Rect>& paint_area = std::nullopt);
+  /**
+   * Upload dirty area to the texture and swap. Does nothing if nothing is
+   * painted since last present.
+   */
   void Present();
 
  private:
   GLuint CreateGLProgram();
+  void AddDirtyArea(const Rect& area);
   Guard MakeContextCurrent();
 
  private:
@@ -48,5 +59,8 @@ class SdlOpenGLRenderer {
 
   cairo_surface_t* cairo_surface_;
   cairo_t* cairo_;
+
+  // Area of cairo surface not yet uploaded to the texture, in whole pixels.
+  std::optional<Rect> dirty_area_;
 };
 }  // namespace cru::platform::gui::sdl
@@ -1,6 +1,7 @@
 #pragma once
 #include "Base.h"
 
+#include <cru/base/Event.h>
 #include <cru/base/Timer.h>
 #include <cru/platform/graphics/Factory.h>
 #include <cru/platform/gui/UiApplication.h>
@@ -11,12 +12,30 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace cru::platform::gui::sdl {
 class SdlWindow;
 class SdlCursorManager;
 class SdlClipboard;
 
+/**
+ * Phases of one SdlUiApplication::Run round. Frames of FrameClock are timers,
+ * so painting is counted in the timer phase.
+ */
+struct SdlUiApplicationRoundInfo {
+  /** Events taken from SDL in this round. */
+  Index event_count;
+  /** Events left after merging adjacent mouse motion and resize. */
+  Index dispatched_event_count;
+  /** Expired timers run in this round. */
+  Index timer_count;
+  std::chrono::steady_clock::duration wait_duration;
+  std::chrono::steady_clock::duration event_duration;
+  std::chrono::steady_clock::duration timer_duration;
+};
+
 class SdlUiApplication : public SdlResource, public virtual IUiApplication {
   friend SdlWindow;
 
@@ -60,6 +79,8 @@ class SdlUiApplication : public SdlResource, public virtual IUiApplication {
   // If return nullptr, it means the menu is not supported.
   IMenu* GetApplicationMenu() override;
 
+  CRU_DEFINE_EVENT(AfterEachRound, const SdlUiApplicationRoundInfo&)
+
  private:
   void RegisterWindow(SdlWindow* window);
   void UnregisterWindow(SdlWindow* window);
@@ -68,6 +89,12 @@ class SdlUiApplication : public SdlResource, public virtual IUiApplication {
   long long SetTimer(std::chrono::milliseconds milliseconds,
                      std::function<void()> action, bool repeat);
 
+  void WaitEvent(std::optional<std::chrono::milliseconds> timeout);
+  /**
+   * Take events queued at entry into pending_events_ and return the count.
+   */
+  Index TakeEvents();
+  Index RunTimers();
   bool DispatchEvent(const SDL_Event& event);
 
  private:
@@ -77,6 +104,7 @@ class SdlUiApplication : public SdlResource, public virtual IUiApplication {
   std::uint32_t empty_event_type_;
   DeleteLaterPool delete_later_pool_;
   TimerRegistry<std::function<void()>> timers_;
+  std::vector<SDL_Event> pending_events_;
   std::atomic_int quit_code_;
   std::vector<std::function<void()>> quit_handlers_;
 
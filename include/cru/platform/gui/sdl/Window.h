@@ -7,6 +7,7 @@
 
 #include <SDL3/SDL_events.h>
 #include <SDL3/SDL_video.h>
+#include <optional>
 
 #ifdef __unix
 #include "OpenGLRenderer.h"
@@ -77,6 +78,11 @@ class SdlWindow : public SdlResource, public virtual INativeWindow {
   void SetToForeground() override;
 
   void RequestRepaint() override;
+  void RequestPartialRepaint(const Rect& area) override;
+
+#ifdef __unix
+  FrameClock* GetFrameClock() override;
+#endif
 
   std::unique_ptr<graphics::IPainter> BeginPaint() override;
 
@@ -121,10 +127,15 @@ class SdlWindow : public SdlResource, public virtual INativeWindow {
   void UnixOnCreate(int width, int height);
   void UnixOnDestroy();
   void UnixOnResize(int width, int height);
+  void UnixOnFrame();
 
  private:
   std::unique_ptr<SdlOpenGLRenderer> renderer_;
-  TimerAutoCanceler repaint_timer_canceler_;
+  // Union of areas requested to repaint. Has value when a paint is pending.
+  std::optional<Rect> repaint_area_;
+  FrameClock frame_clock_;
+  // Area of the paint event being raised now.
+  std::optional<Rect> painting_area_;
 #endif
 };
 }  // namespace cru::platform::gui::sdl
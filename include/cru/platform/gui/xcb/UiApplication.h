@@ -1,6 +1,7 @@
 #pragma once
 #include "Base.h"
 
+#include <cru/base/Guard.h>
 #include <cru/base/platform/unix/EventLoop.h>
 #include <cru/platform/graphics/cairo/CairoGraphicsFactory.h>
 #include <cru/platform/gui/UiApplication.h>
@@ -9,6 +10,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace cru::platform::gui::xcb {
 class XcbWindow;
@@ -17,6 +19,27 @@ class XcbXimInputMethodManager;
 class XcbKeyboardManager;
 class XcbClipboard;
 
+/**
+ * Reset events that a later event of the same window supersedes: motion
+ * unless a button, key or crossing event lies in between, expose whose area
+ * is unioned into the later one, and configure. Only windows for which
+ * \p is_own_window returns true are touched.
+ */
+void CompressXEvents(std::vector<AutoFreePtr<xcb_generic_event_t>>& events,
+                     const std::function<bool(xcb_window_t)>& is_own_window);
+
+/**
+ * Handle X events in compressed batches until none is left. The first batch is
+ * drained with \p poll(false), which may read the connection. Handlers may
+ * read more events into the queue of the connection while waiting for replies,
+ * and the socket is not readable again for them, so later batches are drained
+ * with \p poll(true), which only takes already queued events.
+ */
+void HandleXEventBatches(
+    const std::function<xcb_generic_event_t*(bool queued_only)>& poll,
+    const std::function<bool(xcb_window_t)>& is_own_window,
+    const std::function<void(xcb_generic_event_t*)>& handle);
+
 class XcbUiApplication : public XcbResource, public virtual IUiApplication {
   friend XcbWindow;
 
@@ -93,6 +116,8 @@ class XcbUiApplication : public XcbResource, public virtual IUiApplication {
 
   void RegisterWindow(XcbWindow* window);
   void UnregisterWindow(XcbWindow* window);
+  void RegisterXcbWindowId(xcb_window_t id, XcbWindow* window);
+  void UnregisterXcbWindowId(xcb_window_t id);
 
  private:
   graphics::cairo::CairoGraphicsFactory* cairo_factory_;
@@ -108,6 +133,8 @@ class XcbUiApplication : public XcbResource, public virtual IUiApplication {
 
   bool is_quit_on_all_window_closed_;
   std::vector<XcbWindow*> windows_;
+  /** Created windows by their xcb id, for dispatching events. */
+  std::unordered_map<xcb_window_t, XcbWindow*> xcb_windows_;
 
   XcbCursorManager* cursor_manager_;
   XcbXimInputMethodManager* input_method_manager_;
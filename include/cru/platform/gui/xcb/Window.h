@@ -7,6 +7,8 @@
 
 #include <cairo.h>
 #include <xcb/xcb.h>
+#include <chrono>
+#include <cstdint>
 #include <optional>
 
 namespace cru::platform::gui::xcb {
@@ -14,6 +16,24 @@ class XcbUiApplication;
 class XcbCursor;
 class XcbXimInputMethodContext;
 
+struct XcbWindowPaintStatistics {
+  using Duration = std::chrono::steady_clock::duration;
+
+  std::uint64_t frame_count = 0;
+  // From BeginPaint to the end of EndDraw, including present.
+  Duration last_frame_time{};
+  Duration max_frame_time{};
+  Duration total_frame_time{};
+  // Copying the back buffer to the window. Always zero on the direct path.
+  Duration last_present_time{};
+  Duration total_present_time{};
+
+  Duration GetAverageFrameTime() const {
+    if (frame_count == 0) return {};
+    return total_frame_time / static_cast<Duration::rep>(frame_count);
+  }
+};
+
 class XcbWindow : public XcbResource, public virtual INativeWindow {
  private:
   constexpr static auto kLogTag = "cru::platform::gui::xcb::XcbWindow";
@@ -60,6 +80,9 @@ class XcbWindow : public XcbResource, public virtual INativeWindow {
   void SetToForeground() override;
 
   void RequestRepaint() override;
+  void RequestPartialRepaint(const Rect& area) override;
+
+  FrameClock* GetFrameClock() override;
 
   std::unique_ptr<graphics::IPainter> BeginPaint() override;
 
@@ -72,10 +95,27 @@ class XcbWindow : public XcbResource, public virtual INativeWindow {
   XcbUiApplication* GetXcbUiApplication();
   bool HasFocus();
 
+  /**
+   * When enabled (the default), painting goes to a retained offscreen image
+   * surface and only the repainted area is copied to the window at the end of
+   * drawing. When disabled, painters draw directly on the window surface.
+   */
+  bool IsBackBufferEnabled() const { return back_buffer_enabled_; }
+  void SetBackBufferEnabled(bool enabled);
+
+  const XcbWindowPaintStatistics& GetPaintStatistics() const {
+    return paint_statistics_;
+  }
+  void ResetPaintStatistics() { paint_statistics_ = {}; }
+
+  // Window an event is sent to, which is used to dispatch it.
+  static std::optional<xcb_window_t> GetEventWindow(xcb_generic_event_t* event);
+
  private:
+  class XcbWindowPainter;
+
   xcb_window_t DoCreateWindow();
   void HandleEvent(xcb_generic_event_t* event);
-  static std::optional<xcb_window_t> GetEventWindow(xcb_generic_event_t* event);
 
   void DoSetParent(xcb_window_t window);
   void DoSetStyleFlags(xcb_window_t window);
@@ -93,6 +133,12 @@ class XcbWindow : public XcbResource, public virtual INativeWindow {
 
   std::optional<Thickness> Get_NET_FRAME_EXTENTS(xcb_window_t window);
 
+  void CreateBackBuffer();
+  void DestroyBackBuffer();
+  void PresentBackBuffer(const Rect& area);
+  void OnPainterEndDraw(XcbWindowPainter* painter);
+  void OnFrame();
+
  private:
   XcbUiApplication* application_;
   std::optional<xcb_window_t> xcb_window_;
@@ -106,6 +152,17 @@ class XcbWindow : public XcbResource, public virtual INativeWindow {
   XcbWindow* parent_;
   XcbXimInputMethodContext* input_method_;
 
-  TimerAutoCanceler repaint_canceler_;
+  // Union of areas requested to repaint. Has value when a paint is pending.
+  std::optional<Rect> repaint_area_;
+  FrameClock frame_clock_;
+  // Area of the paint event being raised now. Painters created outside paint
+  // events present the whole window.
+  std::optional<Rect> painting_area_;
+
+  bool back_buffer_enabled_;
+  // Retained between paints, recreated on resize.
+  cairo_surface_t* back_buffer_surface_;
+
+  XcbWindowPaintStatistics paint_statistics_;
 };
 }  // namespace cru::platform::gui::xcb
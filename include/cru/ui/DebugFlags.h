@@ -7,4 +7,6 @@ constexpr bool shortcut = false;
 constexpr bool text_service = false;
 constexpr int click_detector = 0;
 constexpr int draw = 0;
+// Default value of ControlHost::IsPaintFlashingEnabled.
+constexpr bool paint_flashing = false;
 }  // namespace cru::ui::debug_flags
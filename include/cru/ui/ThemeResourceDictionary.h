@@ -2,6 +2,7 @@
 #include "Base.h"
 
 #include "cru/base/Base.h"
+#include "cru/base/xml/XmlDocument.h"
 #include "cru/base/xml/XmlNode.h"
 #include "datamodel/Base.h"
 #include "style/StyleRuleSet.h"
@@ -12,6 +13,10 @@
 #include <typeindex>
 #include <typeinfo>
 
+namespace cru::io {
+class MappedFileStream;
+}
+
 namespace cru::ui {
 class CRU_UI_API ThemeResourceKeyNotExistException : public Exception {
  public:
@@ -28,11 +33,17 @@ class CRU_UI_API ThemeResourceDictionary : public Object {
   constexpr static auto kLogTag = "ThemeResources";
 
  public:
+  /**
+   * The file stays mapped and is parsed without copying strings. A resource is
+   * copied into an XmlNode tree only when it is first converted.
+   */
   static std::unique_ptr<ThemeResourceDictionary> FromFile(
       std::filesystem::path file_path);
 
   explicit ThemeResourceDictionary(xml::XmlElementNode* xml_root,
                                    bool clone = true);
+  ThemeResourceDictionary(std::unique_ptr<io::MappedFileStream> stream,
+                          std::unique_ptr<xml::XmlDocument> xml_document);
   ~ThemeResourceDictionary() override;
 
  public:
@@ -56,7 +67,8 @@ class CRU_UI_API ThemeResourceDictionary : public Object {
           "No data type registered for theme resource key {}.", key));
     }
 
-    auto convert_result = data_type->ConvertFromXml(find_result->second.xml_node);
+    auto convert_result =
+        data_type->ConvertFromXml(GetXmlNode(find_result->second));
     if (!convert_result.IsSuccess()) {
       std::string errors;
       for (const auto& error : convert_result.GetErrors()) {
@@ -76,9 +88,6 @@ class CRU_UI_API ThemeResourceDictionary : public Object {
     return resource;
   }
 
- private:
-  void UpdateResourceMap(xml::XmlElementNode* root_xml);
-
  private:
   struct ResourceEntry {
     CRU_DEFAULT_CONSTRUCTOR_DESTRUCTOR(ResourceEntry)
@@ -86,11 +95,22 @@ class CRU_UI_API ThemeResourceDictionary : public Object {
     CRU_DEFAULT_MOVE(ResourceEntry)
 
     std::string name;
-    xml::XmlElementNode* xml_node;
+    // Null until converted from xml_view if the dictionary is from a file.
+    xml::XmlElementNode* xml_node = nullptr;
+    const xml::XmlNodeView* xml_view = nullptr;
     std::unordered_map<std::type_index, std::any> cache;
   };
 
+  void UpdateResourceMap(xml::XmlElementNode* root_xml);
+  void UpdateResourceMap(const xml::XmlNodeView* root_xml);
+  xml::XmlElementNode* GetXmlNode(ResourceEntry& entry);
+
+ private:
   std::unique_ptr<xml::XmlElementNode> xml_root_;
+  // Source of xml_document_ if it is from a file.
+  std::unique_ptr<io::MappedFileStream> stream_;
+  std::unique_ptr<xml::XmlDocument> xml_document_;
+  std::vector<std::unique_ptr<xml::XmlElementNode>> converted_nodes_;
   std::unordered_map<std::string, ResourceEntry> resource_map_;
 };
 }  // namespace cru::ui
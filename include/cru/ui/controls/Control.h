@@ -75,6 +75,12 @@ class CRU_UI_API Control : public Object,
   void RemoveChildAt(Index index);
   void AddChild(Control* control);
 
+  // Same as above but don't schedule a relayout of host. Only for controls
+  // that attach children while their render object is being laid out, or
+  // right before invalidating its layout themselves.
+  void InsertChildWithoutRelayout(Control* control, Index index);
+  void RemoveChildWithoutRelayout(Index index);
+
  public:
   virtual render::RenderObject* GetRenderObject() = 0;
 
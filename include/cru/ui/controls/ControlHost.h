@@ -1,10 +1,12 @@
 #pragma once
 #include "Control.h"
+#include "RoutedEventDispatcher.h"
 
 #include <cru/base/Base.h>
 #include <cru/base/Event.h>
 #include <cru/base/Guard.h>
 #include <cru/base/log/Logger.h>
+#include <cru/platform/graphics/Brush.h>
 #include <cru/platform/gui/UiApplication.h>
 #include <cru/platform/gui/Window.h>
 
@@ -20,10 +22,16 @@ class CRU_UI_API ControlHost : public Object {
 
   platform::gui::INativeWindow* GetNativeWindow();
 
+  // Schedule a repaint of the whole window.
   void ScheduleRepaint();
+  // If the native window has a frame clock, the relayout is done at the
+  // beginning of next frame, right before painting, so any number of relayout
+  // and repaint requests in one frame result in one layout and one paint.
   void ScheduleRelayout();
 
   Rect GetPaintInvalidArea();
+  // Mark the area (relative to window client) as dirty and schedule a repaint
+  // of it. Only dirty areas are repainted.
   void AddPaintInvalidArea(const Rect& area);
 
   void Repaint();
@@ -53,6 +61,11 @@ class CRU_UI_API ControlHost : public Object {
 
   bool IsInEventHandling();
 
+  // If true, every repainted area is covered by a translucent color for a
+  // short while so that it is easy to see what is repainted. For debug only.
+  bool IsPaintFlashingEnabled() const;
+  void SetPaintFlashingEnabled(bool value);
+
   CRU_DEFINE_EVENT(AfterLayout, std::nullptr_t)
 
  private:
@@ -81,95 +94,23 @@ class CRU_UI_API ControlHost : public Object {
   void DispatchEvent(Control* const original_sender,
                      events::RoutedEvent<EventArgs>* (Control::*event_ptr)(),
                      Control* const last_receiver, Args&&... args) {
-    constexpr auto kLogTag = "cru::ui::controls::DispatchEvent";
-
     event_handling_count_++;
     Guard event_handling_count_guard([this] { event_handling_count_--; });
 
-    if (original_sender == nullptr || original_sender == last_receiver) return;
-
-    std::string log = "Begin dispatching routed event " +
-                      (original_sender->*event_ptr)()->GetName() +
-                      ":\n\tTunnel:";
-
-    Guard logging_guard([&] {
-      log += "\nEnd dispatching routed event " +
-             (original_sender->*event_ptr)()->GetName() + ".";
-      CruLogDebug(kLogTag, "{}", log);
-    });
-
-    std::vector<ObjectResolver<Control>> receive_list;
-
-    auto parent = original_sender;
-    while (parent != last_receiver) {
-      receive_list.push_back(parent->CreateResolver());
-      parent = parent->GetParent();
-    }
-
-    auto handled = false;
-
-    // tunnel
-    for (auto i = receive_list.crbegin(); i != receive_list.crend(); ++i) {
-      auto control = i->Resolve();
-      log += " ";
-      if (!control) {
-        log += "(deleted)";
-        continue;
-      }
-      log += control->GetDebugId();
-      EventArgs event_args(control, original_sender,
-                           std::forward<Args>(args)...);
-      (control->*event_ptr)()->tunnel_.Raise(event_args);
-      if (event_args.IsHandled()) {
-        log += " marked as handled.";
-        handled = true;
-        break;
-      }
-    }
-
-    // bubble
-    if (!handled) {
-      log += "\n\tBubble:";
-      for (auto resolver : receive_list) {
-        auto control = resolver.Resolve();
-        log += " ";
-        if (!control) {
-          log += "(deleted)";
-          continue;
-        }
-        log += control->GetDebugId();
-        EventArgs event_args(control, original_sender,
-                             std::forward<Args>(args)...);
-        (control->*event_ptr)()->bubble_.Raise(event_args);
-        if (event_args.IsHandled()) {
-          log += " marked as handled.";
-          break;
-        }
-      }
-    }
-
-    log += "\n\tDirect:";
-    // direct
-    for (auto resolver : receive_list) {
-      auto control = resolver.Resolve();
-      log += " ";
-      if (!control) {
-        log += "(deleted)";
-        continue;
-      }
-      log += control->GetDebugId();
-      EventArgs event_args(control, original_sender,
-                           std::forward<Args>(args)...);
-      (control->*event_ptr)()->direct_.Raise(event_args);
-    }
+    event_dispatcher_.Dispatch(original_sender, event_ptr, last_receiver,
+                               std::forward<Args>(args)...);
   }
 
+  void DrawPaintFlashing(platform::graphics::IPainter* painter,
+                         const Rect& area);
+
   void UpdateCursor();
   void NotifyControlParentChange(Control* control, Control* old_parent,
                                  Control* new_parent);
 
  private:
   int event_handling_count_;
+  RoutedEventDispatcher event_dispatcher_;
 
   Control* root_control_;
   std::unique_ptr<platform::gui::INativeWindow> native_window_;
@@ -194,7 +135,21 @@ class CRU_UI_API ControlHost : public Object {
   bool layout_prefer_to_fill_window_;
 
   Rect paint_invalid_area_;
+  std::shared_ptr<platform::graphics::ISolidColorBrush> background_brush_;
+
+  bool paint_flashing_enabled_;
+  // True if the next repaint is to erase the flashing of last repaints.
+  bool paint_flashing_erasing_;
+  int paint_flashing_color_index_;
+  Rect paint_flashing_area_;
+  std::shared_ptr<platform::graphics::ISolidColorBrush> paint_flashing_brush_;
+  platform::gui::TimerAutoCanceler paint_flashing_erase_canceler_;
 
   platform::gui::TimerAutoCanceler relayout_schedule_canceler_;
+  // Relayout is scheduled to run at the beginning of next frame.
+  bool relayout_pending_;
+  // Relayout is running at the beginning of a frame. Paint invalidations only
+  // need to be recorded as the frame paints them right after.
+  bool in_frame_relayout_;
 };
 }  // namespace cru::ui::controls
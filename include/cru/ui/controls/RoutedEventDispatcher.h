@@ -0,0 +1,125 @@
+#pragma once
+#include "Control.h"
+
+#include <cru/base/Guard.h>
+#include <cru/base/log/Logger.h>
+
+#include <string>
+#include <vector>
+
+namespace cru::ui::controls {
+/**
+ * Dispatches routed events along the parent chain in tunnel, bubble and direct
+ * order. Routes of nested dispatches are stacked in one reused buffer, so a
+ * dispatch allocates nothing once the buffer has grown. Controls removed from
+ * the tree during dispatch are cleared from all routes and skipped.
+ */
+class CRU_UI_API RoutedEventDispatcher {
+ private:
+  constexpr static auto kLogTag = "cru::ui::controls::DispatchEvent";
+
+ public:
+  RoutedEventDispatcher() = default;
+
+  CRU_DELETE_COPY(RoutedEventDispatcher)
+  CRU_DELETE_MOVE(RoutedEventDispatcher)
+
+  ~RoutedEventDispatcher() = default;
+
+  bool IsDispatching() const { return !route_buffer_.empty(); }
+
+  /**
+   * Call it after \p control is removed from the tree, before it may be
+   * deleted.
+   */
+  void NotifyControlRemoved(Control* control);
+
+  template <typename EventArgs, typename... Args>
+  void Dispatch(Control* const original_sender,
+                events::RoutedEvent<EventArgs>* (Control::*event_ptr)(),
+                Control* const last_receiver, Args&&... args) {
+    if (original_sender == nullptr || original_sender == last_receiver) return;
+
+    const auto route_begin = route_buffer_.size();
+    for (auto control = original_sender;
+         control != nullptr && control != last_receiver;
+         control = control->GetParent()) {
+      route_buffer_.push_back(control);
+    }
+    const auto route_end = route_buffer_.size();
+    Guard route_guard(
+        [this, route_begin] { route_buffer_.resize(route_begin); });
+
+    const auto log_enabled = log::ILogger::GetInstance()->IsEnabled(
+        log::LogLevel::Debug, kLogTag);
+    // Sender may be deleted during dispatch, so keep a copy.
+    std::string event_name;
+    std::string log;
+    if (log_enabled) {
+      event_name = (original_sender->*event_ptr)()->GetName();
+      log = "Begin dispatching routed event " + event_name + ":\n\tTunnel:";
+    }
+
+    auto resolve = [this, log_enabled, &log](std::size_t index) {
+      auto control = route_buffer_[index];
+      if (log_enabled) {
+        log += " ";
+        log += control ? control->GetDebugId() : "(deleted)";
+      }
+      return control;
+    };
+
+    EventArgs event_args(original_sender, original_sender,
+                         std::forward<Args>(args)...);
+    auto raise = [&event_args](Control* control, Event<EventArgs&>& event) {
+      event_args.SetSender(control);
+      event_args.SetHandled(false);
+      event.Raise(event_args);
+      return event_args.IsHandled();
+    };
+
+    auto handled = false;
+
+    // tunnel
+    for (auto i = route_end; i > route_begin; --i) {
+      auto control = resolve(i - 1);
+      if (!control) continue;
+      if (raise(control, (control->*event_ptr)()->tunnel_)) {
+        if (log_enabled) log += " marked as handled.";
+        handled = true;
+        break;
+      }
+    }
+
+    // bubble
+    if (!handled) {
+      if (log_enabled) log += "\n\tBubble:";
+      for (auto i = route_begin; i < route_end; ++i) {
+        auto control = resolve(i);
+        if (!control) continue;
+        if (raise(control, (control->*event_ptr)()->bubble_)) {
+          if (log_enabled) log += " marked as handled.";
+          break;
+        }
+      }
+    }
+
+    // direct
+    if (log_enabled) log += "\n\tDirect:";
+    for (auto i = route_begin; i < route_end; ++i) {
+      auto control = resolve(i);
+      if (!control) continue;
+      raise(control, (control->*event_ptr)()->direct_);
+    }
+
+    if (log_enabled) {
+      log += "\nEnd dispatching routed event " + event_name + ".";
+      CruLogDebug(kLogTag, "{}", log);
+    }
+  }
+
+ private:
+  // Routes of nested dispatches, sender first in each.
+  std::vector<Control*> route_buffer_;
+};
+}  // namespace cru::ui::controls
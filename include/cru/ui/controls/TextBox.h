@@ -34,7 +34,6 @@ class CRU_UI_API TextBox : public Control,
   void ApplyBorderStyle(const style::ApplyBorderStyleInfo& style) override;
 
   std::string GetText() { return service_->GetText(); }
-  std::string_view GetTextView() { return service_->GetTextView(); }
   void SetText(std::string text) { service_->SetText(std::move(text)); }
 
   IEvent<std::nullptr_t>* TextChangeEvent() {
@@ -1,5 +1,6 @@
 #pragma once
 #include "../render/TextRenderObject.h"
+#include "cru/base/PieceTable.h"
 #include "cru/base/StringUtil.h"
 #include "cru/platform/gui/InputMethod.h"
 #include "cru/platform/gui/UiApplication.h"
@@ -7,6 +8,7 @@
 #include "cru/ui/helper/ShortcutHub.h"
 
 #include <functional>
+#include <optional>
 #include <vector>
 
 namespace cru::ui::render {
@@ -48,7 +50,7 @@ class TextControlMovePattern {
 
   using MoveFunction =
       std::function<Index(TextHostControlService* service,
-                          std::string_view text, Index current_position)>;
+                          const PieceTable& text, Index current_position)>;
 
   TextControlMovePattern(std::string name, helper::ShortcutKeyBind key_bind,
                          MoveFunction move_function)
@@ -59,7 +61,7 @@ class TextControlMovePattern {
  public:
   std::string GetName() const { return name_; }
   helper::ShortcutKeyBind GetKeyBind() const { return key_bind_; }
-  Index Move(TextHostControlService* service, std::string_view text,
+  Index Move(TextHostControlService* service, const PieceTable& text,
              Index current_position) const {
     return move_function_(service, text, current_position);
   }
@@ -92,8 +94,12 @@ class CRU_UI_API TextHostControlService : public Object {
   // If text contains line feed characters, it will be converted to space.
   void SetMultiLine(bool multi_line);
 
-  std::string GetText() { return this->text_; }
-  std::string_view GetTextView() { return this->text_; }
+  /**
+   * Flattens the text, which is O(n). Prefer GetTextBuffer for large
+   * documents.
+   */
+  std::string GetText() { return this->text_.ToString(); }
+  const PieceTable& GetTextBuffer() { return this->text_; }
   void SetText(std::string text, bool stop_composition = false);
 
   void CancelComposition();
@@ -109,7 +115,7 @@ class CRU_UI_API TextHostControlService : public Object {
   Index GetCaretPosition() { return selection_.GetEnd(); }
   TextRange GetSelection() { return selection_; }
 
-  std::string_view GetSelectedText();
+  std::string GetSelectedText();
 
   Index NextNCharPosition(Index count);
   Index PreviousNCharPosition(Index count);
@@ -135,6 +141,11 @@ class CRU_UI_API TextHostControlService : public Object {
 
   void ScrollToCaret();
 
+  /**
+   * Times the break iterator window is built from text. For diagnostics.
+   */
+  Index GetBreakWindowBuildCount() { return break_window_build_count_; }
+
   void Cut();
   void Copy();
   void Paste();
@@ -150,9 +161,18 @@ class CRU_UI_API TextHostControlService : public Object {
 
   void CoerceSelection();
 
+  // Set text of break iterator to the text around position and move to it.
+  // Returned offset maps iterator positions to text positions.
+  Index PrepareBreakIterator(Index position);
+  // Apply an edit to break iterator text if it is inside the window.
+  void EditBreakWindow(Index position, Index count, std::string_view text);
+
   void SetupCaret();
   void TearDownCaret();
 
+  // Remove composition text inserted by SyncTextRenderObject, so that text
+  // of render object is the same as text_ again.
+  void RemoveRenderComposition();
   void SyncTextRenderObject();
 
   void UpdateInputMethodPosition();
@@ -191,9 +211,21 @@ class CRU_UI_API TextHostControlService : public Object {
   EventHandlerRevokerListGuard event_guard_;
   EventHandlerRevokerListGuard input_method_context_event_guard_;
 
-  std::string text_;
+  PieceTable text_;
+  // Edits are applied to render object as replaces, so cost of an edit does
+  // not grow with text size. Render object text is text_ with composition
+  // text inserted at this range, if any.
+  std::optional<TextRange> render_composition_range_;
+
   TextRange selection_;
+
+  // Break iterator only sees a window of text around caret, so cost of moving
+  // caret does not grow with text size.
   cru::string::StringBreakIterator string_break_iterator_;
+  bool break_window_valid_ = false;
+  Index break_window_begin_ = 0;
+  Index break_window_end_ = 0;
+  Index break_window_build_count_ = 0;
 
   bool enable_ = false;
   bool editable_ = false;
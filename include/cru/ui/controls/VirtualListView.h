@@ -0,0 +1,76 @@
+#pragma once
+#include "Control.h"
+#include "cru/ui/model/IVirtualListModel.h"
+#include "cru/ui/render/ScrollRenderObject.h"
+#include "cru/ui/render/VirtualListRenderObject.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace cru::ui::controls {
+/**
+ * Shows items of a model in a scrollable list, or a tree if items have depth.
+ * Only items in viewport have a control. Controls of items scrolled out are
+ * recycled for items scrolled in, so a control must be fully reset by the
+ * binder.
+ */
+class CRU_UI_API VirtualListView : public Control,
+                                   private render::IVirtualListRowProvider {
+ private:
+  constexpr static auto kLogTag = "cru::ui::controls::VirtualListView";
+
+  using Control::AddChild;
+
+ public:
+  static constexpr auto kControlName = "VirtualListView";
+
+  using ItemControlFactory = std::function<std::unique_ptr<Control>()>;
+  using ItemControlBinder = std::function<void(Control* control, Index index)>;
+
+  VirtualListView();
+  ~VirtualListView() override;
+
+  render::RenderObject* GetRenderObject() override {
+    return scroll_render_object_.get();
+  }
+
+  render::ScrollRenderObject* GetScrollRenderObject() {
+    return scroll_render_object_.get();
+  }
+  render::VirtualListRenderObject* GetListRenderObject() {
+    return list_render_object_.get();
+  }
+
+  model::IVirtualListModel* GetModel() { return model_.get(); }
+  void SetModel(std::shared_ptr<model::IVirtualListModel> model);
+
+  // Both must be set before setting model.
+  void SetItemControlFactory(ItemControlFactory factory);
+  void SetItemControlBinder(ItemControlBinder binder);
+
+  // Return nullptr if the item is not realized.
+  Control* GetItemControl(Index index);
+
+  void ScrollIntoView(Index index);
+
+ private:
+  Index GetRowCount() override;
+  int GetRowDepth(Index index) override;
+  render::RenderObject* RealizeRow(Index index) override;
+  void UnrealizeRow(Index index, render::RenderObject* render_object) override;
+
+ private:
+  std::unique_ptr<render::ScrollRenderObject> scroll_render_object_;
+  std::unique_ptr<render::VirtualListRenderObject> list_render_object_;
+
+  std::shared_ptr<model::IVirtualListModel> model_;
+  EventHandlerRevokerGuard model_change_revoker_;
+
+  ItemControlFactory item_control_factory_;
+  ItemControlBinder item_control_binder_;
+
+  std::vector<std::unique_ptr<Control>> item_controls_;
+  std::vector<Control*> recycled_item_controls_;
+};
+}  // namespace cru::ui::controls
@@ -8,7 +8,7 @@ namespace cru::ui::events {
 // EventArgs must be reference because the IsHandled property must be settable.
 template <typename TEventArgs>
 class CRU_UI_API RoutedEvent {
-  friend controls::ControlHost;
+  friend controls::RoutedEventDispatcher;
 
  public:
   static_assert(std::is_base_of_v<UiEventArgs, TEventArgs>,
@@ -20,7 +20,7 @@ class CRU_UI_API RoutedEvent {
 
   explicit RoutedEvent(std::string name) : name_(std::move(name)) {}
 
-  std::string GetName() const { return name_; }
+  const std::string& GetName() const { return name_; }
 
   IEvent<TEventArgs&>* Direct() { return &direct_; }
   IEvent<TEventArgs&>* Bubble() { return &bubble_; }
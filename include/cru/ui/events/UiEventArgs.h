@@ -1,8 +1,14 @@
 #pragma once
 #include "../Base.h"
 
+namespace cru::ui::controls {
+class RoutedEventDispatcher;
+}
+
 namespace cru::ui::events {
 class CRU_UI_API UiEventArgs : public Object {
+  friend controls::RoutedEventDispatcher;
+
  public:
   UiEventArgs(Object* sender, Object* original_sender)
       : sender_(sender), original_sender_(original_sender), handled_(false) {}
@@ -14,6 +20,10 @@ class CRU_UI_API UiEventArgs : public Object {
   bool IsHandled() const { return handled_; }
   void SetHandled(const bool handled = true) { handled_ = handled; }
 
+ private:
+  // Dispatcher reuses one args object along the route.
+  void SetSender(Object* sender) { sender_ = sender; }
+
  private:
   Object* sender_;
   Object* original_sender_;
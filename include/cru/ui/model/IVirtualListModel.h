@@ -0,0 +1,23 @@
+#pragma once
+#include "../Base.h"
+#include "cru/base/Base.h"
+#include "cru/base/Event.h"
+
+namespace cru::ui::model {
+/**
+ * Data of a virtualized list. A tree is presented as the flattened list of its
+ * visible nodes, each with a depth. Only items currently on screen are queried,
+ * so a model may hold millions of items.
+ */
+struct CRU_UI_API IVirtualListModel : virtual Interface {
+  virtual Index GetItemCount() = 0;
+  virtual int GetItemDepth(Index index) { return 0; }
+
+  virtual bool IsItemExpandable(Index index) { return false; }
+  virtual bool IsItemExpanded(Index index) { return false; }
+  virtual void SetItemExpanded(Index index, bool expanded) {}
+
+  // Raised when items are added, removed, changed, expanded or collapsed.
+  virtual IEvent<std::nullptr_t>* ItemsChangedEvent() = 0;
+};
+}  // namespace cru::ui::model
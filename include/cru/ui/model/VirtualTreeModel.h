@@ -0,0 +1,182 @@
+#pragma once
+#include "IVirtualListModel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace cru::ui::model {
+/**
+ * A tree whose visible nodes are exposed as a flat list. The root is hidden and
+ * always expanded. The flat list is rebuilt lazily on first access after a
+ * change, in O(visible node count), so batch changes cost one rebuild.
+ * Expanding or collapsing a node only splices its visible descendants.
+ */
+template <typename T>
+class VirtualTreeModel : public Object, public virtual IVirtualListModel {
+ public:
+  class Node {
+    friend VirtualTreeModel;
+
+   public:
+    Node(Node* parent, T value) : parent_(parent), value(std::move(value)) {}
+
+    CRU_DELETE_COPY(Node)
+    CRU_DELETE_MOVE(Node)
+
+    ~Node() = default;
+
+    Node* GetParent() const { return parent_; }
+    int GetDepth() const {
+      int depth = -1;
+      for (auto node = parent_; node; node = node->parent_) depth++;
+      return depth;
+    }
+
+    Index GetChildCount() const { return static_cast<Index>(children_.size()); }
+    Node* GetChildAt(Index index) const { return children_[index].get(); }
+
+    bool IsExpanded() const { return expanded_; }
+
+   private:
+    Node* parent_;
+    std::vector<std::unique_ptr<Node>> children_;
+    bool expanded_ = false;
+
+   public:
+    T value;
+  };
+
+  VirtualTreeModel() : root_(nullptr, T{}) { root_.expanded_ = true; }
+
+  Node* GetRoot() { return &root_; }
+
+  Node* AddNode(Node* parent, T value) {
+    return InsertNode(parent, parent->GetChildCount(), std::move(value));
+  }
+
+  Node* InsertNode(Node* parent, Index position, T value) {
+    CheckArgumentRange(position, 0, parent->GetChildCount(), "position", true);
+    auto node = new Node(parent, std::move(value));
+    parent->children_.emplace(parent->children_.begin() + position, node);
+    if (IsNodeVisible(parent)) NotifyChanged();
+    return node;
+  }
+
+  void RemoveNode(Node* node) {
+    auto parent = node->parent_;
+    assert(parent);
+    auto visible = IsNodeVisible(parent);
+    std::erase_if(parent->children_, [node](const std::unique_ptr<Node>& n) {
+      return n.get() == node;
+    });
+    if (visible) NotifyChanged();
+  }
+
+  void SetNodeExpanded(Node* node, bool expanded) {
+    SetNodeExpanded(node, expanded, -1);
+  }
+
+  // Call it after value of a visible node is changed.
+  void NotifyChanged() {
+    visible_nodes_valid_ = false;
+    ItemsChangedEvent_.Raise(nullptr);
+  }
+
+  Node* GetNodeAt(Index index) {
+    EnsureVisibleNodes();
+    return visible_nodes_[index];
+  }
+  T& GetItemAt(Index index) { return GetNodeAt(index)->value; }
+
+  Index GetItemCount() override {
+    EnsureVisibleNodes();
+    return static_cast<Index>(visible_nodes_.size());
+  }
+
+  int GetItemDepth(Index index) override { return GetNodeAt(index)->GetDepth(); }
+
+  bool IsItemExpandable(Index index) override {
+    return GetNodeAt(index)->GetChildCount() != 0;
+  }
+  bool IsItemExpanded(Index index) override {
+    return GetNodeAt(index)->IsExpanded();
+  }
+  void SetItemExpanded(Index index, bool expanded) override {
+    SetNodeExpanded(GetNodeAt(index), expanded, index);
+  }
+
+  CRU_DEFINE_EVENT_OVERRIDE(ItemsChanged, std::nullptr_t)
+
+ private:
+  // A node is visible if all its ancestors are expanded. Root counts as
+  // visible for convenience.
+  bool IsNodeVisible(Node* node) {
+    for (auto n = node; n; n = n->parent_) {
+      if (!n->expanded_) return false;
+    }
+    return true;
+  }
+
+  // index is the index of node in visible nodes, or -1 if unknown.
+  void SetNodeExpanded(Node* node, bool expanded, Index index) {
+    if (node == &root_ || node->expanded_ == expanded) return;
+    if (node->GetChildCount() == 0 || !IsNodeVisible(node->parent_)) {
+      node->expanded_ = expanded;
+      return;
+    }
+
+    if (visible_nodes_valid_) {
+      if (index == -1) {
+        index = std::ranges::find(visible_nodes_, node) -
+                visible_nodes_.cbegin();
+      }
+      auto position = visible_nodes_.begin() + index + 1;
+      if (expanded) {
+        node->expanded_ = true;
+        std::vector<Node*> nodes;
+        AppendVisibleNodes(node, nodes);
+        visible_nodes_.insert(position, nodes.cbegin(), nodes.cend());
+      } else {
+        visible_nodes_.erase(position, position + CountVisibleNodes(node));
+        node->expanded_ = false;
+      }
+    } else {
+      node->expanded_ = expanded;
+    }
+
+    ItemsChangedEvent_.Raise(nullptr);
+  }
+
+  void EnsureVisibleNodes() {
+    if (visible_nodes_valid_) return;
+    visible_nodes_.clear();
+    AppendVisibleNodes(&root_, visible_nodes_);
+    visible_nodes_valid_ = true;
+  }
+
+  // Visible descendants of node, in order.
+  static void AppendVisibleNodes(Node* node, std::vector<Node*>& nodes) {
+    if (!node->expanded_) return;
+    for (const auto& child : node->children_) {
+      nodes.push_back(child.get());
+      AppendVisibleNodes(child.get(), nodes);
+    }
+  }
+
+  static Index CountVisibleNodes(Node* node) {
+    if (!node->expanded_) return 0;
+    Index count = 0;
+    for (const auto& child : node->children_) {
+      count += 1 + CountVisibleNodes(child.get());
+    }
+    return count;
+  }
+
+ private:
+  Node root_;
+  bool visible_nodes_valid_ = false;
+  std::vector<Node*> visible_nodes_;
+};
+}  // namespace cru::ui::model
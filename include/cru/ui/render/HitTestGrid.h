@@ -0,0 +1,60 @@
+#pragma once
+#include "../Base.h"
+
+#include <span>
+#include <vector>
+
+namespace cru::ui::render {
+/**
+ * A uniform grid over a set of rects, used to find the few rects that may
+ * contain a point without testing all of them. Cells are about the same count
+ * as rects. Indexes in a cell are in ascending order.
+ */
+class CRU_UI_API HitTestGrid {
+ public:
+  HitTestGrid() = default;
+
+  bool IsEmpty() const { return rects_.empty(); }
+  void Clear();
+
+  /**
+   * O(n) if rects do not span many cells.
+   */
+  void Build(std::span<const Rect> rects);
+
+  /**
+   * Move rects changed since last build or update to their new cells, which
+   * costs O(n) comparisons plus the moves. Build again if the count changes,
+   * a rect leaves the bounds or gains or loses size, or many rects change.
+   */
+  void Update(std::span<const Rect> rects);
+
+  /**
+   * Indexes of rects with size that may contain \p point.
+   */
+  std::span<const Index> Query(const Point& point) const;
+
+  /**
+   * Indexes of rects with no size, in ascending order. They are in no cell,
+   * but their owners may still want to test them, e.g. for overflowing
+   * content.
+   */
+  std::span<const Index> GetUnsizedIndexes() const {
+    return unsized_indexes_;
+  }
+
+ private:
+  template <typename F>
+  void ForEachCell(const Rect& rect, F&& f);
+
+ private:
+  Rect bounds_;
+  int column_count_ = 0;
+  int row_count_ = 0;
+  float cell_width_ = 0;
+  float cell_height_ = 0;
+  std::vector<Rect> rects_;
+  std::vector<std::vector<Index>> cells_;
+  std::vector<Index> unsized_indexes_;
+};
+}  // namespace cru::ui::render
@@ -1,5 +1,6 @@
 #pragma once
 #include "../controls/Control.h"  // IWYU pragma: keep
+#include "HitTestGrid.h"
 #include "RenderObject.h"
 
 namespace cru::ui::render {
@@ -9,6 +10,9 @@ class LayoutRenderObject : public RenderObject {
   using ChildLayoutData = TChildLayoutData;
 
  private:
+  // Below this count, testing children one by one is cheaper than the grid.
+  constexpr static Index kHitTestGridThreshold = 16;
+
   struct ChildData {
     /**
      * May be nullptr.
@@ -34,6 +38,7 @@ class LayoutRenderObject : public RenderObject {
     auto iter = children_.insert(children_.begin() + position,
                                  ChildData{render_object, ChildLayoutData()});
     render_object->SetParent(this);
+    hit_test_grid_valid_ = false;
     iter->event_guard.Add(
         render_object->DestroyEvent()->AddSpyOnlyHandler([this, render_object] {
           auto this_control = this->GetAttachedControl();
@@ -61,6 +66,7 @@ class LayoutRenderObject : public RenderObject {
       render_object->SetParent(nullptr);
     }
     children_.erase(children_.begin() + position);
+    hit_test_grid_valid_ = false;
     InvalidateLayout();
   }
 
@@ -72,6 +78,7 @@ class LayoutRenderObject : public RenderObject {
       }
     }
     children_.clear();
+    hit_test_grid_valid_ = false;
     InvalidateLayout();
   }
 
@@ -88,18 +95,59 @@ class LayoutRenderObject : public RenderObject {
 
   RenderObject* HitTest(const Point& point) override {
     const auto child_count = GetChildCount();
-    for (auto i = child_count - 1; i >= 0; --i) {
-      const auto child = GetChildAt(i);
-      const auto result = child->HitTest(point - child->GetOffset());
-      if (result != nullptr) {
-        return result;
+    if (child_count < kHitTestGridThreshold) {
+      for (auto i = child_count - 1; i >= 0; --i) {
+        const auto result = ChildHitTest(i, point);
+        if (result != nullptr) {
+          return result;
+        }
+      }
+    } else {
+      // Children are in cells by hit test bounds of their whole subtree, so
+      // the grid finds the same children as the linear path. Children laid out
+      // later are on top, so test candidates in reverse. Children without
+      // bounds are in no cell, so merge them in to keep the order.
+      const auto& grid = GetHitTestGrid();
+      const auto candidates = grid.Query(point);
+      const auto unsized = grid.GetUnsizedIndexes();
+      auto i = candidates.rbegin();
+      auto j = unsized.rbegin();
+      while (i != candidates.rend() || j != unsized.rend()) {
+        const auto position =
+            j == unsized.rend() || (i != candidates.rend() && *i > *j) ? *i++
+                                                                       : *j++;
+        const auto result = ChildHitTest(position, point);
+        if (result != nullptr) {
+          return result;
+        }
       }
     }
 
     return GetPaddingRect().IsPointInside(point) ? this : nullptr;
   }
 
+  Rect GetHitTestBounds() override { return hit_test_bounds_; }
+
  protected:
+  void OnLayoutCore(const Rect& rect) override {
+    RenderObject::OnLayoutCore(rect);
+    UpdateChildHitTestBounds();
+    hit_test_bounds_ = RenderObject::GetHitTestBounds();
+    for (const auto& bounds : child_hit_test_bounds_) {
+      hit_test_bounds_ = UnionHitTestBounds(hit_test_bounds_, bounds);
+    }
+
+    // Children only move in layout. Usually few of them move, so update the
+    // grid in place instead of rebuilding it on next hit test.
+    if (GetChildCount() < kHitTestGridThreshold) {
+      hit_test_grid_valid_ = false;
+    } else if (hit_test_grid_valid_) {
+      hit_test_grid_.Update(child_hit_test_bounds_);
+    } else {
+      GetHitTestGrid();
+    }
+  }
+
   void OnDraw(RenderObjectDrawContext& context) override {
     auto painter = context.painter;
     for (const auto& child : children_) {
@@ -107,7 +155,41 @@ class LayoutRenderObject : public RenderObject {
     }
   }
 
+ private:
+  RenderObject* ChildHitTest(Index position, const Point& point) {
+    const auto child = children_[position].render_object;
+    if (child == nullptr) return nullptr;
+    return child->HitTest(point - child->GetOffset());
+  }
+
+  void UpdateChildHitTestBounds() {
+    child_hit_test_bounds_.clear();
+    for (const auto& child : children_) {
+      const auto render_object = child.render_object;
+      child_hit_test_bounds_.push_back(
+          render_object ? render_object->GetHitTestBounds().WithOffset(
+                              render_object->GetOffset())
+                        : Rect{});
+    }
+  }
+
+  // Rebuilt when children are added or removed, as indexes shift.
+  const HitTestGrid& GetHitTestGrid() {
+    if (!hit_test_grid_valid_) {
+      UpdateChildHitTestBounds();
+      hit_test_grid_.Build(child_hit_test_bounds_);
+      hit_test_grid_valid_ = true;
+    }
+    return hit_test_grid_;
+  }
+
  private:
   std::vector<ChildData> children_;
+
+  Rect hit_test_bounds_;
+  // Reused in each layout.
+  std::vector<Rect> child_hit_test_bounds_;
+  bool hit_test_grid_valid_ = false;
+  HitTestGrid hit_test_grid_;
 };
 }  // namespace cru::ui::render
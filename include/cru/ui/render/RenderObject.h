@@ -37,6 +37,7 @@ struct CRU_UI_API RenderObjectDrawContext {
 class CRU_UI_API RenderObject : public Object {
  private:
   constexpr static auto kLogTag = "cru::ui::render::RenderObject";
+  constexpr static float kPaintInvalidAreaMargin = 2.f;
 
  public:
   RenderObject(std::string name);
@@ -62,6 +63,11 @@ class CRU_UI_API RenderObject : public Object {
   Point GetOffset() { return offset_; }
   Size GetSize() { return size_; }
 
+  // Translation applied to children when drawing and hit testing, in addition
+  // to their own offsets. It is accounted for in GetTotalOffset. Scrolling
+  // uses it so that changing scroll offset does not need a relayout.
+  virtual Point GetChildTranslation() { return {}; }
+
   Point GetTotalOffset();
   Point FromRootToContent(const Point& point);
 
@@ -123,6 +129,16 @@ class CRU_UI_API RenderObject : public Object {
   // margin. Add offset before pass point to children.
   virtual RenderObject* HitTest(const Point& point) = 0;
 
+  /**
+   * Bounds of all points HitTest may hit, in the same coordinates. Default is
+   * own rect. Render objects with children include theirs, and ones hit outside
+   * their own rect in other ways must override it. Valid after layout.
+   */
+  virtual Rect GetHitTestBounds() { return Rect(Point{}, GetSize()); }
+
+  // Union of two hit test bounds. One without size is ignored.
+  static Rect UnionHitTestBounds(const Rect& bounds, const Rect& other);
+
  public:
   controls::ControlHost* GetControlHost();
   void InvalidateLayout();
@@ -12,8 +12,9 @@ namespace cru::ui::render {
 // Or child's size is coerced into requirement and then used as result.
 // If no child, then use the preferred size if set or min size if set or 0.
 // Layout logic:
-// If child is smaller than content area, layout at lefttop.
-// Or layout by scroll state.
+// Child is always laid out at lefttop of content area. Scroll offset is applied
+// as a translation when drawing and hit testing, so scrolling only repaints and
+// never relayouts.
 class CRU_UI_API ScrollRenderObject : public SingleChildRenderObject {
  public:
   static constexpr auto kRenderObjectName = "ScrollRenderObject";
@@ -21,6 +22,13 @@ class CRU_UI_API ScrollRenderObject : public SingleChildRenderObject {
   ScrollRenderObject();
 
   RenderObject* HitTest(const Point& point) override;
+  // Covers child at any scroll offset, as scrolling doesn't relayout.
+  Rect GetHitTestBounds() override;
+
+  Point GetChildTranslation() override { return GetScrollOffset().Negate(); }
+
+  // Scroll bars are drawn in padding area.
+  Rect GetRenderRect() override { return GetPaddingRect(); }
 
   // Return the coerced scroll offset.
   Point GetScrollOffset();
@@ -62,6 +70,9 @@ class CRU_UI_API ScrollRenderObject : public SingleChildRenderObject {
   bool VerticalCanScrollUp();
   bool VerticalCanScrollDown();
 
+  // Raised when the coerced scroll offset is changed by SetScrollOffset.
+  CRU_DEFINE_EVENT(ScrollOffsetChange, std::nullptr_t)
+
  protected:
   // Logic:
   // If available size is bigger than child's preferred size, then child's
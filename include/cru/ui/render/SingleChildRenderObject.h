@@ -12,6 +12,8 @@ class CRU_UI_API SingleChildRenderObject : public RenderObject {
   RenderObject* GetChild() const { return child_; }
   void SetChild(RenderObject* new_child);
 
+  Rect GetHitTestBounds() override;
+
  protected:
   virtual void OnChildChanged(RenderObject* old_child, RenderObject* new_child);
 
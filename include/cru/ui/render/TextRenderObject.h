@@ -1,8 +1,14 @@
 #pragma once
 #include "RenderObject.h"
 
+#include <cru/platform/graphics/Factory.h>
+
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace cru::ui::render {
 // Layout logic:
@@ -18,6 +24,12 @@ namespace cru::ui::render {
 //
 // If the result layout box is bigger than actual text box, then text is center
 // aligned.
+//
+// Text is measured through graphics factory and the text layout is only wrapped
+// at measured width in layout, so that parents measuring several times with
+// different widths don't relayout the text each time. Edit mode, including
+// trailing space and attributes changing weight or style measure with the text
+// layout directly.
 class CRU_UI_API TextRenderObject : public RenderObject {
  private:
   constexpr static auto kLogTag = "cru::ui::render::TextRenderObject";
@@ -33,7 +45,10 @@ class CRU_UI_API TextRenderObject : public RenderObject {
                    std::shared_ptr<platform::graphics::IBrush> caret_brush);
 
   std::string GetText();
+  Index GetTextSize() { return text_size_; }
   void SetText(std::string new_text);
+  // See ITextLayout::ReplaceText. Prefer it to SetText for edits.
+  void ReplaceText(Index position, Index count, std::string_view text);
 
   std::shared_ptr<platform::graphics::IBrush> GetBrush() { return brush_; }
   void SetBrush(std::shared_ptr<platform::graphics::IBrush> new_brush);
@@ -44,6 +59,9 @@ class CRU_UI_API TextRenderObject : public RenderObject {
   bool IsEditMode();
   void SetEditMode(bool enable);
 
+  // See ITextLayout::SetAttributes. Changing only brushes doesn't relayout.
+  void SetAttributes(std::vector<platform::graphics::TextAttribute> attributes);
+
   Index GetLineCount();
   Index GetLineIndexFromCharIndex(Index char_index);
   float GetLineHeight(Index line_index);
@@ -94,10 +112,23 @@ class CRU_UI_API TextRenderObject : public RenderObject {
   void OnLayoutContent(const Rect& content_rect) override;
   void OnDraw(RenderObjectDrawContext& context) override;
 
+ private:
+  Size MeasureText(float max_width);
+  void SetTextLayoutMaxWidth(float max_width);
+  void InvalidateTextMeasure();
+
  private:
   std::shared_ptr<platform::graphics::IBrush> brush_;
   std::shared_ptr<platform::graphics::IFont> font_;
   std::unique_ptr<platform::graphics::ITextLayout> text_layout_;
+  Index text_size_ = 0;
+  float text_layout_max_width_ = -1.f;
+  bool has_shaping_attributes_ = false;
+
+  float measure_width_ = std::numeric_limits<float>::max();
+  std::optional<platform::graphics::TextMeasure> text_measure_;
+  // Last measured width and its result.
+  std::optional<std::pair<float, Size>> width_measure_;
 
   std::optional<TextRange> selection_range_ = std::nullopt;
   std::shared_ptr<platform::graphics::IBrush> selection_brush_;
@@ -61,6 +61,7 @@ class CRU_UI_API TreeRenderObject : public RenderObject {
   void SetTabWidth(float tab_width);
 
   RenderObject* HitTest(const Point& point) override;
+  Rect GetHitTestBounds() override;
 
  protected:
   Size OnMeasureContent(const MeasureRequirement& requirement) override;
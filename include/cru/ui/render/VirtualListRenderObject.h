@@ -0,0 +1,122 @@
+#pragma once
+#include "RenderObject.h"
+
+#include <cru/base/PrefixSumTree.h>
+#include <cru/base/Range.h>
+#include <cru/platform/gui/UiApplication.h>
+
+#include <vector>
+
+namespace cru::ui::render {
+/**
+ * Supplies rows to VirtualListRenderObject. Rows are realized only when they
+ * are about to be visible and unrealized when they scroll away, so that the
+ * provider can recycle them.
+ */
+struct CRU_UI_API IVirtualListRowProvider : virtual Interface {
+  virtual Index GetRowCount() = 0;
+  // Rows are indented by depth times indent width. Used by trees.
+  virtual int GetRowDepth(Index index) = 0;
+  // Returned render object must have no parent.
+  virtual RenderObject* RealizeRow(Index index) = 0;
+  virtual void UnrealizeRow(Index index, RenderObject* render_object) = 0;
+};
+
+// Measure logic:
+// Only realized rows are measured, with width not specified. Height of rows
+// that have never been realized is estimated. Result width is the max of
+// rows measured since rows are invalidated, and result height is sum of all row
+// heights.
+// Layout logic:
+// Rows intersecting the viewport (plus some overscan) are realized and laid out
+// vertically. Viewport is the view rect of parent if parent is a
+// ScrollRenderObject. Otherwise all rows are realized. Rows are realized when
+// viewport changes and before measure, so layout only realizes rows when it
+// resizes the viewport.
+class CRU_UI_API VirtualListRenderObject : public RenderObject {
+ private:
+  constexpr static auto kLogTag = "cru::ui::render::VirtualListRenderObject";
+
+ public:
+  static constexpr auto kRenderObjectName = "VirtualListRenderObject";
+
+  VirtualListRenderObject();
+  ~VirtualListRenderObject() override;
+
+  IVirtualListRowProvider* GetRowProvider() { return row_provider_; }
+  void SetRowProvider(IVirtualListRowProvider* provider);
+
+  float GetEstimatedRowHeight() { return estimated_row_height_; }
+  void SetEstimatedRowHeight(float height);
+
+  float GetIndentWidth() { return indent_width_; }
+  void SetIndentWidth(float width);
+
+  /**
+   * Call it when rows are added, removed or changed. All rows are unrealized
+   * and measured heights are forgotten. Cost is O(row count) on next layout.
+   */
+  void InvalidateRows();
+
+  /**
+   * Call it when viewport changes, i.e. scroll offset of parent changes. If
+   * some rows to show are not realized yet, they are realized and a relayout
+   * is scheduled. Otherwise nothing needs to be done other than a repaint.
+   */
+  void OnViewportChanged();
+
+  Index GetRealizedRowStart() { return realized_start_; }
+  Index GetRealizedRowCount() {
+    return static_cast<Index>(realized_rows_.size());
+  }
+
+  // Return nullptr if the row is not realized.
+  RenderObject* GetRealizedRow(Index index);
+
+  // Top of the row relative to content rect.
+  float GetRowTop(Index index);
+  // Measured height, or estimated height if the row was never realized.
+  float GetRowHeight(Index index);
+  // Index of the row at \p y, which is relative to content rect. Return row
+  // count if it is beyond the last row.
+  Index GetRowIndexAt(float y);
+
+  RenderObject* HitTest(const Point& point) override;
+  Rect GetHitTestBounds() override;
+
+ protected:
+  Size OnMeasureContent(const MeasureRequirement& requirement) override;
+  void OnLayoutContent(const Rect& content_rect) override;
+  void OnDraw(RenderObjectDrawContext& context) override;
+
+ private:
+  // Visible part relative to content rect.
+  Rect GetViewport();
+  Range CalculateRowRange(float overscan_ratio);
+  void EnsureRows();
+  void RealizeRows(const Range& range);
+  void UnrealizeAllRows();
+  MeasureRequirement GetRowMeasureRequirement();
+  void SetRowWidth(Index index, float width);
+
+ private:
+  IVirtualListRowProvider* row_provider_ = nullptr;
+
+  float estimated_row_height_ = 24.f;
+  float indent_width_ = 12.f;
+
+  bool rows_valid_ = false;
+  PrefixSumTree<float> row_heights_;
+
+  // Measured width with indent, 0 if never measured.
+  std::vector<float> row_widths_;
+  float max_row_width_ = 0.f;
+
+  Index realized_start_ = 0;
+  std::vector<RenderObject*> realized_rows_;
+
+  // Measured size is stale after realizing rows in layout, but layout can't be
+  // invalidated in layout. Rare as rows are usually realized before measure.
+  platform::gui::TimerAutoCanceler relayout_canceler_;
+};
+}  // namespace cru::ui::render
@@ -24,7 +24,7 @@ ColorPropertyEditor::ColorPropertyEditor() {
   color_text_.SetMargin(ui::Thickness(10, 0, 0, 0));
 
   color_text_.TextChangeEvent()->AddHandler([this](std::nullptr_t) {
-    auto text = color_text_.GetTextView();
+    auto text = color_text_.GetText();
     auto color = ui::Color::Parse(text);
     if (color) {
       color_ = *color;
@@ -3,11 +3,11 @@
 namespace cru::theme_builder::components::properties {
 TextPropertyEditor::TextPropertyEditor() {
   editor_.TextChangeEvent()->AddHandler([this](std::nullptr_t) {
-    auto text_view = editor_.GetTextView();
+    auto text = editor_.GetText();
     std::string error_message;
-    auto validation_result = Validate(text_view, &error_message);
+    auto validation_result = Validate(text, &error_message);
     if (validation_result) {
-      OnTextChanged(text_view);
+      OnTextChanged(text);
     }
   });
 }
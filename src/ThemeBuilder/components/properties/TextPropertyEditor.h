@@ -15,7 +15,6 @@ class TextPropertyEditor : public ui::components::Component,
   ui::controls::Control* GetRootControl() override { return &container_; }
 
   std::string GetText() { return editor_.GetText(); }
-  std::string_view GetTextView() { return editor_.GetTextView(); }
   void SetText(std::string text) { editor_.SetText(std::move(text)); }
 
  protected:
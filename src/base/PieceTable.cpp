@@ -0,0 +1,247 @@
+#include "cru/base/PieceTable.h"
+
+namespace cru {
+void PieceTable::Buffer::Append(std::string_view str) {
+  auto start = static_cast<Index>(text.size());
+  text.append(str);
+  for (Index i = 0; i < static_cast<Index>(str.size()); i++) {
+    if (str[i] == '\n') newlines.push_back(start + i);
+  }
+}
+
+Index PieceTable::Buffer::CountNewlines(Index start, Index length) const {
+  return std::lower_bound(newlines.cbegin(), newlines.cend(), start + length) -
+         std::lower_bound(newlines.cbegin(), newlines.cend(), start);
+}
+
+PieceTable::PieceTable() = default;
+
+PieceTable::PieceTable(std::string text) { SetText(std::move(text)); }
+
+PieceTable::PieceTable(PieceTable&& other) noexcept = default;
+PieceTable& PieceTable::operator=(PieceTable&& other) noexcept = default;
+
+PieceTable::~PieceTable() = default;
+
+Index PieceTable::GetLineStart(Index line) const {
+  CheckArgumentRange(line, 0, GetLineCount(), "line");
+  if (line == 0) return 0;
+
+  // Find the line th line feed.
+  auto n = line;
+  Index base = 0;
+  auto node = root_.get();
+  while (node) {
+    const auto left_newline_count = GetNewlineCount(node->left.get());
+    if (n <= left_newline_count) {
+      node = node->left.get();
+      continue;
+    }
+    n -= left_newline_count;
+    base += GetLength(node->left.get());
+
+    const auto& piece = node->piece;
+    if (n <= piece.newline_count) {
+      const auto& newlines = GetBuffer(piece.buffer).newlines;
+      auto iter =
+          std::lower_bound(newlines.cbegin(), newlines.cend(), piece.start);
+      return base + (*(iter + (n - 1)) - piece.start) + 1;
+    }
+    n -= piece.newline_count;
+    base += piece.length;
+    node = node->right.get();
+  }
+
+  UnreachableCode();
+}
+
+Index PieceTable::GetLineIndex(Index position) const {
+  CheckArgumentRange(position, 0, GetSize(), "position", true);
+
+  Index result = 0;
+  auto node = root_.get();
+  while (node) {
+    const auto left_length = GetLength(node->left.get());
+    if (position <= left_length) {
+      node = node->left.get();
+      continue;
+    }
+    result += GetNewlineCount(node->left.get());
+    position -= left_length;
+
+    const auto& piece = node->piece;
+    if (position <= piece.length) {
+      return result +
+             GetBuffer(piece.buffer).CountNewlines(piece.start, position);
+    }
+    result += piece.newline_count;
+    position -= piece.length;
+    node = node->right.get();
+  }
+  return result;
+}
+
+char PieceTable::At(Index position) const {
+  CheckArgumentRange(position, 0, GetSize(), "position");
+
+  auto node = root_.get();
+  while (true) {
+    const auto left_length = GetLength(node->left.get());
+    if (position < left_length) {
+      node = node->left.get();
+      continue;
+    }
+    position -= left_length;
+    if (position < node->piece.length) {
+      return GetBuffer(node->piece.buffer).text[node->piece.start + position];
+    }
+    position -= node->piece.length;
+    node = node->right.get();
+  }
+}
+
+void PieceTable::SetText(std::string text) {
+  root_.reset();
+  add_buffer_ = {};
+  original_buffer_ = {};
+  original_buffer_.Append(text);
+  if (!original_buffer_.text.empty()) {
+    root_ = NewNode(MakePiece(kOriginal, 0, original_buffer_.text.size()));
+  }
+}
+
+void PieceTable::Insert(Index position, std::string_view text) {
+  CheckArgumentRange(position, 0, GetSize(), "position", true);
+  if (text.empty()) return;
+
+  const auto add_start = static_cast<Index>(add_buffer_.text.size());
+  add_buffer_.Append(text);
+  const auto piece = MakePiece(kAdd, add_start, text.size());
+
+  if (position != 0 && TryGrowPiece(root_.get(), position, add_start, piece)) {
+    return;
+  }
+
+  auto [left, right] = Split(std::move(root_), position);
+  root_ = Merge(Merge(std::move(left), NewNode(piece)), std::move(right));
+}
+
+void PieceTable::Erase(Index position, Index count) {
+  CheckArgumentRange(position, 0, GetSize(), "position", true);
+  CheckArgumentRange(count, 0, GetSize() - position, "count", true);
+  if (count == 0) return;
+
+  auto [left, rest] = Split(std::move(root_), position);
+  auto [middle, right] = Split(std::move(rest), count);
+  root_ = Merge(std::move(left), std::move(right));
+}
+
+std::string PieceTable::Substring(Index position, Index count) const {
+  std::string result;
+  result.reserve(count);
+  ForEachChunk(position, count,
+               [&result](std::string_view chunk) { result.append(chunk); });
+  return result;
+}
+
+void PieceTable::Update(Node* node) {
+  node->length = GetLength(node->left.get()) + node->piece.length +
+                 GetLength(node->right.get());
+  node->newline_count = GetNewlineCount(node->left.get()) +
+                        node->piece.newline_count +
+                        GetNewlineCount(node->right.get());
+}
+
+PieceTable::Piece PieceTable::MakePiece(BufferKind buffer, Index start,
+                                        Index length) const {
+  return Piece{buffer, start, length,
+               GetBuffer(buffer).CountNewlines(start, length)};
+}
+
+std::unique_ptr<PieceTable::Node> PieceTable::NewNode(const Piece& piece) {
+  // xorshift32
+  random_state_ ^= random_state_ << 13;
+  random_state_ ^= random_state_ >> 17;
+  random_state_ ^= random_state_ << 5;
+
+  auto node = std::make_unique<Node>();
+  node->piece = piece;
+  node->priority = random_state_;
+  Update(node.get());
+  return node;
+}
+
+std::pair<std::unique_ptr<PieceTable::Node>, std::unique_ptr<PieceTable::Node>>
+PieceTable::Split(std::unique_ptr<Node> node, Index position) {
+  if (node == nullptr) return {};
+
+  const auto left_length = GetLength(node->left.get());
+  const auto piece_end = left_length + node->piece.length;
+
+  if (position <= left_length) {
+    auto [left, right] = Split(std::move(node->left), position);
+    node->left = std::move(right);
+    Update(node.get());
+    return {std::move(left), std::move(node)};
+  }
+
+  if (position >= piece_end) {
+    auto [left, right] = Split(std::move(node->right), position - piece_end);
+    node->right = std::move(left);
+    Update(node.get());
+    return {std::move(node), std::move(right)};
+  }
+
+  // Split inside the piece.
+  const auto piece = node->piece;
+  const auto offset = position - left_length;
+  node->piece = MakePiece(piece.buffer, piece.start, offset);
+  auto right = Merge(NewNode(MakePiece(piece.buffer, piece.start + offset,
+                                       piece.length - offset)),
+                     std::move(node->right));
+  Update(node.get());
+  return {std::move(node), std::move(right)};
+}
+
+std::unique_ptr<PieceTable::Node> PieceTable::Merge(
+    std::unique_ptr<Node> left, std::unique_ptr<Node> right) {
+  if (left == nullptr) return right;
+  if (right == nullptr) return left;
+
+  if (left->priority > right->priority) {
+    left->right = Merge(std::move(left->right), std::move(right));
+    Update(left.get());
+    return left;
+  } else {
+    right->left = Merge(std::move(left), std::move(right->left));
+    Update(right.get());
+    return right;
+  }
+}
+
+bool PieceTable::TryGrowPiece(Node* node, Index position, Index add_start,
+                              const Piece& piece) {
+  if (node == nullptr) return false;
+
+  const auto left_length = GetLength(node->left.get());
+  const auto piece_end = left_length + node->piece.length;
+
+  bool result;
+  if (position <= left_length) {
+    result = TryGrowPiece(node->left.get(), position, add_start, piece);
+  } else if (position > piece_end) {
+    result =
+        TryGrowPiece(node->right.get(), position - piece_end, add_start, piece);
+  } else if (position == piece_end && node->piece.buffer == kAdd &&
+             node->piece.start + node->piece.length == add_start) {
+    node->piece.length += piece.length;
+    node->piece.newline_count += piece.newline_count;
+    result = true;
+  } else {
+    result = false;
+  }
+
+  if (result) Update(node);
+  return result;
+}
+}  // namespace cru
@@ -3,21 +3,32 @@
 
 #include <unicode/uchar.h>
 #include <unicode/unistr.h>
+#include <unicode/utext.h>
 
+#include <algorithm>
 #include <string_view>
 #include <utility>
 
 namespace cru::string {
 
-bool CaseInsensitiveEqual(std::string_view left, std::string_view right) {
-  auto icu_left = icu::UnicodeString::fromUTF8(left).foldCase();
-  auto icu_right = icu::UnicodeString::fromUTF8(right).foldCase();
-  return icu_left == icu_right;
+namespace {
+bool IsAscii(char c) { return static_cast<unsigned char>(c) < 0x80; }
+
+// Same as u_isspace for ASCII.
+bool IsAsciiSpace(char c) {
+  return (c >= 0x09 && c <= 0x0D) || (c >= 0x1C && c <= 0x20);
 }
 
-static Index FindFirstNonSpace(std::string_view str) {
+char AsciiToLower(char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c; }
+
+Index FindFirstNonSpace(std::string_view str) {
   Index pos = 0;
   while (pos < str.size()) {
+    if (IsAscii(str[pos])) {
+      if (!IsAsciiSpace(str[pos])) return pos;
+      pos++;
+      continue;
+    }
     Index next = pos;
     auto c = Utf8NextCodePoint(str.data(), str.size(), pos, &next);
     if (!u_isspace(c)) return pos;
@@ -26,49 +37,83 @@ static Index FindFirstNonSpace(std::string_view str) {
   return str.size();
 }
 
-static Index FindLastNonSpace(std::string_view str) {
+Index FindLastNonSpace(std::string_view str) {
   Index pos = str.size();
   while (pos > 0) {
+    if (IsAscii(str[pos - 1])) {
+      if (!IsAsciiSpace(str[pos - 1])) return pos;
+      pos--;
+      continue;
+    }
     Index previous = pos;
     auto c = Utf8PreviousCodePoint(str.data(), str.size(), pos, &pos);
     if (!u_isspace(c)) return previous;
   }
   return 0;
 }
+}  // namespace
+
+bool CaseInsensitiveEqual(std::string_view left, std::string_view right) {
+  Index i = 0;
+  const auto min_size = std::min(left.size(), right.size());
+  for (; i < min_size; i++) {
+    if (!IsAscii(left[i]) || !IsAscii(right[i])) break;
+    if (AsciiToLower(left[i]) != AsciiToLower(right[i])) return false;
+  }
+  // Folding never makes non-empty text empty.
+  if (i == min_size) return left.size() == right.size();
+
+  // Case folding works on each code point, so the equal prefix can be skipped.
+  auto icu_left = icu::UnicodeString::fromUTF8(left.substr(i)).foldCase();
+  auto icu_right = icu::UnicodeString::fromUTF8(right.substr(i)).foldCase();
+  return icu_left == icu_right;
+}
 
 std::string TrimBegin(std::string_view str) {
-  auto first = FindFirstNonSpace(str);
-  return std::string(str.data() + first, str.size() - first);
+  return std::string(TrimBeginView(str));
 }
 
 std::string TrimEnd(std::string_view str) {
-  auto last = FindLastNonSpace(str);
-  return std::string(str.data(), last);
+  return std::string(TrimEndView(str));
+}
+
+std::string Trim(std::string_view str) { return std::string(TrimView(str)); }
+
+std::string_view TrimBeginView(std::string_view str) {
+  return str.substr(FindFirstNonSpace(str));
 }
 
-std::string Trim(std::string_view str) {
+std::string_view TrimEndView(std::string_view str) {
+  return str.substr(0, FindLastNonSpace(str));
+}
+
+std::string_view TrimView(std::string_view str) {
   auto first = FindFirstNonSpace(str);
+  if (first == str.size()) return {};
   auto last = FindLastNonSpace(str);
-  if (first >= last) return {};
-  return std::string(str.data() + first, last - first);
+  return str.substr(first, last - first);
 }
 
 bool IsSpace(std::string_view str) {
-  for (auto c : Utf8CodePointIterator(str.data(), str.size())) {
-    if (!u_isspace(c)) return false;
-  }
-  return true;
+  return FindFirstNonSpace(str) == str.size();
 }
 
 std::vector<std::string> Split(std::string_view str, std::string_view sep,
                                SplitOption options) {
+  auto views = SplitView(str, sep, options);
+  return std::vector<std::string>(views.cbegin(), views.cend());
+}
+
+std::vector<std::string_view> SplitView(std::string_view str,
+                                        std::string_view sep,
+                                        SplitOption options) {
   using size_type = std::string_view::size_type;
 
   if (sep.empty()) throw std::invalid_argument("Sep can't be empty.");
   if (str.empty()) return {};
 
   size_type current_pos = 0;
-  std::vector<std::string> result;
+  std::vector<std::string_view> result;
 
   while (current_pos != std::string_view::npos) {
     if (current_pos == str.size()) {
@@ -84,14 +129,13 @@ std::vector<std::string> Split(std::string_view str, std::string_view sep,
                                            : next_pos - current_pos);
     if (!(options.Has(SplitOptions::RemoveEmpty) && sub.empty() ||
           options.Has(SplitOptions::RemoveSpace) && IsSpace(sub))) {
-      std::string trimmed_sub(sub);
       if (options.Has(SplitOptions::TrimBegin)) {
-        trimmed_sub = TrimBegin(trimmed_sub);
+        sub = TrimBeginView(sub);
       }
       if (options.Has(SplitOptions::TrimEnd)) {
-        trimmed_sub = TrimEnd(trimmed_sub);
+        sub = TrimEndView(sub);
       }
-      result.push_back(trimmed_sub);
+      result.push_back(sub);
     }
     current_pos = next_pos == std::string_view::npos ? std::string_view::npos
                                                      : next_pos + sep.size();
@@ -289,61 +333,10 @@ bool Utf16IsValidInsertPosition(const Utf16CodeUnit* ptr, Index size,
   return !IsUtf16SurrogatePairTrailing(ptr[position]);
 }
 
-template <typename CharType,
-          NextCodePointFunctionType<CharType> NextCodePointFunction>
-static Index IndexCodeUnitToCodePoint(const CharType* ptr, Index size,
-                                      Index position) {
-  CodePointIterator<CharType, NextCodePointFunction> iter(ptr, size);
-  Index result = 0;
-  while (!iter.IsPastEnd() && iter.GetPosition() < position) {
-    ++iter;
-    ++result;
-  }
-  return result;
-}
-
-template <typename CharType,
-          NextCodePointFunctionType<CharType> NextCodePointFunction>
-static Index IndexCodePointToCodeUnit(const CharType* ptr, Index size,
-                                      Index position) {
-  CodePointIterator<CharType, NextCodePointFunction> iter(ptr, size);
-  for (Index i = 0; i < position; i++) {
-    ++iter;
-  }
-  return iter.GetPosition();
-}
-
-Index Utf8IndexCodeUnitToCodePoint(const Utf8CodeUnit* ptr, Index size,
-                                   Index position) {
-  return IndexCodeUnitToCodePoint<Utf8CodeUnit, Utf8NextCodePoint>(ptr, size,
-                                                                   position);
-}
-
-Index Utf8IndexCodePointToCodeUnit(const Utf8CodeUnit* ptr, Index size,
-                                   Index position) {
-  return IndexCodePointToCodeUnit<Utf8CodeUnit, Utf8NextCodePoint>(ptr, size,
-                                                                   position);
-}
-
-Index Utf16IndexCodeUnitToCodePoint(const Utf16CodeUnit* ptr, Index size,
-                                    Index position) {
-  return IndexCodeUnitToCodePoint<Utf16CodeUnit, Utf16NextCodePoint>(ptr, size,
-                                                                     position);
-}
-Index Utf16IndexCodePointToCodeUnit(const Utf16CodeUnit* ptr, Index size,
-                                    Index position) {
-  return IndexCodePointToCodeUnit<Utf16CodeUnit, Utf16NextCodePoint>(ptr, size,
-                                                                     position);
-}
-
 #ifdef _WIN32
 std::wstring ToUtf16WString(std::string_view str) {
-  Utf8CodePointIterator iter(str.data(), str.size());
-  std::wstring result;
-  for (auto c : iter) {
-    Utf16EncodeCodePointAppend(c, [&result](char16_t c) { result += c; });
-  }
-  return result;
+  auto result = Utf8ToUtf16(str);
+  return std::wstring(result.cbegin(), result.cend());
 }
 
 std::string ToUtf8String(std::wstring_view str) {
@@ -358,8 +351,7 @@ std::string ToUtf8String(std::wstring_view str) {
 
 #endif
 
-StringBreakIterator::StringBreakIterator(std::string str)
-    : utf8_position_(0), utf16_position_(0) {
+StringBreakIterator::StringBreakIterator(std::string str) : position_(0) {
   UErrorCode error_code = U_ZERO_ERROR;
   character_break_iterator_.reset(icu::BreakIterator::createCharacterInstance(
       icu::Locale::getDefault(), error_code));
@@ -382,79 +374,91 @@ StringBreakIterator::StringBreakIterator(std::string str)
   SetText(std::move(str));
 }
 
+StringBreakIterator::~StringBreakIterator() = default;
+
 void StringBreakIterator::SetText(std::string str) {
   str_ = std::move(str);
-  icu_str_ = icu::UnicodeString::fromUTF8(str_);
-  utf8_position_ = 0;
-  utf16_position_ = 0;
-  character_break_iterator_->setText(icu_str_);
-  word_break_iterator_->setText(icu_str_);
-  line_break_iterator_->setText(icu_str_);
+  position_ = 0;
+  ResetIteratorText();
+}
+
+void StringBreakIterator::Replace(Index position, Index count,
+                                  std::string_view text) {
+  CheckArgumentRange(position, 0, str_.size(), "position", true);
+  CheckArgumentRange(count, 0, str_.size() - position, "count", true);
+  str_.replace(position, count, text);
+  position_ = position + static_cast<Index>(text.size());
+  // Storage may be reallocated. Cached boundaries are dropped too.
+  ResetIteratorText();
 }
 
 void StringBreakIterator::SetCurrentPosition(Index position) {
   CheckArgumentRange(position, 0, str_.size(), "position", true);
-  utf8_position_ = position;
-  utf16_position_ = Utf16IndexCodePointToCodeUnit(
-      icu_str_.getBuffer(), icu_str_.length(),
-      Utf8IndexCodeUnitToCodePoint(str_, position));
+  position_ = position;
 }
 
 Index StringBreakIterator::NextChar() {
-  if (utf8_position_ >= str_.size()) {
-    return utf8_position_;
+  if (position_ >= str_.size()) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(
-      character_break_iterator_->following(utf16_position_));
-  return utf8_position_;
+  position_ = character_break_iterator_->following(position_);
+  return position_;
 }
 
 Index StringBreakIterator::PreviousChar() {
-  if (utf8_position_ <= 0) {
-    return utf8_position_;
+  if (position_ <= 0) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(
-      character_break_iterator_->preceding(utf16_position_));
-  return utf8_position_;
+  position_ = character_break_iterator_->preceding(position_);
+  return position_;
 }
 
 Index StringBreakIterator::NextWord() {
-  if (utf8_position_ >= str_.size()) {
-    return utf8_position_;
+  if (position_ >= str_.size()) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(word_break_iterator_->following(utf16_position_));
-  return utf8_position_;
+  position_ = word_break_iterator_->following(position_);
+  return position_;
 }
 
 Index StringBreakIterator::PreviousWord() {
-  if (utf8_position_ <= 0) {
-    return utf8_position_;
+  if (position_ <= 0) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(word_break_iterator_->preceding(utf16_position_));
-  return utf8_position_;
+  position_ = word_break_iterator_->preceding(position_);
+  return position_;
 }
 
 Index StringBreakIterator::NextLine() {
-  if (utf8_position_ >= str_.size()) {
-    return utf8_position_;
+  if (position_ >= str_.size()) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(line_break_iterator_->following(utf16_position_));
-  return utf8_position_;
+  position_ = line_break_iterator_->following(position_);
+  return position_;
 }
 
 Index StringBreakIterator::PreviousLine() {
-  if (utf8_position_ <= 0) {
-    return utf8_position_;
+  if (position_ <= 0) {
+    return position_;
   }
-  SetCurrentPositionByUtf16(line_break_iterator_->preceding(utf16_position_));
-  return utf8_position_;
+  position_ = line_break_iterator_->preceding(position_);
+  return position_;
 }
 
-void StringBreakIterator::SetCurrentPositionByUtf16(Index position) {
-  utf8_position_ = Utf8IndexCodePointToCodeUnit(
-      str_, Utf16IndexCodeUnitToCodePoint(icu_str_.getBuffer(),
-                                          icu_str_.length(), position));
-  utf16_position_ = position;
+void StringBreakIterator::ResetIteratorText() {
+  // Break iterators make shallow clones of the UText, which refer to str_ with
+  // UTF-8 indexes as native indexes.
+  UErrorCode error_code = U_ZERO_ERROR;
+  UText text = UTEXT_INITIALIZER;
+  utext_openUTF8(&text, str_.data(), static_cast<int64_t>(str_.size()),
+                 &error_code);
+  character_break_iterator_->setText(&text, error_code);
+  word_break_iterator_->setText(&text, error_code);
+  line_break_iterator_->setText(&text, error_code);
+  utext_close(&text);
+  if (U_FAILURE(error_code)) {
+    throw Exception("Failed to set text of break iterator.");
+  }
 }
 
 }  // namespace cru::string
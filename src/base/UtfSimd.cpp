@@ -0,0 +1,632 @@
+#include "cru/base/StringUtil.h"
+#include "cru/base/Base.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define CRU_UTF_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRU_TARGET_SSE2
+#define CRU_TARGET_AVX2
+#else
+#define CRU_TARGET_SSE2 __attribute__((target("sse2")))
+#define CRU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace cru::string {
+namespace {
+using Byte = std::uint8_t;
+
+bool IsUtf8NonContinuationByte(Utf8CodeUnit c) {
+  return static_cast<signed char>(c) > -65;
+}
+
+bool IsUtf16Trailing(Utf16CodeUnit c) { return (c & 0xFC00) == 0xDC00; }
+
+// Index of the n th set bit of mask.
+int FindNthSetBit(std::uint32_t mask, Index n) {
+  for (; n > 0; n--) mask &= mask - 1;
+  return std::countr_zero(mask);
+}
+
+// Validate code points starting at position until reaching end. Returns the
+// position after the last code point or -1 if invalid.
+Index ValidateUtf8Scalar(const Byte* ptr, Index size, Index position,
+                         Index end) {
+  while (position < end) {
+    const auto c = ptr[position];
+    if (c < 0x80) {
+      position++;
+      continue;
+    }
+
+    Index length;
+    Byte min = 0x80, max = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      length = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      length = 3;
+      if (c == 0xE0) min = 0xA0;  // overlong
+      if (c == 0xED) max = 0x9F;  // surrogate
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      length = 4;
+      if (c == 0xF0) min = 0x90;  // overlong
+      if (c == 0xF4) max = 0x8F;  // over U+10FFFF
+    } else {
+      return -1;
+    }
+
+    if (size - position < length) return -1;
+    if (ptr[position + 1] < min || ptr[position + 1] > max) return -1;
+    for (Index i = 2; i < length; i++) {
+      if ((ptr[position + i] & 0xC0) != 0x80) return -1;
+    }
+    position += length;
+  }
+  return position;
+}
+
+struct UtfKernels {
+  bool (*utf8_is_valid)(const Byte* ptr, Index size);
+  // Count of non-continuation bytes.
+  Index (*utf8_count)(const Utf8CodeUnit* ptr, Index size);
+  // Position of the n th non-continuation byte, or size if not found.
+  Index (*utf8_find)(const Utf8CodeUnit* ptr, Index size, Index n);
+  Index (*utf16_count)(const Utf16CodeUnit* ptr, Index size);
+  // Position of the n th code point, or size if not found.
+  Index (*utf16_find)(const Utf16CodeUnit* ptr, Index size, Index n);
+  Index (*ascii_prefix)(const Utf8CodeUnit* ptr, Index size);
+  void (*widen_ascii)(const Utf8CodeUnit* ptr, Index size,
+                      Utf16CodeUnit* output);
+};
+
+namespace scalar {
+bool Utf8IsValid(const Byte* ptr, Index size) {
+  return ValidateUtf8Scalar(ptr, size, 0, size) != -1;
+}
+
+Index Utf8Count(const Utf8CodeUnit* ptr, Index size) {
+  Index result = 0;
+  for (Index i = 0; i < size; i++) {
+    result += IsUtf8NonContinuationByte(ptr[i]);
+  }
+  return result;
+}
+
+Index Utf8Find(const Utf8CodeUnit* ptr, Index size, Index n) {
+  for (Index i = 0; i < size; i++) {
+    if (IsUtf8NonContinuationByte(ptr[i]) && n-- == 0) return i;
+  }
+  return size;
+}
+
+Index Utf16Count(const Utf16CodeUnit* ptr, Index size) {
+  Index result = size;
+  for (Index i = 0; i < size; i++) {
+    result -= IsUtf16Trailing(ptr[i]);
+  }
+  return result;
+}
+
+Index Utf16Find(const Utf16CodeUnit* ptr, Index size, Index n) {
+  for (Index i = 0; i < size; i++) {
+    if (!IsUtf16Trailing(ptr[i]) && n-- == 0) return i;
+  }
+  return size;
+}
+
+Index AsciiPrefix(const Utf8CodeUnit* ptr, Index size) {
+  Index i = 0;
+  while (i < size && static_cast<Byte>(ptr[i]) < 0x80) i++;
+  return i;
+}
+
+void WidenAscii(const Utf8CodeUnit* ptr, Index size, Utf16CodeUnit* output) {
+  for (Index i = 0; i < size; i++) {
+    output[i] = static_cast<Utf16CodeUnit>(ptr[i]);
+  }
+}
+
+constexpr UtfKernels kKernels{Utf8IsValid, Utf8Count,   Utf8Find,  Utf16Count,
+                              Utf16Find,   AsciiPrefix, WidenAscii};
+}  // namespace scalar
+
+#ifdef CRU_UTF_SIMD_X86
+namespace sse2 {
+CRU_TARGET_SSE2 std::uint32_t Utf8NonContinuationMask(const Utf8CodeUnit* ptr) {
+  const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65)));
+}
+
+// Two bits for each code unit that is not a trailing surrogate.
+CRU_TARGET_SSE2 std::uint32_t Utf16NonTrailingMask(const Utf16CodeUnit* ptr) {
+  const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  const auto trailing = _mm_cmpeq_epi16(
+      _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFC00))),
+      _mm_set1_epi16(static_cast<short>(0xDC00)));
+  return ~static_cast<std::uint32_t>(_mm_movemask_epi8(trailing)) & 0xFFFF;
+}
+
+CRU_TARGET_SSE2 std::uint32_t AsciiMask(const Utf8CodeUnit* ptr) {
+  return _mm_movemask_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+// Skip ASCII blocks and validate the rest with scalar code.
+CRU_TARGET_SSE2 bool Utf8IsValid(const Byte* ptr, Index size) {
+  Index i = 0;
+  while (i + 16 <= size) {
+    if (AsciiMask(reinterpret_cast<const Utf8CodeUnit*>(ptr + i)) == 0) {
+      i += 16;
+    } else {
+      i = ValidateUtf8Scalar(ptr, size, i, i + 16);
+      if (i == -1) return false;
+    }
+  }
+  return ValidateUtf8Scalar(ptr, size, i, size) != -1;
+}
+
+CRU_TARGET_SSE2 Index Utf8Count(const Utf8CodeUnit* ptr, Index size) {
+  Index result = 0, i = 0;
+  for (; i + 16 <= size; i += 16) {
+    result += std::popcount(Utf8NonContinuationMask(ptr + i));
+  }
+  return result + scalar::Utf8Count(ptr + i, size - i);
+}
+
+CRU_TARGET_SSE2 Index Utf8Find(const Utf8CodeUnit* ptr, Index size, Index n) {
+  Index i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const auto mask = Utf8NonContinuationMask(ptr + i);
+    const auto count = std::popcount(mask);
+    if (n < count) return i + FindNthSetBit(mask, n);
+    n -= count;
+  }
+  return i + scalar::Utf8Find(ptr + i, size - i, n);
+}
+
+CRU_TARGET_SSE2 Index Utf16Count(const Utf16CodeUnit* ptr, Index size) {
+  Index result = 0, i = 0;
+  for (; i + 8 <= size; i += 8) {
+    result += std::popcount(Utf16NonTrailingMask(ptr + i)) / 2;
+  }
+  return result + scalar::Utf16Count(ptr + i, size - i);
+}
+
+CRU_TARGET_SSE2 Index Utf16Find(const Utf16CodeUnit* ptr, Index size,
+                                Index n) {
+  Index i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const auto mask = Utf16NonTrailingMask(ptr + i) & 0x5555;
+    const auto count = std::popcount(mask);
+    if (n < count) return i + FindNthSetBit(mask, n) / 2;
+    n -= count;
+  }
+  return i + scalar::Utf16Find(ptr + i, size - i, n);
+}
+
+CRU_TARGET_SSE2 Index AsciiPrefix(const Utf8CodeUnit* ptr, Index size) {
+  Index i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const auto mask = AsciiMask(ptr + i);
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+  return i + scalar::AsciiPrefix(ptr + i, size - i);
+}
+
+CRU_TARGET_SSE2 void WidenAscii(const Utf8CodeUnit* ptr, Index size,
+                                Utf16CodeUnit* output) {
+  Index i = 0;
+  const auto zero = _mm_setzero_si128();
+  for (; i + 16 <= size; i += 16) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 8),
+                     _mm_unpackhi_epi8(v, zero));
+  }
+  scalar::WidenAscii(ptr + i, size - i, output + i);
+}
+
+constexpr UtfKernels kKernels{Utf8IsValid, Utf8Count,   Utf8Find,  Utf16Count,
+                              Utf16Find,   AsciiPrefix, WidenAscii};
+}  // namespace sse2
+
+namespace avx2 {
+CRU_TARGET_AVX2 __m256i Load(const void* ptr) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+CRU_TARGET_AVX2 std::uint32_t Utf8NonContinuationMask(const Utf8CodeUnit* ptr) {
+  return _mm256_movemask_epi8(
+      _mm256_cmpgt_epi8(Load(ptr), _mm256_set1_epi8(-65)));
+}
+
+CRU_TARGET_AVX2 std::uint32_t Utf16NonTrailingMask(const Utf16CodeUnit* ptr) {
+  const auto trailing = _mm256_cmpeq_epi16(
+      _mm256_and_si256(Load(ptr),
+                       _mm256_set1_epi16(static_cast<short>(0xFC00))),
+      _mm256_set1_epi16(static_cast<short>(0xDC00)));
+  return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(trailing));
+}
+
+// Validation by looking up error bits of each byte pair from its high and low
+// nibbles, after "Validating UTF-8 In Less Than One Instruction Per Byte" by
+// John Keiser and Daniel Lemire.
+constexpr Byte kTooShort = 1 << 0;
+constexpr Byte kTooLong = 1 << 1;
+constexpr Byte kOverlong3 = 1 << 2;
+constexpr Byte kTooLarge = 1 << 3;
+constexpr Byte kSurrogate = 1 << 4;
+constexpr Byte kOverlong2 = 1 << 5;
+constexpr Byte kTooLarge1000 = 1 << 6;
+constexpr Byte kOverlong4 = 1 << 6;
+constexpr Byte kTwoContinuations = 1 << 7;
+constexpr Byte kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+// Indexed by high nibble of the first byte.
+alignas(16) constexpr Byte kByte1High[16] = {
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTwoContinuations,
+    kTwoContinuations,
+    kTwoContinuations,
+    kTwoContinuations,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+// Indexed by low nibble of the first byte.
+alignas(16) constexpr Byte kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// Indexed by high nibble of the second byte.
+alignas(16) constexpr Byte kByte2High[16] = {
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 |
+        kOverlong4,
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+};
+
+// Bytes that can't end a block because the code point they start is longer.
+alignas(32) constexpr Byte kIncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+CRU_TARGET_AVX2 __m256i LoadTable(const Byte (&table)[16]) {
+  return _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+CRU_TARGET_AVX2 __m256i HighNibbles(__m256i v) {
+  return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Bytes of input shifted right by N, with last N bytes of previous block.
+template <int N>
+CRU_TARGET_AVX2 __m256i Previous(__m256i input, __m256i previous) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+struct Utf8Validator {
+  __m256i byte1_high;
+  __m256i byte1_low;
+  __m256i byte2_high;
+  __m256i incomplete_max;
+  __m256i error;
+  __m256i previous_input;
+  __m256i previous_incomplete;
+
+  CRU_TARGET_AVX2 Utf8Validator()
+      : byte1_high(LoadTable(kByte1High)),
+        byte1_low(LoadTable(kByte1Low)),
+        byte2_high(LoadTable(kByte2High)),
+        incomplete_max(Load(kIncompleteMax)),
+        error(_mm256_setzero_si256()),
+        previous_input(_mm256_setzero_si256()),
+        previous_incomplete(_mm256_setzero_si256()) {}
+
+  CRU_TARGET_AVX2 void Next(__m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, previous_incomplete);
+      previous_input = input;
+      previous_incomplete = _mm256_setzero_si256();
+      return;
+    }
+
+    const auto previous1 = Previous<1>(input, previous_input);
+    const auto special_cases = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(byte1_high, HighNibbles(previous1)),
+            _mm256_shuffle_epi8(byte1_low, _mm256_and_si256(
+                                               previous1,
+                                               _mm256_set1_epi8(0x0F)))),
+        _mm256_shuffle_epi8(byte2_high, HighNibbles(input)));
+
+    // Third and fourth bytes must be continuation, which is allowed to be two
+    // continuations in a row.
+    const auto previous2 = Previous<2>(input, previous_input);
+    const auto previous3 = Previous<3>(input, previous_input);
+    const auto must_be_continuation = _mm256_and_si256(
+        _mm256_or_si256(_mm256_subs_epu8(previous2, _mm256_set1_epi8(0x60)),
+                        _mm256_subs_epu8(previous3, _mm256_set1_epi8(0x70))),
+        _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    error = _mm256_or_si256(
+        error, _mm256_xor_si256(must_be_continuation, special_cases));
+    previous_input = input;
+    previous_incomplete = _mm256_subs_epu8(input, incomplete_max);
+  }
+
+  CRU_TARGET_AVX2 bool Finish() {
+    error = _mm256_or_si256(error, previous_incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+  }
+};
+
+CRU_TARGET_AVX2 bool Utf8IsValid(const Byte* ptr, Index size) {
+  Utf8Validator validator;
+  Index i = 0;
+  for (; i + 32 <= size; i += 32) {
+    validator.Next(Load(ptr + i));
+  }
+  if (i < size) {
+    // Zeros are ASCII, so a truncated code point at the end is too short.
+    alignas(32) Byte tail[32] = {};
+    std::memcpy(tail, ptr + i, size - i);
+    validator.Next(Load(tail));
+  }
+  return validator.Finish();
+}
+
+CRU_TARGET_AVX2 Index Utf8Count(const Utf8CodeUnit* ptr, Index size) {
+  Index result = 0, i = 0;
+  for (; i + 32 <= size; i += 32) {
+    result += std::popcount(Utf8NonContinuationMask(ptr + i));
+  }
+  return result + sse2::Utf8Count(ptr + i, size - i);
+}
+
+CRU_TARGET_AVX2 Index Utf8Find(const Utf8CodeUnit* ptr, Index size, Index n) {
+  Index i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const auto mask = Utf8NonContinuationMask(ptr + i);
+    const auto count = std::popcount(mask);
+    if (n < count) return i + FindNthSetBit(mask, n);
+    n -= count;
+  }
+  return i + sse2::Utf8Find(ptr + i, size - i, n);
+}
+
+CRU_TARGET_AVX2 Index Utf16Count(const Utf16CodeUnit* ptr, Index size) {
+  Index result = 0, i = 0;
+  for (; i + 16 <= size; i += 16) {
+    result += std::popcount(Utf16NonTrailingMask(ptr + i)) / 2;
+  }
+  return result + sse2::Utf16Count(ptr + i, size - i);
+}
+
+CRU_TARGET_AVX2 Index Utf16Find(const Utf16CodeUnit* ptr, Index size,
+                                Index n) {
+  Index i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const auto mask = Utf16NonTrailingMask(ptr + i) & 0x55555555;
+    const auto count = std::popcount(mask);
+    if (n < count) return i + FindNthSetBit(mask, n) / 2;
+    n -= count;
+  }
+  return i + sse2::Utf16Find(ptr + i, size - i, n);
+}
+
+CRU_TARGET_AVX2 Index AsciiPrefix(const Utf8CodeUnit* ptr, Index size) {
+  Index i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const auto mask =
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(Load(ptr + i)));
+    if (mask != 0) return i + std::countr_zero(mask);
+  }
+  return i + sse2::AsciiPrefix(ptr + i, size - i);
+}
+
+CRU_TARGET_AVX2 void WidenAscii(const Utf8CodeUnit* ptr, Index size,
+                                Utf16CodeUnit* output) {
+  Index i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                        _mm256_cvtepu8_epi16(v));
+  }
+  scalar::WidenAscii(ptr + i, size - i, output + i);
+}
+
+constexpr UtfKernels kKernels{Utf8IsValid, Utf8Count,   Utf8Find,  Utf16Count,
+                              Utf16Find,   AsciiPrefix, WidenAscii};
+}  // namespace avx2
+#endif
+
+UtfSimdLevel DetectUtfSimdLevel() {
+#ifdef CRU_UTF_SIMD_X86
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  const auto max_leaf = info[0];
+  __cpuid(info, 1);
+  const bool sse2 = info[3] & (1 << 26);
+  // AVX2 needs OS to save YMM registers.
+  const bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                      (_xgetbv(0) & 0x6) == 0x6;
+  bool avx2 = false;
+  if (os_avx && max_leaf >= 7) {
+    __cpuidex(info, 7, 0);
+    avx2 = info[1] & (1 << 5);
+  }
+  if (avx2) return UtfSimdLevel::Avx2;
+  if (sse2) return UtfSimdLevel::Sse2;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return UtfSimdLevel::Avx2;
+  if (__builtin_cpu_supports("sse2")) return UtfSimdLevel::Sse2;
+#endif
+#endif
+  return UtfSimdLevel::Scalar;
+}
+
+const UtfKernels* GetKernelsOfLevel(UtfSimdLevel level) {
+  switch (level) {
+#ifdef CRU_UTF_SIMD_X86
+    case UtfSimdLevel::Avx2:
+      return &avx2::kKernels;
+    case UtfSimdLevel::Sse2:
+      return &sse2::kKernels;
+#endif
+    default:
+      return &scalar::kKernels;
+  }
+}
+
+UtfSimdLevel GetDetectedUtfSimdLevel() {
+  static const auto level = DetectUtfSimdLevel();
+  return level;
+}
+
+std::atomic<UtfSimdLevel>& CurrentLevel() {
+  static std::atomic<UtfSimdLevel> level{GetDetectedUtfSimdLevel()};
+  return level;
+}
+
+const UtfKernels& GetKernels() {
+  return *GetKernelsOfLevel(CurrentLevel().load(std::memory_order_relaxed));
+}
+
+const Byte* AsBytes(const Utf8CodeUnit* ptr) {
+  return reinterpret_cast<const Byte*>(ptr);
+}
+}  // namespace
+
+UtfSimdLevel GetUtfSimdLevel() {
+  return CurrentLevel().load(std::memory_order_relaxed);
+}
+
+void SetUtfSimdLevel(UtfSimdLevel level) {
+  CurrentLevel().store(std::min(level, GetDetectedUtfSimdLevel()),
+                       std::memory_order_relaxed);
+}
+
+bool Utf8IsValid(const Utf8CodeUnit* ptr, Index size) {
+  return GetKernels().utf8_is_valid(AsBytes(ptr), size);
+}
+
+Index Utf8CountCodePoints(const Utf8CodeUnit* ptr, Index size) {
+  return GetKernels().utf8_count(ptr, size);
+}
+
+Index Utf16CountCodePoints(const Utf16CodeUnit* ptr, Index size) {
+  return GetKernels().utf16_count(ptr, size);
+}
+
+std::u16string Utf8ToUtf16(Utf8StringView str) {
+  const auto& kernels = GetKernels();
+  const auto ptr = str.data();
+  const auto size = static_cast<Index>(str.size());
+  if (!kernels.utf8_is_valid(AsBytes(ptr), size)) {
+    throw TextEncodeException("Invalid UTF-8 text.");
+  }
+
+  // A code point never takes more UTF-16 code units than UTF-8 ones.
+  std::u16string result(size, u'\0');
+  auto output = result.data();
+  Index i = 0, o = 0;
+  while (i < size) {
+    const auto ascii_length = kernels.ascii_prefix(ptr + i, size - i);
+    kernels.widen_ascii(ptr + i, ascii_length, output + o);
+    i += ascii_length;
+    o += ascii_length;
+
+    while (i < size && static_cast<Byte>(ptr[i]) >= 0x80) {
+      Index next;
+      const auto code_point = Utf8NextCodePoint(ptr, size, i, &next);
+      i = next;
+      if (code_point >= 0x10000) {
+        output[o++] = static_cast<Utf16CodeUnit>(
+            0xD800 + ((code_point - 0x10000) >> 10));
+        output[o++] = static_cast<Utf16CodeUnit>(
+            0xDC00 + ((code_point - 0x10000) & 0x3FF));
+      } else {
+        output[o++] = static_cast<Utf16CodeUnit>(code_point);
+      }
+    }
+  }
+  result.resize(o);
+  return result;
+}
+
+// Positions in the middle of a code point count the code point, same as
+// stepping a code point iterator until reaching the position.
+Index Utf8IndexCodeUnitToCodePoint(const Utf8CodeUnit* ptr, Index size,
+                                   Index position) {
+  return GetKernels().utf8_count(ptr, std::clamp<Index>(position, 0, size));
+}
+
+Index Utf8IndexCodePointToCodeUnit(const Utf8CodeUnit* ptr, Index size,
+                                   Index position) {
+  return GetKernels().utf8_find(ptr, size, position);
+}
+
+Index Utf16IndexCodeUnitToCodePoint(const Utf16CodeUnit* ptr, Index size,
+                                    Index position) {
+  return GetKernels().utf16_count(ptr, std::clamp<Index>(position, 0, size));
+}
+
+Index Utf16IndexCodePointToCodeUnit(const Utf16CodeUnit* ptr, Index size,
+                                    Index position) {
+  return GetKernels().utf16_find(ptr, size, position);
+}
+}  // namespace cru::string
@@ -0,0 +1,97 @@
+#include "cru/base/io/MappedFileStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+#if (defined(__unix) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define CRU_MAPPED_FILE_MMAP
+#include "cru/base/platform/unix/UnixFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include "cru/base/io/CFileStream.h"
+#endif
+
+namespace cru::io {
+MappedFileStream::MappedFileStream(const char* path)
+    : Stream(true, true, false) {
+#ifdef CRU_MAPPED_FILE_MMAP
+  platform::unix::UnixFileDescriptor file(::open(path, O_RDONLY | O_CLOEXEC));
+  if (!file) {
+    throw ErrnoException(std::format("Failed to open file {}.", path));
+  }
+
+  struct stat file_stat;
+  if (::fstat(file, &file_stat) == -1) {
+    throw ErrnoException(std::format("Failed to stat file {}.", path));
+  }
+
+  // Mapping an empty file fails, and there is nothing to map anyway.
+  size_ = file_stat.st_size;
+  if (size_ > 0) {
+    auto address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    if (address == MAP_FAILED) {
+      throw ErrnoException(std::format("Failed to map file {}.", path));
+    }
+    ::posix_madvise(address, size_, POSIX_MADV_SEQUENTIAL);
+    data_ = static_cast<const std::byte*>(address);
+    mapped_ = true;
+  }
+  // The mapping stays valid after the descriptor is closed.
+#else
+  CFileStream file(path, "rb");
+  fallback_buffer_ = file.ReadToEnd();
+  data_ = fallback_buffer_.data();
+  size_ = fallback_buffer_.size();
+#endif
+}
+
+MappedFileStream::~MappedFileStream() { Release(); }
+
+Index MappedFileStream::DoSeek(Index offset, SeekOrigin origin) {
+  switch (origin) {
+    case SeekOrigin::Current:
+      position_ += offset;
+      break;
+    case SeekOrigin::Begin:
+      position_ = offset;
+      break;
+    case SeekOrigin::End:
+      position_ = size_ + offset;
+      break;
+  }
+  position_ = std::clamp<Index>(position_, 0, size_);
+  return position_;
+}
+
+Index MappedFileStream::DoRead(std::byte* buffer, Index offset, Index size) {
+  if (position_ == size_) {
+    return kEOF;
+  }
+
+  size = std::min(size, size_ - position_);
+  if (size <= 0) {
+    return 0;
+  }
+  std::memcpy(buffer + offset, data_ + position_, size);
+  position_ += size;
+  return size;
+}
+
+void MappedFileStream::DoClose() { Release(); }
+
+void MappedFileStream::Release() {
+#ifdef CRU_MAPPED_FILE_MMAP
+  if (mapped_) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+    mapped_ = false;
+  }
+#endif
+  fallback_buffer_ = {};
+  data_ = nullptr;
+  size_ = 0;
+}
+}  // namespace cru::io
@@ -1,8 +1,8 @@
 #include "cru/base/io/Stream.h"
 
+#include <algorithm>
 #include <atomic>
 #include <format>
-#include <ranges>
 #include <utility>
 
 namespace cru::io {
@@ -128,10 +128,16 @@ bool Stream::Close() {
 
 std::vector<std::byte> Stream::ReadToEnd(Index grow_size) {
   std::vector<std::byte> buffer;
+  // Size the buffer to the rest of the stream when it is known, one more byte
+  // to see EOF, so a whole file is read without any reallocation.
+  if (CanSeek()) {
+    buffer.resize(std::max<Index>(GetSize() - Tell(), 0) + 1);
+  }
+
   Index pos = 0;
   while (true) {
     if (pos == buffer.size()) {
-      buffer.resize(buffer.size() + grow_size);
+      buffer.resize(buffer.size() + std::max<Index>(grow_size, pos));
     }
 
     auto read = Read(buffer.data(), pos, buffer.size() - pos);
@@ -145,13 +151,9 @@ std::vector<std::byte> Stream::ReadToEnd(Index grow_size) {
 }
 
 std::string Stream::ReadToEndAsUtf8String() {
-  std::string result;
-  for (auto c : ReadToEnd() | std::views::transform([](std::byte c) {
-                  return static_cast<char>(c);
-                })) {
-    result.push_back(c);
-  }
-  return result;
+  auto buffer = ReadToEnd();
+  return std::string(reinterpret_cast<const char*>(buffer.data()),
+                     buffer.size());
 }
 
 void Stream::SetSupportedOperations(SupportedOperations supported_operations) {
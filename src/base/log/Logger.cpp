@@ -47,6 +47,13 @@ std::string GetLogTime() {
 }
 }  // namespace
 
+void ILogWriter::WriteBatch(std::span<const LogInfo> log_infos,
+                            std::span<const std::string> log_strs) {
+  for (std::size_t i = 0; i < log_infos.size(); i++) {
+    Write(log_infos[i], log_strs[i]);
+  }
+}
+
 std::string DefaultLogFormatter::Format(const LogInfo& log_info) {
   if (log_info.tag.empty()) {
     return std::format("[{}] {}: {}", GetLogTime(),
@@ -58,6 +65,49 @@ std::string DefaultLogFormatter::Format(const LogInfo& log_info) {
   }
 }
 
+LogTagTrie::LogTagTrie() : nodes_(1) {}
+
+int LogTagTrie::FindChild(int node, char c) const {
+  const auto& children = nodes_[node].children;
+  auto iter = std::ranges::lower_bound(
+      children, c, {}, [](const std::pair<char, int>& p) { return p.first; });
+  if (iter == children.end() || iter->first != c) return -1;
+  return iter->second;
+}
+
+void LogTagTrie::Add(std::string_view tag) {
+  int node = 0;
+  for (auto c : tag) {
+    auto child = FindChild(node, c);
+    if (child == -1) {
+      child = static_cast<int>(nodes_.size());
+      nodes_.emplace_back();
+      auto& children = nodes_[node].children;
+      children.insert(
+          std::ranges::lower_bound(
+              children, c, {},
+              [](const std::pair<char, int>& p) { return p.first; }),
+          {c, child});
+    }
+    node = child;
+  }
+  if (!nodes_[node].is_end) {
+    nodes_[node].is_end = true;
+    tag_count_++;
+  }
+}
+
+bool LogTagTrie::MatchPrefix(std::string_view tag) const {
+  if (IsEmpty()) return false;
+  int node = 0;
+  for (auto c : tag) {
+    if (nodes_[node].is_end) return true;
+    node = FindChild(node, c);
+    if (node == -1) return false;
+  }
+  return nodes_[node].is_end;
+}
+
 ILogger* ILogger::GetInstance() {
   static SynchronousLogger logger;
   static bool initialized = [] {
@@ -87,8 +137,8 @@ void ILogger::LoadDebugTagFromEnv(const char* env_var, std::string sep) {
 }
 
 LoggerConfigurationMixin::LoggerConfigurationMixin()
-    : config_(std::shared_ptr<LoggerConfig>(
-          new LoggerConfig{std::make_shared<DefaultLogFormatter>(), {}, {}})) {}
+    : config_(std::shared_ptr<LoggerConfig>(new LoggerConfig{
+          std::make_shared<DefaultLogFormatter>(), {}, {}, {}})) {}
 
 void LoggerConfigurationMixin::AddDebugTag(std::string tag) {
   UpdateConfig([&tag](LoggerConfig* config) {
@@ -120,6 +170,19 @@ void LoggerConfigurationMixin::RemoveWriter(ILogWriter* writer) {
   });
 }
 
+bool LoggerConfigurationMixin::LoggerConfig::IsEnabled(
+    LogLevel level, std::string_view tag) const {
+  if (level != LogLevel::Debug) return true;
+  return debug_tag_trie.MatchPrefix(tag);
+}
+
+bool LoggerConfigurationMixin::IsEnabled(LogLevel level,
+                                         std::string_view tag) {
+  if (level != LogLevel::Debug) return true;
+  if (!has_debug_tags_.load(std::memory_order_relaxed)) return false;
+  return GetConfigSnapshot()->IsEnabled(level, tag);
+}
+
 std::shared_ptr<LoggerConfigurationMixin::LoggerConfig>
 LoggerConfigurationMixin::GetConfigSnapshot() {
   std::lock_guard lock(config_mutex_);
@@ -129,11 +192,7 @@ LoggerConfigurationMixin::GetConfigSnapshot() {
 void SynchronousLogger::Log(LogInfo log_info) {
   auto config = GetConfigSnapshot();
 
-  if (log_info.level == LogLevel::Debug &&
-      std::ranges::none_of(config->debug_tags,
-                           [&log_info](const std::string& tag) {
-                             return log_info.tag.starts_with(tag);
-                           })) {
+  if (!config->IsEnabled(log_info.level, log_info.tag)) {
     return;
   }
   auto message = config->formatter->Format(log_info);
@@ -142,8 +201,26 @@ void SynchronousLogger::Log(LogInfo log_info) {
   }
 }
 
-AsynchronousLogger::AsynchronousLogger()
-    : log_stop_(false), log_thread_(&AsynchronousLogger::LogThreadRun, this) {}
+AsynchronousLogger::AsynchronousLogger(
+    Index capacity, AsynchronousLogOverflowPolicy overflow_policy,
+    int sample_interval)
+    : capacity_(capacity),
+      overflow_policy_(overflow_policy),
+      sample_interval_(sample_interval) {
+  if (capacity <= 0) {
+    throw Exception("Capacity of AsynchronousLogger must be positive.");
+  }
+  if (sample_interval <= 0) {
+    throw Exception("Sample interval of AsynchronousLogger must be positive.");
+  }
+
+  slots_.reset(new Slot[capacity]);
+  for (Index i = 0; i < capacity; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  log_thread_ = std::thread(&AsynchronousLogger::LogThreadRun, this);
+}
 
 AsynchronousLogger::~AsynchronousLogger() {
   {
@@ -155,45 +232,161 @@ AsynchronousLogger::~AsynchronousLogger() {
 }
 
 void AsynchronousLogger::Log(LogInfo log_info) {
+  // Drop filtered logs before they take a slot.
+  if (!IsEnabled(log_info.level, log_info.tag)) return;
+
+  if (!TryEnqueue(log_info)) {
+    auto block = false;
+    switch (overflow_policy_) {
+      case AsynchronousLogOverflowPolicy::Drop:
+        break;
+      case AsynchronousLogOverflowPolicy::Block:
+        block = true;
+        break;
+      case AsynchronousLogOverflowPolicy::Sample:
+        block = overflow_count_.fetch_add(1, std::memory_order_relaxed) %
+                    sample_interval_ ==
+                0;
+        break;
+      default:
+        std::unreachable();
+    }
+
+    if (!block) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    EnqueueBlocking(log_info);
+  }
+
+  enqueued_count_.fetch_add(1, std::memory_order_relaxed);
+
+  // Pairs with the store in LogThreadRun, so either the log thread sees the
+  // new log before sleeping or we see it waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (log_thread_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(mutex_);
+    condition_variable_.notify_one();
+  }
+}
+
+void AsynchronousLogger::Flush() {
+  auto target = enqueued_count_.load();
   std::unique_lock lock(mutex_);
-  log_queue_.push_back(std::move(log_info));
-  condition_variable_.notify_all();
+  condition_variable_.notify_one();
+  flush_condition_variable_.wait(lock, [this, target] {
+    return flushed_count_.load() >= target;
+  });
+}
+
+AsynchronousLoggerStatistics AsynchronousLogger::GetStatistics() const {
+  return {enqueued_count_.load(), dropped_count_.load(),
+          flushed_count_.load()};
+}
+
+// A bounded MPMC queue by Dmitry Vyukov, with only one consumer here.
+bool AsynchronousLogger::TryEnqueue(LogInfo& log_info) {
+  auto position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    auto& slot = slots_[position % capacity_];
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<std::int64_t>(sequence) -
+                static_cast<std::int64_t>(position);
+    if (diff == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        slot.log_info = std::move(log_info);
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // Full.
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void AsynchronousLogger::EnqueueBlocking(LogInfo& log_info) {
+  std::unique_lock lock(mutex_);
+  blocked_producer_count_.fetch_add(1, std::memory_order_relaxed);
+  // Pairs with the fence in LogThreadRun, so either the log thread sees us
+  // blocked after freeing slots or we see the freed slots.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  while (!TryEnqueue(log_info)) {
+    condition_variable_.notify_one();
+    space_condition_variable_.wait(lock);
+  }
+  blocked_producer_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool AsynchronousLogger::TryDequeue(LogInfo& log_info) {
+  auto& slot = slots_[dequeue_position_ % capacity_];
+  auto sequence = slot.sequence.load(std::memory_order_acquire);
+  if (sequence != dequeue_position_ + 1) return false;
+  log_info = std::move(slot.log_info);
+  slot.sequence.store(dequeue_position_ + capacity_, std::memory_order_release);
+  dequeue_position_++;
+  return true;
+}
+
+bool AsynchronousLogger::IsQueueEmpty() const {
+  const auto& slot = slots_[dequeue_position_ % capacity_];
+  return slot.sequence.load(std::memory_order_acquire) !=
+         dequeue_position_ + 1;
 }
 
 void AsynchronousLogger::LogThreadRun() {
-  std::list<LogInfo> queue;
-  bool stop = false;
+  std::vector<LogInfo> batch;
+  std::vector<std::string> log_strs;
+  batch.reserve(capacity_);
+  log_strs.reserve(capacity_);
 
   while (true) {
-    {
+    LogInfo log_info(LogLevel::Debug, {}, {});
+    while (static_cast<Index>(batch.size()) < capacity_ &&
+           TryDequeue(log_info)) {
+      batch.push_back(std::move(log_info));
+    }
+
+    if (batch.empty()) {
       std::unique_lock lock(mutex_);
+      if (log_stop_ && IsQueueEmpty()) return;
+      log_thread_waiting_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
       condition_variable_.wait(
-          lock, [this] { return !log_queue_.empty() || log_stop_; });
-      queue.swap(log_queue_);
-      stop = log_stop_;
+          lock, [this] { return !IsQueueEmpty() || log_stop_; });
+      log_thread_waiting_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    // Wake blocked producers as soon as slots are freed, not after writing.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (blocked_producer_count_.load(std::memory_order_relaxed) != 0) {
+      std::lock_guard lock(mutex_);
+      space_condition_variable_.notify_all();
     }
 
     auto config = GetConfigSnapshot();
+    for (const auto& info : batch) {
+      log_strs.push_back(config->formatter->Format(info));
+    }
     for (const auto& writer : config->writers) {
-      for (const auto& log_info : queue) {
-        if (log_info.level == LogLevel::Debug &&
-            std::ranges::none_of(config->debug_tags,
-                                 [&log_info](const std::string& tag) {
-                                   return log_info.tag.starts_with(tag);
-                                 })) {
-          continue;
-        }
-        writer->Write(log_info, config->formatter->Format(log_info));
-      }
+      writer->WriteBatch(batch, log_strs);
     }
-    queue.clear();
 
-    if (stop) return;
+    flushed_count_.fetch_add(batch.size());
+    batch.clear();
+    log_strs.clear();
+
+    std::lock_guard lock(mutex_);
+    flush_condition_variable_.notify_all();
   }
 }
 
 Guard MeasureTimeAndLog(std::string_view tag, std::string_view name) {
-  CruLogDebug(std::string(tag), "Start measure {}.", name);
+  CruLogDebug(tag, "Start measure {}.", name);
   auto start = std::chrono::high_resolution_clock::now();
 
   return Guard([tag = std::string(tag), name = std::string(name), start] {
@@ -4,24 +4,48 @@
 #include "cru/base/StringUtil.h"
 
 namespace cru::log {
-StdioLogWriter::StdioLogWriter() {}
-
-StdioLogWriter::~StdioLogWriter() {}
-
-void StdioLogWriter::Write(const LogInfo& log_info, std::string log_str) {
+namespace {
+// Error stream is unbuffered, so only output stream needs flushing.
+void WriteLine(const LogInfo& log_info, const std::string& log_str) {
 #ifdef _WIN32
   auto s = string::ToUtf16WString(log_str);
   if (log_info.level == log::LogLevel::Error) {
-    std::wcerr << s << std::endl;
+    std::wcerr << s << L'\n';
   } else {
-    std::wcout << s << std::endl;
+    std::wcout << s << L'\n';
   }
 #else
   if (log_info.level == log::LogLevel::Error) {
-    std::cerr << log_str << std::endl;
+    std::cerr << log_str << '\n';
   } else {
-    std::cout << log_str << std::endl;
+    std::cout << log_str << '\n';
   }
 #endif
 }
+
+void FlushOutput() {
+#ifdef _WIN32
+  std::wcout.flush();
+#else
+  std::cout.flush();
+#endif
+}
+}  // namespace
+
+StdioLogWriter::StdioLogWriter() {}
+
+StdioLogWriter::~StdioLogWriter() {}
+
+void StdioLogWriter::Write(const LogInfo& log_info, std::string log_str) {
+  WriteLine(log_info, log_str);
+  FlushOutput();
+}
+
+void StdioLogWriter::WriteBatch(std::span<const LogInfo> log_infos,
+                                std::span<const std::string> log_strs) {
+  for (std::size_t i = 0; i < log_infos.size(); i++) {
+    WriteLine(log_infos[i], log_strs[i]);
+  }
+  FlushOutput();
+}
 }  // namespace cru::log
@@ -3,63 +3,165 @@
 
 #include <poll.h>
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <thread>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
 namespace cru::platform::unix {
 int UnixTimerFile::GetReadFd() const { return this->read_fd_; }
 
-UnixEventLoop::UnixEventLoop() : polls_(1), poll_actions_(1) {
-  auto action_pipe = OpenUniDirectionalPipe(UnixPipeFlags::NonBlock);
-  action_pipe_read_end_ = std::move(action_pipe.read);
-  action_pipe_write_end_ = std::move(action_pipe.write);
-  polls_[0].fd = action_pipe_read_end_;
-  polls_[0].events = POLLIN;
-  poll_actions_[0] = [](auto _) {};
+namespace {
+#ifdef __linux__
+constexpr int kMaxEpollEvents = 64;
+
+std::uint32_t PollEventsToEpoll(UnixEventLoop::PollEvents events) {
+  std::uint32_t result = 0;
+  if (events & POLLIN) result |= EPOLLIN;
+  if (events & POLLPRI) result |= EPOLLPRI;
+  if (events & POLLOUT) result |= EPOLLOUT;
+  return result;
+}
+
+UnixEventLoop::PollRevents EpollToPollRevents(std::uint32_t events) {
+  UnixEventLoop::PollRevents result = 0;
+  if (events & EPOLLIN) result |= POLLIN;
+  if (events & EPOLLPRI) result |= POLLPRI;
+  if (events & EPOLLOUT) result |= POLLOUT;
+  if (events & EPOLLERR) result |= POLLERR;
+  if (events & EPOLLHUP) result |= POLLHUP;
+  return result;
+}
+#endif
+}  // namespace
+
+UnixEventLoop::UnixEventLoop(Backend backend) : backend_(backend) {
+#ifdef __linux__
+  wake_read_fd_ = UnixFileDescriptor(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  if (!wake_read_fd_) {
+    throw ErrnoException("Failed to create eventfd for event loop.");
+  }
+  // Both ends are the same eventfd, so only one of them closes it.
+  wake_write_fd_ = UnixFileDescriptor(wake_read_fd_.GetValue(), false);
+#else
+  auto wake_pipe = OpenUniDirectionalPipe(UnixPipeFlags::NonBlock);
+  wake_read_fd_ = std::move(wake_pipe.read);
+  wake_write_fd_ = std::move(wake_pipe.write);
+#endif
+
+  if (backend_ == Backend::Epoll) {
+#ifdef __linux__
+    epoll_fd_ = UnixFileDescriptor(::epoll_create1(EPOLL_CLOEXEC));
+    if (!epoll_fd_) {
+      throw ErrnoException("Failed to create epoll for event loop.");
+    }
+
+    timer_fd_ = UnixFileDescriptor(
+        ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+    if (!timer_fd_) {
+      throw ErrnoException("Failed to create timerfd for event loop.");
+    }
+
+    for (int fd : {wake_read_fd_.GetValue(), timer_fd_.GetValue()}) {
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.fd = fd;
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+        throw ErrnoException("Failed to add fd to epoll.");
+      }
+    }
+#else
+    throw Exception("Epoll backend is only available on linux.");
+#endif
+  } else {
+    pollfd wake_poll{};
+    wake_poll.fd = wake_read_fd_;
+    wake_poll.events = POLLIN;
+    polls_.push_back(wake_poll);
+  }
+}
+
+UnixEventLoop::~UnixEventLoop() = default;
+
+bool UnixEventLoop::IsInLoopThread() const {
+  return running_thread_ == std::this_thread::get_id();
+}
+
+void UnixEventLoop::Wake() {
+#ifdef __linux__
+  std::uint64_t value = 1;
+#else
+  char value = 0;
+#endif
+  // A full pipe or counter already means a pending wakeup.
+  wake_write_fd_.Write(&value, sizeof(value));
+}
+
+void UnixEventLoop::DrainWakeFd() {
+#ifdef __linux__
+  std::uint64_t value;
+  wake_read_fd_.Read(&value, sizeof(value));
+#else
+  char buffer[64];
+  while (wake_read_fd_.Read(buffer, sizeof(buffer)) > 0) {
+  }
+#endif
 }
 
 void UnixEventLoop::QueueAction(std::function<void()> action) {
-  if (std::this_thread::get_id() == running_thread_) {
+  if (IsInLoopThread()) {
     action();
-  } else {
-    auto pointer = new std::function<void()>(std::move(action));
-    action_pipe_write_end_.Write(&pointer, sizeof(decltype(pointer)));
+    return;
+  }
+
+  // The loop does not sleep while the queue is non-empty, so only the action
+  // that makes it non-empty has to wake it.
+  if (queued_actions_.Push(std::move(action)) == 0) {
+    Wake();
   }
 }
 
+void UnixEventLoop::SetMaxActionsPerRound(Index count) {
+  if (count <= 0) {
+    throw Exception("Max actions per round must be positive.");
+  }
+  max_actions_per_round_ = count;
+}
+
 int UnixEventLoop::Run() {
   running_thread_ = std::this_thread::get_id();
+  exit_code_ = std::nullopt;
 
   while (!exit_code_) {
-    int poll_timeout = -1;
-    Guard after_each_round_event_guard(
-        [this] { AfterEachRoundEvent_.Raise(nullptr); });
+    round_info_ = {};
+    Guard after_each_round_event_guard([this] {
+      round_info_.queued_action_count = queued_actions_.GetSize();
+      AfterEachRoundEvent_.Raise(round_info_);
+    });
 
-    if (CheckPoll()) {
-      continue;
-    }
-
-    auto now = std::chrono::steady_clock::now();
-    if (auto result = timer_registry_.Update(now)) {
-      result->data();
-      continue;
-    }
-
-    if (CheckActionPipe()) {
-      continue;
-    }
+    RunQueuedActions();
+    if (exit_code_) break;
 
-    if (auto next_timeout = timer_registry_.NextTimeout(now)) {
-      poll_timeout = next_timeout->count();
-    }
+    RunTimers();
+    if (exit_code_) break;
 
-    auto result = ::poll(polls_.data(), polls_.size(), poll_timeout);
-    if (result < 0) {
-      throw Exception("Failed to poll in event loop.");
-    }
+    // Don't sleep on actions left by the per-round cap.
+    auto timeout = queued_actions_.GetSize() > 0
+                       ? std::chrono::milliseconds::zero()
+                       : timer_registry_.NextTimeout(
+                             std::chrono::steady_clock::now());
+    Wait(timeout);
+    DispatchReadyPolls();
   }
 
+  running_thread_ = std::nullopt;
   return *exit_code_;
 }
 
@@ -69,81 +171,193 @@ void UnixEventLoop::RequestQuit(int exit_code) {
 
 int UnixEventLoop::SetTimer(std::function<void()> action,
                             std::chrono::milliseconds timeout, bool repeat) {
-  return timer_registry_.Add(std::move(action), timeout, repeat);
+  auto id = timer_registry_.Add(std::move(action), timeout, repeat);
+  // The loop may be sleeping with an older deadline.
+  if (!IsInLoopThread()) {
+    Wake();
+  }
+  return id;
 }
 
 void UnixEventLoop::CancelTimer(int id) { timer_registry_.Remove(id); }
 
-bool UnixEventLoop::CheckPoll() {
-  auto iter = std::ranges::find_if(
-      polls_, [](const pollfd& poll_fd) { return poll_fd.revents != 0; });
+void UnixEventLoop::RunQueuedActions() {
+  round_info_.action_count = queued_actions_.RunSome(max_actions_per_round_);
+}
 
-  if (iter == polls_.cend()) {
-    return false;
+void UnixEventLoop::RunTimers() {
+  auto now = std::chrono::steady_clock::now();
+  while (auto result = timer_registry_.Update(now)) {
+    result->data();
   }
+}
 
-  auto& revents = iter->revents;
-  if (revents != 0) {
-    poll_actions_[iter - polls_.cbegin()](revents);
-  }
-  revents = 0;
+void UnixEventLoop::Wait(std::optional<std::chrono::milliseconds> timeout) {
+  ready_polls_.clear();
 
-  return true;
-}
+  if (backend_ == Backend::Epoll) {
+#ifdef __linux__
+    int epoll_timeout = 0;
+    if (!timeout || timeout->count() > 0) {
+      ArmTimerFd(timeout);
+      epoll_timeout = -1;
+    }
 
-bool UnixEventLoop::CheckActionPipe() {
-  std::function<void()>* pointer;
-  constexpr size_t pointer_size = sizeof(decltype(pointer));
-  auto rest = pointer_size;
-  while (rest > 0) {
-    auto result = action_pipe_read_end_.Read(&pointer, rest);
+    epoll_event events[kMaxEpollEvents];
+    auto count =
+        ::epoll_wait(epoll_fd_, events, kMaxEpollEvents, epoll_timeout);
+    if (count < 0) {
+      if (errno == EINTR) return;
+      throw ErrnoException("Failed to wait epoll in event loop.");
+    }
 
-    if (result == -1) {  // If no data.
-      if (rest == pointer_size) {
-        return false;
+    for (int i = 0; i < count; i++) {
+      auto fd = events[i].data.fd;
+      if (fd == wake_read_fd_.GetValue()) {
+        DrainWakeFd();
+      } else if (fd == timer_fd_.GetValue()) {
+        std::uint64_t expirations;
+        timer_fd_.Read(&expirations, sizeof(expirations));
+        timer_fd_armed_ = false;
       } else {
-        continue;  // Try read again (might spin), as we are in the middle of
-                   // reading a pointer.
+        ready_polls_.emplace_back(fd, EpollToPollRevents(events[i].events));
       }
     }
+#endif
+  } else {
+    auto result = ::poll(polls_.data(), polls_.size(),
+                         timeout ? static_cast<int>(timeout->count()) : -1);
+    if (result < 0) {
+      if (errno == EINTR) return;
+      throw ErrnoException("Failed to poll in event loop.");
+    }
+
+    if (polls_[0].revents != 0) {
+      polls_[0].revents = 0;
+      DrainWakeFd();
+      result--;
+    }
+
+    for (auto iter = polls_.begin() + 1; result > 0 && iter != polls_.end();
+         ++iter) {
+      if (iter->revents != 0) {
+        ready_polls_.emplace_back(iter->fd, iter->revents);
+        iter->revents = 0;
+        result--;
+      }
+    }
+  }
+}
 
-    if (result == 0) {
-      throw Exception("Unexpected EOF of the timer pipe.");
+void UnixEventLoop::DispatchReadyPolls() {
+  for (auto [fd, revents] : ready_polls_) {
+    // A previous handler may have removed or replaced this one.
+    auto iter = poll_entries_.find(fd);
+    if (iter == poll_entries_.end()) {
+      continue;
     }
+    auto handler = iter->second.handler;
+    (*handler)(revents);
+  }
+  ready_polls_.clear();
+}
 
-    rest -= result;
+void UnixEventLoop::ArmTimerFd(
+    std::optional<std::chrono::milliseconds> timeout) {
+#ifdef __linux__
+  if (!timeout && !timer_fd_armed_) {
+    return;
   }
 
-  (*pointer)();
-  delete pointer;
+  // A zero itimerspec disarms the timer.
+  itimerspec spec{};
+  if (timeout) {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(*timeout);
+    spec.it_value.tv_sec = seconds.count();
+    spec.it_value.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(*timeout - seconds)
+            .count();
+  }
 
-  return true;
+  if (::timerfd_settime(timer_fd_, 0, &spec, nullptr) == -1) {
+    throw ErrnoException("Failed to set timerfd in event loop.");
+  }
+  timer_fd_armed_ = timeout.has_value();
+#else
+  CRU_UNUSED(timeout)
+#endif
 }
 
 void UnixEventLoop::SetPoll(int fd, PollEvents events, PollHandler action) {
-  for (auto& poll_fd : polls_) {
-    if (poll_fd.fd == fd) {
-      poll_fd.events = events;
+  auto handler = std::make_shared<PollHandler>(std::move(action));
+
+  auto iter = poll_entries_.find(fd);
+  if (iter != poll_entries_.end()) {
+    auto& entry = iter->second;
+    entry.handler = std::move(handler);
+    if (entry.events == events) {
       return;
     }
+    entry.events = events;
+
+    if (backend_ == Backend::Epoll) {
+#ifdef __linux__
+      epoll_event event{};
+      event.events = PollEventsToEpoll(events);
+      event.data.fd = fd;
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) == -1) {
+        throw ErrnoException("Failed to modify fd in epoll.");
+      }
+#endif
+    } else {
+      polls_[entry.index].events = events;
+    }
+    return;
   }
 
-  pollfd poll_fd;
-  poll_fd.fd = fd;
-  poll_fd.events = events;
-  poll_fd.revents = 0;
-  polls_.push_back(poll_fd);
-  poll_actions_.push_back(std::move(action));
+  Index index = 0;
+  if (backend_ == Backend::Epoll) {
+#ifdef __linux__
+    epoll_event event{};
+    event.events = PollEventsToEpoll(events);
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+      throw ErrnoException("Failed to add fd to epoll.");
+    }
+#endif
+  } else {
+    pollfd poll_fd{};
+    poll_fd.fd = fd;
+    poll_fd.events = events;
+    index = polls_.size();
+    polls_.push_back(poll_fd);
+  }
+
+  poll_entries_.emplace(fd, PollEntry{events, std::move(handler), index});
 }
 
 void UnixEventLoop::RemovePoll(int fd) {
-  auto iter = std::ranges::find_if(
-      polls_, [fd](const pollfd& poll_fd) { return poll_fd.fd == fd; });
-  if (iter != polls_.cend()) {
-    auto index = iter - polls_.cbegin();
-    polls_.erase(iter);
-    poll_actions_.erase(poll_actions_.cbegin() + index);
+  auto iter = poll_entries_.find(fd);
+  if (iter == poll_entries_.end()) {
+    return;
   }
+
+  if (backend_ == Backend::Epoll) {
+#ifdef __linux__
+    // The fd may already be closed, in which case epoll dropped it itself.
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+  } else {
+    // Swap with the last one to remove in O(1).
+    auto index = iter->second.index;
+    if (index != static_cast<Index>(polls_.size()) - 1) {
+      polls_[index] = polls_.back();
+      poll_entries_.at(polls_[index].fd).index = index;
+    }
+    polls_.pop_back();
+  }
+
+  poll_entries_.erase(iter);
 }
 
 }  // namespace cru::platform::unix
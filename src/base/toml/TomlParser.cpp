@@ -3,7 +3,11 @@
 #include "cru/base/toml/TomlDocument.h"
 
 namespace cru::toml {
-TomlParser::TomlParser(std::string input) : input_(std::move(input)) {}
+TomlParser::TomlParser(std::string input)
+    : owned_input_(std::move(input)), input_(owned_input_) {}
+
+TomlParser::TomlParser(std::span<const std::byte> input)
+    : input_(reinterpret_cast<const char*>(input.data()), input.size()) {}
 
 TomlParser::~TomlParser() = default;
 
@@ -18,13 +22,13 @@ TomlDocument TomlParser::Parse() {
 }
 
 void TomlParser::DoParse(TomlDocument& document) {
-  std::vector<std::string> lines =
-      cru::string::Split(input_, "\n", cru::string::SplitOptions::RemoveSpace);
+  auto lines = cru::string::SplitView(input_, "\n",
+                                      cru::string::SplitOptions::RemoveSpace |
+                                          cru::string::SplitOptions::Trim);
 
   std::string current_section_name;
 
-  for (auto& line : lines) {
-    line = cru::string::Trim(line);
+  for (auto line : lines) {
     if (line.starts_with("[") && line.ends_with("]")) {
       current_section_name = line.substr(1, line.size() - 2);
     } else if (line.starts_with("#")) {
@@ -32,14 +36,15 @@ void TomlParser::DoParse(TomlDocument& document) {
     } else {
       auto equal_index = line.find('=');
 
-      if (equal_index == std::string::npos) {
-        throw TomlParsingException("Invalid TOML line: " + line);
+      if (equal_index == std::string_view::npos) {
+        throw TomlParsingException("Invalid TOML line: " + std::string(line));
       }
 
-      auto key = cru::string::Trim(line.substr(0, equal_index));
-      auto value = cru::string::Trim(line.substr(equal_index + 1));
+      auto key = cru::string::TrimView(line.substr(0, equal_index));
+      auto value = cru::string::TrimView(line.substr(equal_index + 1));
 
-      document.GetSectionOrCreate(current_section_name)->SetValue(key, value);
+      document.GetSectionOrCreate(current_section_name)
+          ->SetValue(std::string(key), std::string(value));
     }
   }
 }
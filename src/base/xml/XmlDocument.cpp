@@ -0,0 +1,156 @@
+#include "cru/base/xml/XmlDocument.h"
+#include "cru/base/StringUtil.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace cru::xml {
+bool XmlNodeView::HasTag(std::string_view tag, bool case_sensitive) const {
+  return case_sensitive ? value_ == tag
+                        : cru::string::CaseInsensitiveEqual(value_, tag);
+}
+
+std::optional<std::string_view> XmlNodeView::GetOptionalAttributeValue(
+    std::string_view name) const {
+  for (const auto& attribute : attributes_) {
+    if (attribute.name == name) {
+      return attribute.value;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string_view>
+XmlNodeView::GetOptionalAttributeValueCaseInsensitive(
+    std::string_view name) const {
+  for (const auto& attribute : attributes_) {
+    if (cru::string::CaseInsensitiveEqual(attribute.name, name)) {
+      return attribute.value;
+    }
+  }
+  return std::nullopt;
+}
+
+const XmlNodeView* XmlNodeView::GetFirstChildElement() const {
+  for (auto child = first_child_; child; child = child->next_sibling_) {
+    if (child->IsElementNode()) {
+      return child;
+    }
+  }
+  return nullptr;
+}
+
+Index XmlNodeView::GetChildElementCount() const {
+  Index count = 0;
+  for (auto child = first_child_; child; child = child->next_sibling_) {
+    if (child->IsElementNode()) {
+      count++;
+    }
+  }
+  return count;
+}
+
+XmlNode* XmlNodeView::ToXmlNode() const {
+  switch (type_) {
+    case Type::Text:
+      return new XmlTextNode(std::string(value_));
+    case Type::Comment:
+      return new XmlCommentNode(std::string(value_));
+    case Type::Element: {
+      auto element = new XmlElementNode(std::string(value_));
+      for (const auto& attribute : attributes_) {
+        element->AddAttribute(std::string(attribute.name),
+                              std::string(attribute.value));
+      }
+      for (auto child = first_child_; child; child = child->next_sibling_) {
+        element->AddChild(child->ToXmlNode());
+      }
+      return element;
+    }
+    default:
+      std::unreachable();
+  }
+}
+
+XmlDocument::XmlDocument(std::string xml)
+    : owned_source_(std::move(xml)),
+      source_(owned_source_),
+      // Markup is usually denser than nodes, so the source size is a fair
+      // first guess that avoids most of the arena growth.
+      arena_(std::max<std::size_t>(source_.size(), 256)) {
+  Parse();
+}
+
+XmlDocument::XmlDocument(std::span<const std::byte> xml)
+    : source_(reinterpret_cast<const char*>(xml.data()), xml.size()),
+      arena_(std::max<std::size_t>(source_.size(), 256)) {
+  Parse();
+}
+
+void XmlDocument::Parse() {
+  ParseXml(source_, this);
+
+  if (root_ == nullptr) {
+    throw XmlParsingException("Expected 1 node as root.");
+  }
+}
+
+XmlDocument::~XmlDocument() = default;
+
+XmlNodeView* XmlDocument::AddNode(XmlNode::Type type, std::string_view value) {
+  if (current_ == nullptr && root_ != nullptr) {
+    throw XmlParsingException("Expected 1 node as root.");
+  }
+
+  // Nodes are trivially destructible, so the arena can drop them without
+  // running any destructor.
+  auto node = std::pmr::polymorphic_allocator<XmlNodeView>(&arena_)
+                  .allocate(1);
+  node = new (node) XmlNodeView(type, value);
+
+  if (current_ == nullptr) {
+    root_ = node;
+    return node;
+  }
+
+  node->parent_ = current_;
+  if (current_->last_child_) {
+    current_->last_child_->next_sibling_ = node;
+  } else {
+    current_->first_child_ = node;
+  }
+  current_->last_child_ = node;
+  current_->child_count_++;
+  return node;
+}
+
+void XmlDocument::OnStartElement(std::string_view tag,
+                                 std::span<const XmlAttributeView> attributes) {
+  auto node = AddNode(XmlNode::Type::Element, tag);
+
+  if (!attributes.empty()) {
+    auto buffer = std::pmr::polymorphic_allocator<XmlAttributeView>(&arena_)
+                      .allocate(attributes.size());
+    std::ranges::uninitialized_copy(
+        attributes, std::span<XmlAttributeView>(buffer, attributes.size()));
+    node->attributes_ = {buffer, attributes.size()};
+  }
+
+  current_ = node;
+}
+
+void XmlDocument::OnEndElement(std::string_view tag) {
+  CRU_UNUSED(tag)
+  current_ = current_->parent_;
+}
+
+void XmlDocument::OnText(std::string_view text) {
+  AddNode(XmlNode::Type::Text, text);
+}
+
+void XmlDocument::OnComment(std::string_view text) {
+  AddNode(XmlNode::Type::Comment, text);
+}
+}  // namespace cru::xml
@@ -2,196 +2,230 @@
 #include "cru/base/StringUtil.h"
 #include "cru/base/xml/XmlNode.h"
 
-namespace cru::xml {
-XmlParser::XmlParser(std::string xml) : xml_(std::move(xml)) {}
-
-XmlParser::~XmlParser() { delete pseudo_root_node_; }
+#include <vector>
 
-XmlElementNode* XmlParser::Parse() {
-  if (!cache_) {
-    cache_ = DoParse();
-  }
-  return static_cast<XmlElementNode*>(cache_->Clone());
+namespace cru::xml {
+namespace {
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
 }
 
-char16_t XmlParser::Read1() {
-  if (current_position_ >= xml_.size()) {
-    throw XmlParsingException("Unexpected end of xml");
-  }
-  return xml_[current_position_++];
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
 }
 
-std::string XmlParser::ReadWithoutAdvance(int count) {
-  if (current_position_ + count > xml_.size()) {
-    count = xml_.size() - current_position_;
-  }
-  return xml_.substr(current_position_, count);
-}
+class XmlReader {
+ public:
+  XmlReader(std::string_view xml, IXmlSaxHandler* handler)
+      : xml_(xml), handler_(handler) {}
 
-void XmlParser::ReadSpacesAndDiscard() {
-  while (current_position_ < xml_.size() &&
-         (xml_[current_position_] == ' ' || xml_[current_position_] == '\t' ||
-          xml_[current_position_] == '\n' || xml_[current_position_] == '\r')) {
-    ++current_position_;
-  }
-}
+  void Read() {
+    while (true) {
+      SkipSpaces();
 
-std::string XmlParser::ReadSpaces() {
-  std::string spaces;
-  while (current_position_ < xml_.size() &&
-         (xml_[current_position_] == ' ' || xml_[current_position_] == '\t' ||
-          xml_[current_position_] == '\n' || xml_[current_position_] == '\r')) {
-    spaces += xml_[current_position_];
-    ++current_position_;
-  }
-  return spaces;
-}
+      if (position_ == xml_.size()) {
+        break;
+      }
 
-std::string XmlParser::ReadIdenitifier() {
-  std::string identifier;
-  while (current_position_ < xml_.size() &&
-         (xml_[current_position_] >= 'a' && xml_[current_position_] <= 'z' ||
-          xml_[current_position_] >= 'A' && xml_[current_position_] <= 'Z' ||
-          xml_[current_position_] >= '0' && xml_[current_position_] <= '9' ||
-          xml_[current_position_] == '_')) {
-    identifier += xml_[current_position_];
-    ++current_position_;
-  }
-  return identifier;
-}
+      if (xml_[position_] != '<') {
+        ReadText();
+      } else if (xml_.substr(position_ + 1).starts_with('/')) {
+        position_ += 2;
+        ReadEndTag();
+      } else if (xml_.substr(position_ + 1).starts_with("!--")) {
+        position_ += 4;
+        ReadComment();
+      } else {
+        position_ += 1;
+        ReadStartTag();
+      }
+    }
 
-std::string XmlParser::ReadAttributeString() {
-  if (Read1() != '"') {
-    throw XmlParsingException("Expected \".");
+    if (!open_tags_.empty()) {
+      throw XmlParsingException("Unexpected end of xml");
+    }
   }
 
-  std::string string;
-
-  while (true) {
-    char16_t c = Read1();
-
-    if (c == '"') {
-      break;
+ private:
+  void SkipSpaces() {
+    while (position_ < xml_.size() && IsSpace(xml_[position_])) {
+      ++position_;
     }
-
-    string += c;
   }
 
-  return string;
-}
-
-XmlElementNode* XmlParser::DoParse() {
-  while (current_position_ < xml_.size()) {
-    ReadSpacesAndDiscard();
-
-    if (current_position_ == xml_.size()) {
-      break;
+  std::string_view ReadIdentifier() {
+    auto start = position_;
+    while (position_ < xml_.size() && IsIdentifierChar(xml_[position_])) {
+      ++position_;
     }
+    return xml_.substr(start, position_ - start);
+  }
 
-    if (ReadWithoutAdvance() == "<") {
-      current_position_ += 1;
-
-      if (ReadWithoutAdvance() == "/") {
-        current_position_ += 1;
-
-        ReadSpacesAndDiscard();
-
-        std::string tag = ReadIdenitifier();
-
-        if (tag != current_->GetTag()) {
-          throw XmlParsingException("Tag mismatch.");
-        }
-
-        ReadSpacesAndDiscard();
-
-        if (Read1() != '>') {
-          throw XmlParsingException("Expected >.");
-        }
-
-        current_ = current_->GetParent();
-      } else if (ReadWithoutAdvance(3) == "!--") {
-        current_position_ += 3;
+  void Expect(char c, const char* message) {
+    if (position_ == xml_.size()) {
+      throw XmlParsingException("Unexpected end of xml");
+    }
+    if (xml_[position_++] != c) {
+      throw XmlParsingException(message);
+    }
+  }
 
-        std::string text;
-        while (true) {
-          auto str = ReadWithoutAdvance(3);
-          if (str == "-->") break;
-          if (str.empty()) throw XmlParsingException("Unexpected end of xml");
-          text += Read1();
-        }
+  /** Return the slice until terminator and skip the terminator. */
+  std::string_view ReadUntil(std::string_view terminator) {
+    auto end = xml_.find(terminator, position_);
+    if (end == std::string_view::npos) {
+      throw XmlParsingException("Unexpected end of xml");
+    }
+    auto result = xml_.substr(position_, end - position_);
+    position_ = end + terminator.size();
+    return result;
+  }
 
-        current_position_ += 3;
-        current_->AddChild(new XmlCommentNode(cru::string::Trim(text)));
-      } else {
-        ReadSpacesAndDiscard();
+  void ReadText() {
+    auto end = xml_.find('<', position_);
+    if (end == std::string_view::npos) {
+      throw XmlParsingException("Unexpected end of xml");
+    }
+    auto text = xml_.substr(position_, end - position_);
+    position_ = end;
+    handler_->OnText(cru::string::TrimEndView(text));
+  }
 
-        std::string tag = ReadIdenitifier();
+  void ReadComment() {
+    handler_->OnComment(cru::string::TrimView(ReadUntil("-->")));
+  }
 
-        XmlElementNode* node = new XmlElementNode(tag);
+  void ReadEndTag() {
+    SkipSpaces();
+    auto tag = ReadIdentifier();
+    if (open_tags_.empty() || open_tags_.back() != tag) {
+      throw XmlParsingException("Tag mismatch.");
+    }
+    SkipSpaces();
+    Expect('>', "Expected >.");
+    open_tags_.pop_back();
+    handler_->OnEndElement(tag);
+  }
 
-        bool is_self_closing = false;
+  void ReadStartTag() {
+    SkipSpaces();
+    auto tag = ReadIdentifier();
+
+    attributes_.clear();
+    bool is_self_closing = false;
+
+    while (true) {
+      SkipSpaces();
+      if (xml_.substr(position_).starts_with('>')) {
+        position_ += 1;
+        break;
+      } else if (xml_.substr(position_).starts_with('/')) {
+        position_ += 1;
+        Expect('>', "Expected >.");
+        is_self_closing = true;
+        break;
+      }
 
-        while (true) {
-          ReadSpacesAndDiscard();
-          auto c = ReadWithoutAdvance();
-          if (c == ">") {
-            current_position_ += 1;
-            break;
-          } else if (c == "/") {
-            current_position_ += 1;
+      auto name = ReadIdentifier();
+      SkipSpaces();
+      Expect('=', "Expected '='");
+      SkipSpaces();
+      Expect('"', "Expected \".");
+      attributes_.push_back({name, ReadUntil("\"")});
+    }
 
-            if (Read1() != '>') {
-              throw XmlParsingException("Expected >.");
-            }
+    handler_->OnStartElement(tag, attributes_);
 
-            is_self_closing = true;
-            break;
-          } else {
-            std::string attribute_name = ReadIdenitifier();
+    if (is_self_closing) {
+      handler_->OnEndElement(tag);
+    } else {
+      open_tags_.push_back(tag);
+    }
+  }
 
-            ReadSpacesAndDiscard();
+ private:
+  std::string_view xml_;
+  IXmlSaxHandler* handler_;
+  std::size_t position_ = 0;
+  std::vector<std::string_view> open_tags_;
+  // Reused by every element to avoid an allocation per tag.
+  std::vector<XmlAttributeView> attributes_;
+};
+
+class XmlTreeBuilder : public IXmlSaxHandler {
+ public:
+  ~XmlTreeBuilder() override {
+    for (auto node : top_level_nodes_) {
+      delete node;
+    }
+  }
 
-            if (Read1() != '=') {
-              throw XmlParsingException("Expected '='");
-            }
+  void OnStartElement(std::string_view tag,
+                      std::span<const XmlAttributeView> attributes) override {
+    auto node = new XmlElementNode(std::string(tag));
+    for (const auto& attribute : attributes) {
+      node->AddAttribute(std::string(attribute.name),
+                         std::string(attribute.value));
+    }
+    AddNode(node);
+    current_ = node;
+  }
 
-            ReadSpacesAndDiscard();
+  void OnEndElement(std::string_view tag) override {
+    CRU_UNUSED(tag)
+    current_ = current_->GetParent();
+  }
 
-            std::string attribute_value = ReadAttributeString();
+  void OnText(std::string_view text) override {
+    AddNode(new XmlTextNode(std::string(text)));
+  }
 
-            node->AddAttribute(attribute_name, attribute_value);
-          }
-        }
+  void OnComment(std::string_view text) override {
+    AddNode(new XmlCommentNode(std::string(text)));
+  }
 
-        current_->AddChild(node);
+  XmlElementNode* TakeRoot() {
+    if (top_level_nodes_.size() != 1) {
+      throw XmlParsingException("Expected 1 node as root.");
+    }
 
-        if (!is_self_closing) {
-          current_ = node;
-        }
-      }
+    auto root = top_level_nodes_.front();
+    top_level_nodes_.clear();
+    return static_cast<XmlElementNode*>(root);
+  }
 
+ private:
+  void AddNode(XmlNode* node) {
+    if (current_) {
+      current_->AddChild(node);
     } else {
-      std::string text;
+      top_level_nodes_.push_back(node);
+    }
+  }
 
-      while (ReadWithoutAdvance() != "<") {
-        char16_t c = Read1();
+ private:
+  std::vector<XmlNode*> top_level_nodes_;
+  XmlElementNode* current_ = nullptr;
+};
+}  // namespace
 
-        text += c;
-      }
+void ParseXml(std::string_view xml, IXmlSaxHandler* handler) {
+  Expects(handler);
+  XmlReader(xml, handler).Read();
+}
 
-      if (!text.empty())
-        current_->AddChild(new XmlTextNode(cru::string::TrimEnd(text)));
-    }
-  }
+XmlParser::XmlParser(std::string xml)
+    : owned_xml_(std::move(xml)), xml_(owned_xml_) {}
 
-  if (current_ != pseudo_root_node_) {
-    throw XmlParsingException("Unexpected end of xml");
-  }
+XmlParser::XmlParser(std::span<const std::byte> xml)
+    : xml_(reinterpret_cast<const char*>(xml.data()), xml.size()) {}
 
-  if (pseudo_root_node_->GetChildren().size() != 1) {
-    throw XmlParsingException("Expected 1 node as root.");
-  }
+XmlParser::~XmlParser() = default;
 
-  return static_cast<XmlElementNode*>(pseudo_root_node_->GetChildren()[0]);
+XmlElementNode* XmlParser::Parse() {
+  XmlTreeBuilder builder;
+  ParseXml(xml_, &builder);
+  return builder.TakeRoot();
 }
 }  // namespace cru::xml
@@ -0,0 +1,23 @@
+#include "cru/platform/graphics/Factory.h"
+
+#include <limits>
+
+namespace cru::platform::graphics {
+TextMeasure IGraphicsFactory::MeasureText(std::shared_ptr<IFont> font,
+                                          std::string_view text) {
+  auto text_layout = CreateTextLayout(std::move(font), std::string(text));
+  text_layout->SetMaxWidth(std::numeric_limits<float>::max());
+  auto max_content_size = text_layout->GetTextBounds().GetRightBottom();
+  text_layout->SetMaxWidth(0);
+  auto min_content_size = text_layout->GetTextBounds().GetRightBottom();
+  return {min_content_size.x, max_content_size.x, max_content_size.y};
+}
+
+Size IGraphicsFactory::MeasureTextForWidth(std::shared_ptr<IFont> font,
+                                           std::string_view text,
+                                           float max_width) {
+  auto text_layout = CreateTextLayout(std::move(font), std::string(text));
+  text_layout->SetMaxWidth(max_width);
+  return Size(text_layout->GetTextBounds().GetRightBottom());
+}
+}  // namespace cru::platform::graphics
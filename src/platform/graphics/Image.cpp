@@ -4,6 +4,8 @@
 #include "cru/platform/graphics/ImageFactory.h"
 #include "cru/platform/graphics/Painter.h"
 
+#include "cru/base/io/MemoryStream.h"
+
 namespace cru::platform::graphics {
 std::unique_ptr<IImage> IImage::CloneToBitmap() {
   auto image = GetGraphicsFactory()->GetImageFactory()->CreateBitmap(
@@ -12,4 +14,12 @@ std::unique_ptr<IImage> IImage::CloneToBitmap() {
   painter->DrawImage(Point{}, this);
   return image;
 }
+
+std::unique_ptr<IImage> IImageFactory::DecodeFromMemory(
+    std::span<const std::byte> data) {
+  // The stream is read only, so it never writes through the pointer.
+  io::MemoryStream stream(const_cast<std::byte*>(data.data()), data.size(),
+                          true);
+  return DecodeFromStream(&stream);
+}
 }  // namespace cru::platform::graphics
@@ -6,12 +6,18 @@
 #include "cru/platform/graphics/cairo/PangoFont.h"
 #include "cru/platform/graphics/cairo/PangoTextLayout.h"
 
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+
 namespace cru::platform::graphics::cairo {
 CairoGraphicsFactory::CairoGraphicsFactory() : CairoResource(this) {
   default_cairo_surface_ =
       cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 100, 100);
   default_cairo_ = cairo_create(default_cairo_surface_);
-  default_pango_context_ = pango_context_new();
+  default_pango_context_ = pango_cairo_create_context(default_cairo_);
+  text_layout_cache_ =
+      std::make_unique<PangoTextLayoutCache>(default_pango_context_);
 
   image_factory_ = std::make_unique<CairoImageFactory>(this);
 }
@@ -44,6 +50,53 @@ std::unique_ptr<ITextLayout> CairoGraphicsFactory::CreateTextLayout(
   return text_layout;
 }
 
+namespace {
+// Split like PangoTextLayout, so carriage return before line feed is dropped.
+template <typename F>
+void ForEachParagraph(std::string_view text, F&& f) {
+  while (true) {
+    auto line_feed = text.find('\n');
+    if (line_feed == std::string_view::npos) {
+      f(text);
+      break;
+    }
+    auto paragraph = text.substr(0, line_feed);
+    if (paragraph.ends_with('\r')) paragraph.remove_suffix(1);
+    f(paragraph);
+    text.remove_prefix(line_feed + 1);
+  }
+}
+}  // namespace
+
+TextMeasure CairoGraphicsFactory::MeasureText(std::shared_ptr<IFont> font,
+                                              std::string_view text) {
+  auto pango_font = CheckPlatform<PangoFont>(font.get(), GetPlatformId());
+  TextMeasure result{};
+  ForEachParagraph(text, [&](std::string_view paragraph) {
+    auto unwrapped = text_layout_cache_->Get(paragraph, pango_font, -1);
+    auto wrapped = text_layout_cache_->Get(paragraph, pango_font, 0);
+    result.min_content_width =
+        std::max(result.min_content_width, wrapped->width);
+    result.max_content_width =
+        std::max(result.max_content_width, unwrapped->width);
+    result.max_content_height += unwrapped->height;
+  });
+  return result;
+}
+
+Size CairoGraphicsFactory::MeasureTextForWidth(std::shared_ptr<IFont> font,
+                                               std::string_view text,
+                                               float max_width) {
+  auto pango_font = CheckPlatform<PangoFont>(font.get(), GetPlatformId());
+  Size result;
+  ForEachParagraph(text, [&](std::string_view paragraph) {
+    auto shaped = text_layout_cache_->Get(paragraph, pango_font, max_width);
+    result.width = std::max(result.width, shaped->width);
+    result.height += shaped->height;
+  });
+  return result;
+}
+
 IImageFactory* CairoGraphicsFactory::GetImageFactory() {
   return image_factory_.get();
 }
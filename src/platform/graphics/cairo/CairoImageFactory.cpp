@@ -2,7 +2,10 @@
 #include "cru/platform/graphics/cairo/Base.h"
 #include "cru/platform/graphics/cairo/CairoImage.h"
 
+#include <cru/base/io/MappedFileStream.h>
+
 #include <png.h>
+#include <cstring>
 #include <memory>
 
 namespace cru::platform::graphics::cairo {
@@ -35,8 +38,29 @@ std::uint32_t ConvertPngPixelToCairo(std::uint32_t source) {
   return result;
 }
 
+struct PngMemoryReader {
+  std::span<const std::byte> data;
+  std::size_t position = 0;
+};
+
+void ReadPngFromStream(png_structp png_ptr, png_bytep data,
+                       png_size_t length) {
+  auto stream = static_cast<io::Stream*>(png_get_io_ptr(png_ptr));
+  stream->Read(reinterpret_cast<std::byte*>(data), length);
+}
+
+void ReadPngFromMemory(png_structp png_ptr, png_bytep data,
+                       png_size_t length) {
+  auto reader = static_cast<PngMemoryReader*>(png_get_io_ptr(png_ptr));
+  if (length > reader->data.size() - reader->position) {
+    png_error(png_ptr, "Unexpected end of png data.");
+  }
+  std::memcpy(data, reader->data.data() + reader->position, length);
+  reader->position += length;
+}
+
 std::unique_ptr<CairoImage> DecodePng(CairoGraphicsFactory* factory,
-                                      io::Stream* stream) {
+                                      png_voidp io_ptr, png_rw_ptr read_fn) {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
   png_uint_32 width = 0;
@@ -65,12 +89,7 @@ std::unique_ptr<CairoImage> DecodePng(CairoGraphicsFactory* factory,
     return nullptr;
   }
 
-  png_set_read_fn(png_ptr, stream,
-                  [](png_structp png_ptr, png_bytep data, png_size_t length) {
-                    auto stream =
-                        static_cast<io::Stream*>(png_get_io_ptr(png_ptr));
-                    stream->Read(reinterpret_cast<std::byte*>(data), length);
-                  });
+  png_set_read_fn(png_ptr, io_ptr, read_fn);
 
   png_read_png(png_ptr, info_ptr,
                PNG_TRANSFORM_EXPAND | PNG_TRANSFORM_SWAP_ALPHA |
@@ -198,11 +217,26 @@ CairoImageFactory::~CairoImageFactory() {}
 
 std::unique_ptr<IImage> CairoImageFactory::DecodeFromStream(
     io::Stream* stream) {
+  // A mapped file is already in memory, so skip the per-chunk reads.
+  if (auto mapped_stream = dynamic_cast<io::MappedFileStream*>(stream)) {
+    return DecodeFromMemory(mapped_stream->GetSpan());
+  }
+
   std::byte buffer[8];
   stream->Read(buffer, 8);
   if (IsPngHeader(buffer, 8)) {
     stream->Seek(0, io::Stream::SeekOrigin::Begin);
-    return DecodePng(GetCairoGraphicsFactory(), stream);
+    return DecodePng(GetCairoGraphicsFactory(), stream, ReadPngFromStream);
+  }
+
+  throw Exception("Image format unknown. Currently only support png.");
+}
+
+std::unique_ptr<IImage> CairoImageFactory::DecodeFromMemory(
+    std::span<const std::byte> data) {
+  if (data.size() >= 8 && IsPngHeader(data.data(), 8)) {
+    PngMemoryReader reader{data};
+    return DecodePng(GetCairoGraphicsFactory(), &reader, ReadPngFromMemory);
   }
 
   throw Exception("Image format unknown. Currently only support png.");
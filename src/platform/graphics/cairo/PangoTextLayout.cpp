@@ -1,11 +1,15 @@
 #include "cru/platform/graphics/cairo/PangoTextLayout.h"
 #include "cru/platform/GraphicsBase.h"
 #include "cru/platform/graphics/Base.h"
+#include "cru/platform/graphics/cairo/CairoBrush.h"
 #include "cru/platform/graphics/cairo/CairoGraphicsFactory.h"
 #include "cru/platform/graphics/cairo/PangoFont.h"
 
 #include <pango/pangocairo.h>
 
+#include <algorithm>
+#include <span>
+
 namespace cru::platform::graphics::cairo {
 namespace {
 Rect ConvertFromPango(const Rect& rect) {
@@ -16,6 +20,59 @@ Rect ConvertFromPango(const Rect& rect) {
   result.height /= PANGO_SCALE;
   return result;
 }
+
+// Rects of range [start_index, end_index) in one paragraph, in pango units
+// relative to the paragraph.
+void AppendParagraphRangeRects(PangoLayout* layout, int start_index,
+                               int end_index, std::vector<Rect>& result) {
+  PangoRectangle rectangle;
+
+  int start_line_index, end_line_index, start_x_pos, end_x_pos;
+  pango_layout_index_to_line_x(layout, start_index, false, &start_line_index,
+                               &start_x_pos);
+  pango_layout_index_to_line_x(layout, end_index, false, &end_line_index,
+                               &end_x_pos);
+
+  pango_layout_index_to_pos(layout, start_index, &rectangle);
+  auto top = rectangle.y;
+
+  if (start_line_index == end_line_index) {
+    auto line = pango_layout_get_line_readonly(layout, start_line_index);
+    pango_layout_line_get_extents(line, nullptr, &rectangle);
+    result.push_back(Rect(rectangle.x + start_x_pos, top,
+                          end_x_pos - start_x_pos, rectangle.height));
+    return;
+  }
+
+  auto start_line = pango_layout_get_line_readonly(layout, start_line_index);
+  pango_layout_line_get_extents(start_line, nullptr, &rectangle);
+  result.push_back(Rect(rectangle.x + start_x_pos, top,
+                        rectangle.width - start_x_pos, rectangle.height));
+  top += rectangle.height;
+
+  for (int line_index = start_line_index + 1; line_index < end_line_index;
+       line_index++) {
+    auto line = pango_layout_get_line_readonly(layout, line_index);
+    pango_layout_line_get_extents(line, nullptr, &rectangle);
+    result.push_back(Rect(rectangle.x, top, rectangle.width, rectangle.height));
+    top += rectangle.height;
+  }
+
+  auto end_line = pango_layout_get_line_readonly(layout, end_line_index);
+  pango_layout_line_get_extents(end_line, nullptr, &rectangle);
+  result.push_back(Rect(rectangle.x, top, end_x_pos, rectangle.height));
+}
+
+void AppendRectanglesToPath(cairo_t* cairo, std::span<const Rect> rects) {
+  for (const auto& rect : rects) {
+    cairo_rectangle(cairo, rect.left, rect.top, rect.width, rect.height);
+  }
+}
+
+bool IsShapingAttribute(const TextAttribute& attribute) {
+  return attribute.weight != FontWeight::Normal ||
+         attribute.style != FontStyle::Normal || attribute.underline;
+}
 }  // namespace
 
 PangoTextLayout::PangoTextLayout(CairoGraphicsFactory* factory,
@@ -23,18 +80,61 @@ PangoTextLayout::PangoTextLayout(CairoGraphicsFactory* factory,
     : CairoResource(factory) {
   Expects(font);
   font_ = CheckPlatform<PangoFont>(font, GetPlatformId());
-  pango_layout_ = pango_cairo_create_layout(factory->GetDefaultCairo());
-  pango_layout_set_font_description(pango_layout_,
-                                    font_->GetPangoFontDescription());
+  cache_ = factory->GetTextLayoutCache();
+  cache_generation_ = cache_->GetGeneration();
+  ReplaceParagraphs(0, -1, 0, 0);
 };
 
-PangoTextLayout::~PangoTextLayout() { g_object_unref(pango_layout_); }
+PangoTextLayout::~PangoTextLayout() = default;
 
 std::string PangoTextLayout::GetText() { return text_; }
 
+std::string_view PangoTextLayout::GetTextView() { return text_; }
+
 void PangoTextLayout::SetText(std::string new_text) {
+  // Only the range between common prefix and common suffix changed.
+  const auto old_size = static_cast<Index>(text_.size());
+  const auto new_size = static_cast<Index>(new_text.size());
+  const auto min_size = std::min(old_size, new_size);
+  Index prefix = std::mismatch(text_.cbegin(), text_.cbegin() + min_size,
+                               new_text.cbegin())
+                     .first -
+                 text_.cbegin();
+  Index suffix = std::mismatch(text_.crbegin(),
+                               text_.crbegin() + (min_size - prefix),
+                               new_text.crbegin())
+                     .first -
+                 text_.crbegin();
+
+  if (prefix == old_size && old_size == new_size) return;
+
+  const auto first = GetParagraphIndex(prefix);
+  const auto last = GetParagraphIndex(old_size - suffix);
+  const auto start = paragraphs_[first].start;
+  const auto end = paragraphs_[last].start + paragraphs_[last].length +
+                   (new_size - old_size);
+
+  MoveAttributes(prefix, old_size - suffix - prefix,
+                 new_size - suffix - prefix);
   text_ = std::move(new_text);
-  pango_layout_set_text(pango_layout_, text_.c_str(), text_.size());
+  ReplaceParagraphs(first, last, start, end);
+}
+
+void PangoTextLayout::ReplaceText(Index position, Index count,
+                                  std::string_view text) {
+  CheckArgumentRange(position, 0, text_.size(), "position", true);
+  CheckArgumentRange(count, 0, text_.size() - position, "count", true);
+  if (count == 0 && text.empty()) return;
+
+  const auto first = GetParagraphIndex(position);
+  const auto last = GetParagraphIndex(position + count);
+  const auto start = paragraphs_[first].start;
+  const auto end = paragraphs_[last].start + paragraphs_[last].length +
+                   static_cast<Index>(text.size()) - count;
+
+  MoveAttributes(position, count, static_cast<Index>(text.size()));
+  text_.replace(position, count, text);
+  ReplaceParagraphs(first, last, start, end);
 }
 
 std::shared_ptr<IFont> PangoTextLayout::GetFont() { return font_; }
@@ -42,126 +142,138 @@ std::shared_ptr<IFont> PangoTextLayout::GetFont() { return font_; }
 void PangoTextLayout::SetFont(std::shared_ptr<IFont> font) {
   Expects(font);
   font_ = CheckPlatform<PangoFont>(font, GetPlatformId());
-  pango_layout_set_font_description(pango_layout_,
-                                    font_->GetPangoFontDescription());
+  InvalidateAllParagraphs();
 }
 
 void PangoTextLayout::SetMaxWidth(float max_width) {
-  return pango_layout_set_width(pango_layout_, max_width * PANGO_SCALE);
+  if (max_width_ == max_width) return;
+  max_width_ = max_width;
+  InvalidateAllParagraphs();
 }
 
 void PangoTextLayout::SetMaxHeight(float max_height) {
-  return pango_layout_set_height(pango_layout_, max_height * PANGO_SCALE);
+  // Pango only uses height to ellipsize, which is never enabled here.
+  CRU_UNUSED(max_height)
 }
 
 bool PangoTextLayout::IsEditMode() { return edit_mode_; }
 
 void PangoTextLayout::SetEditMode(bool enable) { edit_mode_ = enable; }
 
+void PangoTextLayout::SetAttributes(std::vector<TextAttribute> attributes) {
+  for (auto& attribute : attributes) {
+    attribute.range = attribute.range.Normalize();
+  }
+  std::ranges::sort(attributes, {}, [](const TextAttribute& attribute) {
+    return attribute.range.GetStart();
+  });
+  for (std::size_t i = 1; i < attributes.size(); i++) {
+    if (attributes[i].range.GetStart() < attributes[i - 1].range.GetEnd()) {
+      throw Exception("Text attribute ranges must not overlap.");
+    }
+  }
+  attributes_ = std::move(attributes);
+  UpdateParagraphAttributes(0, static_cast<Index>(paragraphs_.size()) - 1);
+}
+
 Index PangoTextLayout::GetLineIndexFromCharIndex(Index char_index) {
+  EnsureLayout();
+  auto paragraph_index = GetParagraphIndex(char_index);
   int line;
-  pango_layout_index_to_line_x(pango_layout_, char_index, false, &line,
-                               nullptr);
-  return line;
+  pango_layout_index_to_line_x(
+      GetParagraphLayout(paragraph_index),
+      GetParagraphTextIndex(paragraph_index, char_index), false, &line,
+      nullptr);
+  return paragraph_line_counts_.GetPrefixSum(paragraph_index) + line;
 }
 
 Index PangoTextLayout::GetLineCount() {
-  return pango_layout_get_line_count(pango_layout_);
+  EnsureLayout();
+  return paragraph_line_counts_.GetTotal();
 }
 
 float PangoTextLayout::GetLineHeight(Index line_index) {
-  auto line = pango_layout_get_line_readonly(pango_layout_, line_index);
+  EnsureLayout();
+  CheckArgumentRange(line_index, 0, GetLineCount(), "line_index");
+  auto paragraph_index = paragraph_line_counts_.FindIndex(line_index);
+  auto line = pango_layout_get_line_readonly(
+      GetParagraphLayout(paragraph_index),
+      line_index - paragraph_line_counts_.GetPrefixSum(paragraph_index));
   int height;
   pango_layout_line_get_height(line, &height);
   return static_cast<float>(height) / PANGO_SCALE;
 }
 
 Rect PangoTextLayout::GetTextBounds(bool includingTrailingSpace) {
-  PangoRectangle rectangle;
-  pango_layout_get_extents(pango_layout_, nullptr, &rectangle);
-  return ConvertFromPango(
-      Rect(rectangle.x, rectangle.y, rectangle.width, rectangle.height));
+  EnsureLayout();
+  return Rect(0, 0, max_paragraph_width_, paragraph_heights_.GetTotal());
 }
 
 std::vector<Rect> PangoTextLayout::TextRangeRect(const TextRange& text_range) {
+  EnsureLayout();
   auto tr = text_range.Normalize();
   auto start_index = tr.GetStart();
   auto end_index = tr.GetEnd();
-  PangoRectangle rectangle;
-
-  int start_line_index, end_line_index, start_x_pos, end_x_pos;
-  pango_layout_index_to_line_x(pango_layout_, start_index, false,
-                               &start_line_index, &start_x_pos);
-  pango_layout_index_to_line_x(pango_layout_, end_index, false, &end_line_index,
-                               &end_x_pos);
-
-  pango_layout_index_to_pos(pango_layout_, start_index, &rectangle);
-  auto top = rectangle.y;
-
-  if (start_line_index == end_line_index) {
-    auto line = pango_layout_get_line(pango_layout_, start_line_index);
-    pango_layout_line_get_extents(line, nullptr, &rectangle);
-    auto rect =
-        ConvertFromPango(Rect(rectangle.x + start_x_pos, top,
-                              end_x_pos - start_x_pos, rectangle.height));
-    return {rect};
-  } else {
-    std::vector<Rect> result;
-
-    auto start_line = pango_layout_get_line(pango_layout_, start_line_index);
-    pango_layout_line_get_extents(start_line, nullptr, &rectangle);
-    result.push_back(Rect(rectangle.x + start_x_pos, top,
-                          rectangle.width - start_x_pos, rectangle.height));
-    top += rectangle.height;
 
-    for (int line_index = start_line_index + 1; line_index < end_line_index;
-         line_index++) {
-      auto line = pango_layout_get_line(pango_layout_, line_index);
-      pango_layout_line_get_extents(line, nullptr, &rectangle);
-      result.push_back(
-          Rect(rectangle.x, top, rectangle.width, rectangle.height));
-      top += rectangle.height;
+  std::vector<Rect> result;
+  const auto first = GetParagraphIndex(start_index);
+  const auto last = GetParagraphIndex(end_index);
+  for (auto i = first; i <= last; i++) {
+    const auto& paragraph = paragraphs_[i];
+    const auto begin = result.size();
+    AppendParagraphRangeRects(
+        GetParagraphLayout(i),
+        i == first ? GetParagraphTextIndex(i, start_index) : 0,
+        i == last ? GetParagraphTextIndex(i, end_index) : paragraph.text_length,
+        result);
+    const auto top = GetParagraphTop(i);
+    for (auto j = begin; j < result.size(); j++) {
+      result[j] = ConvertFromPango(result[j]);
+      result[j].top += top;
     }
-
-    auto end_line = pango_layout_get_line(pango_layout_, end_line_index);
-    pango_layout_line_get_extents(end_line, nullptr, &rectangle);
-    result.push_back(Rect(rectangle.x, top, end_x_pos, rectangle.height));
-
-    for (auto& rect : result) {
-      rect = ConvertFromPango(rect);
-    }
-
-    return result;
   }
+  return result;
 }
 
 Rect PangoTextLayout::TextSinglePoint(Index position, bool trailing) {
-  int line_index, x_pos, y_pos = 0;
-  pango_layout_index_to_line_x(pango_layout_, position, trailing, &line_index,
-                               &x_pos);
+  EnsureLayout();
+  auto paragraph_index = GetParagraphIndex(position);
+  const auto layout = GetParagraphLayout(paragraph_index);
+  const auto index = GetParagraphTextIndex(paragraph_index, position);
 
-  for (int i = 0; i < line_index; i++) {
-    auto line = pango_layout_get_line(pango_layout_, line_index);
-    PangoRectangle rectangle;
-    pango_layout_line_get_extents(line, nullptr, &rectangle);
-    y_pos += rectangle.height;
-  }
+  int line_index, x_pos;
+  pango_layout_index_to_line_x(layout, index, trailing, &line_index, &x_pos);
+
+  PangoRectangle position_rectangle;
+  pango_layout_index_to_pos(layout, index, &position_rectangle);
 
-  auto line = pango_layout_get_line(pango_layout_, line_index);
+  auto line = pango_layout_get_line_readonly(layout, line_index);
   PangoRectangle rectangle;
   pango_layout_line_get_extents(line, nullptr, &rectangle);
 
-  return ConvertFromPango(
-      Rect(rectangle.x + x_pos, y_pos, 0, rectangle.height));
+  auto result = ConvertFromPango(Rect(rectangle.x + x_pos, position_rectangle.y,
+                                      0, rectangle.height));
+  result.top += GetParagraphTop(paragraph_index);
+  return result;
 }
 
 TextHitTestResult PangoTextLayout::HitTest(const Point& point) {
+  EnsureLayout();
+  auto paragraph_index = GetParagraphIndexAtY(point.y);
+  const auto& paragraph = paragraphs_[paragraph_index];
+  const auto top = GetParagraphTop(paragraph_index);
+
   int index, trailing;
-  auto inside_text =
-      pango_layout_xy_to_index(pango_layout_, point.x * PANGO_SCALE,
-                               point.y * PANGO_SCALE, &index, &trailing);
+  auto inside_text = pango_layout_xy_to_index(
+      paragraph.shaped->layout, point.x * PANGO_SCALE,
+      (point.y - top) * PANGO_SCALE,
+      &index, &trailing);
+  if (point.y < 0 || point.y >= paragraph_heights_.GetTotal()) {
+    inside_text = false;
+  }
 
-  TextHitTestResult result{index, trailing != 0, inside_text != 0};
+  TextHitTestResult result{paragraph.start + index, trailing != 0,
+                           inside_text != 0};
 
   if (result.trailing) {
     Index position_with_trailing;
@@ -174,4 +286,345 @@ TextHitTestResult PangoTextLayout::HitTest(const Point& point) {
   return result;
 }
 
+void PangoTextLayout::Draw(cairo_t* cairo, const Point& offset) {
+  cache_->UpdateContext(cairo);
+  EnsureLayout();
+
+  double clip_left, clip_top, clip_right, clip_bottom;
+  cairo_clip_extents(cairo, &clip_left, &clip_top, &clip_right, &clip_bottom);
+
+  auto paragraph_index =
+      GetParagraphIndexAtY(static_cast<float>(clip_top) - offset.y);
+  auto top = GetParagraphTop(paragraph_index);
+  for (; paragraph_index < static_cast<Index>(paragraphs_.size()) &&
+         offset.y + top < clip_bottom;
+       paragraph_index++) {
+    DrawParagraph(cairo, paragraph_index, Point(offset.x, offset.y + top),
+                  clip_left, clip_right);
+    top += paragraphs_[paragraph_index].shaped->height;
+  }
+}
+
+void PangoTextLayout::DrawParagraph(cairo_t* cairo, Index paragraph_index,
+                                    const Point& offset, double clip_left,
+                                    double clip_right) {
+  const auto& paragraph = paragraphs_[paragraph_index];
+  const auto layout = paragraph.shaped->layout;
+  const auto paragraph_end = paragraph.start + paragraph.text_length;
+
+  // Ranges of the same brush are drawn together, so each brush draws the
+  // layout once however many ranges it has.
+  struct Foreground {
+    cairo_pattern_t* pattern;
+    std::vector<Rect> rects;
+  };
+
+  // Rects of all foreground ranges.
+  std::vector<Rect> rects;
+  std::vector<Foreground> foregrounds;
+
+  for (auto i = GetAttributeIndex(paragraph.start);
+       i < static_cast<Index>(attributes_.size()) &&
+       attributes_[i].range.GetStart() < paragraph_end;
+       i++) {
+    const auto& attribute = attributes_[i];
+    if (!attribute.foreground && !attribute.background) continue;
+    const auto range =
+        attribute.range.CoerceInto(paragraph.start, paragraph_end);
+    if (range.count == 0) continue;
+
+    const auto begin = rects.size();
+    AppendParagraphRangeRects(layout, range.GetStart() - paragraph.start,
+                              range.GetEnd() - paragraph.start, rects);
+    for (auto j = begin; j < rects.size(); j++) {
+      rects[j] = ConvertFromPango(rects[j]);
+      rects[j].left += offset.x;
+      rects[j].top += offset.y;
+    }
+    const auto range_rects = std::span(rects).subspan(begin);
+
+    if (attribute.background) {
+      cairo_save(cairo);
+      cairo_set_source(cairo, CheckPlatform<CairoBrush>(
+                                  attribute.background.get(), GetPlatformId())
+                                  ->GetCairoPattern());
+      cairo_new_path(cairo);
+      AppendRectanglesToPath(cairo, range_rects);
+      cairo_fill(cairo);
+      cairo_restore(cairo);
+    }
+
+    if (attribute.foreground) {
+      auto pattern = CheckPlatform<CairoBrush>(attribute.foreground.get(),
+                                               GetPlatformId())
+                         ->GetCairoPattern();
+      auto foreground = std::ranges::find(foregrounds, pattern,
+                                          &Foreground::pattern);
+      if (foreground == foregrounds.end()) {
+        foregrounds.push_back({pattern, {}});
+        foreground = foregrounds.end() - 1;
+      }
+      foreground->rects.insert(foreground->rects.end(), range_rects.begin(),
+                               range_rects.end());
+    } else {
+      rects.resize(begin);
+    }
+  }
+
+  if (foregrounds.empty()) {
+    cairo_move_to(cairo, offset.x, offset.y);
+    pango_cairo_show_layout(cairo, layout);
+    return;
+  }
+
+  // Text outside foreground ranges is drawn with current source.
+  cairo_save(cairo);
+  cairo_new_path(cairo);
+  cairo_rectangle(cairo, clip_left, offset.y, clip_right - clip_left,
+                  paragraph.shaped->height);
+  AppendRectanglesToPath(cairo, rects);
+  cairo_set_fill_rule(cairo, CAIRO_FILL_RULE_EVEN_ODD);
+  cairo_clip(cairo);
+  cairo_move_to(cairo, offset.x, offset.y);
+  pango_cairo_show_layout(cairo, layout);
+  cairo_restore(cairo);
+
+  for (const auto& foreground : foregrounds) {
+    cairo_save(cairo);
+    cairo_new_path(cairo);
+    AppendRectanglesToPath(cairo, foreground.rects);
+    cairo_clip(cairo);
+    cairo_set_source(cairo, foreground.pattern);
+    cairo_move_to(cairo, offset.x, offset.y);
+    pango_cairo_show_layout(cairo, layout);
+    cairo_restore(cairo);
+  }
+}
+
+Index PangoTextLayout::GetParagraphIndex(Index position) {
+  CheckArgumentRange(position, 0, text_.size(), "position", true);
+  auto iter = std::upper_bound(
+      paragraphs_.cbegin(), paragraphs_.cend(), position,
+      [](Index position, const Paragraph& paragraph) {
+        return position < paragraph.start;
+      });
+  return iter - paragraphs_.cbegin() - 1;
+}
+
+Index PangoTextLayout::GetParagraphIndexAtY(float y) {
+  return std::min(paragraph_heights_.FindIndex(std::max(y, 0.f)),
+                  static_cast<Index>(paragraphs_.size()) - 1);
+}
+
+void PangoTextLayout::ReplaceParagraphs(Index first, Index last, Index start,
+                                        Index end) {
+  // Bounded so that splitting never scans text after the replaced range.
+  const auto text = std::string_view(text_).substr(0, end);
+  std::vector<Paragraph> new_paragraphs;
+  for (auto paragraph_start = start;;) {
+    auto line_feed = text.find('\n', paragraph_start);
+    auto paragraph_end = line_feed == std::string_view::npos
+                             ? end
+                             : static_cast<Index>(line_feed);
+    // Pango breaks paragraphs at carriage return too, so shaping it with CRLF
+    // would add an empty line.
+    auto text_end = paragraph_end;
+    if (text_end > paragraph_start &&
+        text_end < static_cast<Index>(text_.size()) &&
+        text_[text_end - 1] == '\r') {
+      text_end--;
+    }
+    new_paragraphs.push_back(Paragraph{paragraph_start,
+                                       paragraph_end - paragraph_start,
+                                       text_end - paragraph_start,
+                                       true,
+                                       {},
+                                       {}});
+    if (paragraph_end == end) break;
+    paragraph_start = paragraph_end + 1;
+  }
+
+  const auto old_count = last - first + 1;
+  const auto new_count = static_cast<Index>(new_paragraphs.size());
+
+  // Keep old shaped text to compare widths.
+  for (Index i = 0; i < std::min(new_count, old_count); i++) {
+    new_paragraphs[i].shaped = std::move(paragraphs_[first + i].shaped);
+  }
+
+  const auto delta = end - (old_count == 0 ? start
+                                           : paragraphs_[last].start +
+                                                 paragraphs_[last].length);
+  for (auto i = last + 1; i < static_cast<Index>(paragraphs_.size()); i++) {
+    paragraphs_[i].start += delta;
+  }
+
+  if (old_count == new_count) {
+    std::ranges::move(new_paragraphs, paragraphs_.begin() + first);
+  } else {
+    paragraphs_.erase(paragraphs_.begin() + first,
+                      paragraphs_.begin() + last + 1);
+    paragraphs_.insert(paragraphs_.begin() + first, new_paragraphs.cbegin(),
+                       new_paragraphs.cend());
+    prefix_sums_stale_ = true;
+    dirty_paragraphs_.clear();
+  }
+
+  if (!prefix_sums_stale_) {
+    for (Index i = 0; i < new_count; i++) {
+      dirty_paragraphs_.push_back(first + i);
+    }
+  }
+
+  // Attributes move with text, so later paragraphs keep theirs.
+  UpdateParagraphAttributes(first, first + new_count - 1);
+}
+
+void PangoTextLayout::InvalidateAllParagraphs() {
+  for (auto& paragraph : paragraphs_) {
+    paragraph.dirty = true;
+  }
+  prefix_sums_stale_ = true;
+  dirty_paragraphs_.clear();
+}
+
+void PangoTextLayout::UpdateParagraphAttributes(Index first, Index last) {
+  if (first > last) return;
+
+  const auto attribute_count = static_cast<Index>(attributes_.size());
+  auto attribute_index = GetAttributeIndex(paragraphs_[first].start);
+  for (auto i = first; i <= last; i++) {
+    auto& paragraph = paragraphs_[i];
+    const auto paragraph_end = paragraph.start + paragraph.text_length;
+    while (attribute_index < attribute_count &&
+           attributes_[attribute_index].range.GetEnd() <= paragraph.start) {
+      attribute_index++;
+    }
+
+    std::vector<PangoShapingAttribute> attributes;
+    for (auto j = attribute_index; j < attribute_count &&
+                                   attributes_[j].range.GetStart() <
+                                       paragraph_end;
+         j++) {
+      const auto& attribute = attributes_[j];
+      if (!IsShapingAttribute(attribute)) continue;
+      const auto range =
+          attribute.range.CoerceInto(paragraph.start, paragraph_end);
+      if (range.count == 0) continue;
+      attributes.push_back(
+          {static_cast<int>(range.GetStart() - paragraph.start),
+           static_cast<int>(range.GetEnd() - paragraph.start), attribute.weight,
+           attribute.style, attribute.underline});
+    }
+
+    if (attributes != paragraph.attributes) {
+      paragraph.attributes = std::move(attributes);
+      MarkParagraphDirty(i);
+    }
+  }
+}
+
+void PangoTextLayout::MoveAttributes(Index position, Index count,
+                                     Index new_count) {
+  // Attributes after replaced text move with it, and ones overlapping it lose
+  // the replaced part. Replacing text only gets attributes of ranges around
+  // both of its sides.
+  const auto end = position + count;
+  const auto delta = new_count - count;
+  for (auto i = GetAttributeIndex(position);
+       i < static_cast<Index>(attributes_.size()); i++) {
+    auto& range = attributes_[i].range;
+    auto range_start = range.GetStart();
+    auto range_end = range.GetEnd();
+    if (range_start >= end) {
+      range_start += delta;
+    } else if (range_start >= position) {
+      range_start = position + new_count;
+    }
+    range_end = range_end > end ? range_end + delta : position;
+    range = TextRange::FromTwoSides(range_start,
+                                    std::max(range_start, range_end));
+  }
+  std::erase_if(attributes_, [](const TextAttribute& attribute) {
+    return attribute.range.count == 0;
+  });
+}
+
+void PangoTextLayout::MarkParagraphDirty(Index paragraph_index) {
+  auto& paragraph = paragraphs_[paragraph_index];
+  // Dirty paragraphs are already in dirty list or prefix sums are stale.
+  if (paragraph.dirty) return;
+  paragraph.dirty = true;
+  if (!prefix_sums_stale_) dirty_paragraphs_.push_back(paragraph_index);
+}
+
+Index PangoTextLayout::GetAttributeIndex(Index position) {
+  // Ranges don't overlap, so ends are sorted too.
+  return std::ranges::upper_bound(attributes_, position, {},
+                                  [](const TextAttribute& attribute) {
+                                    return attribute.range.GetEnd();
+                                  }) -
+         attributes_.cbegin();
+}
+
+void PangoTextLayout::EnsureLayout() {
+  if (cache_generation_ != cache_->GetGeneration()) {
+    cache_generation_ = cache_->GetGeneration();
+    InvalidateAllParagraphs();
+  }
+
+  auto update_paragraph = [this](Paragraph& paragraph) {
+    paragraph.shaped =
+        cache_->Get(std::string_view(text_).substr(paragraph.start,
+                                                   paragraph.text_length),
+                    font_.get(), max_width_, paragraph.attributes);
+    paragraph.dirty = false;
+  };
+
+  if (prefix_sums_stale_) {
+    std::vector<float> heights;
+    std::vector<Index> line_counts;
+    heights.reserve(paragraphs_.size());
+    line_counts.reserve(paragraphs_.size());
+    max_paragraph_width_ = 0.f;
+    for (auto& paragraph : paragraphs_) {
+      if (paragraph.dirty) update_paragraph(paragraph);
+      heights.push_back(paragraph.shaped->height);
+      line_counts.push_back(paragraph.shaped->line_count);
+      max_paragraph_width_ =
+          std::max(max_paragraph_width_, paragraph.shaped->width);
+    }
+    paragraph_heights_.Assign(std::move(heights));
+    paragraph_line_counts_.Assign(std::move(line_counts));
+    prefix_sums_stale_ = false;
+    dirty_paragraphs_.clear();
+    return;
+  }
+
+  auto recalculate_max_width = false;
+  for (auto index : dirty_paragraphs_) {
+    auto& paragraph = paragraphs_[index];
+    if (!paragraph.dirty) continue;
+    const auto old_width = paragraph.shaped ? paragraph.shaped->width : 0.f;
+    update_paragraph(paragraph);
+    const auto& shaped = *paragraph.shaped;
+    paragraph_heights_.Set(index, shaped.height);
+    paragraph_line_counts_.Set(index, shaped.line_count);
+    if (shaped.width >= max_paragraph_width_) {
+      max_paragraph_width_ = shaped.width;
+    } else if (old_width == max_paragraph_width_) {
+      recalculate_max_width = true;
+    }
+  }
+  dirty_paragraphs_.clear();
+
+  if (recalculate_max_width) {
+    max_paragraph_width_ = 0.f;
+    for (const auto& paragraph : paragraphs_) {
+      max_paragraph_width_ =
+          std::max(max_paragraph_width_, paragraph.shaped->width);
+    }
+  }
+}
+
 }  // namespace cru::platform::graphics::cairo
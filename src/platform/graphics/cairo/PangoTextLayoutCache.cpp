@@ -0,0 +1,172 @@
+#include "cru/platform/graphics/cairo/PangoTextLayoutCache.h"
+#include "cru/platform/graphics/cairo/PangoFont.h"
+
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace cru::platform::graphics::cairo {
+namespace {
+// Unbounded width, like max float, means no wrapping.
+int ConvertWidthToPango(float width) {
+  if (width < 0 || width >= std::numeric_limits<int>::max() / PANGO_SCALE) {
+    return -1;
+  }
+  return static_cast<int>(width * PANGO_SCALE);
+}
+
+// Rough size of text, glyphs and lines pango keeps for shaped text.
+std::size_t EstimateByteSize(
+    std::string_view text,
+    std::span<const PangoShapingAttribute> attributes) {
+  return 512 + text.size() * 32 + attributes.size() * 64;
+}
+
+PangoAttrList* CreateAttributeList(
+    std::span<const PangoShapingAttribute> attributes) {
+  auto list = pango_attr_list_new();
+  auto insert = [list](PangoAttribute* attribute,
+                       const PangoShapingAttribute& range) {
+    attribute->start_index = range.start;
+    attribute->end_index = range.end;
+    pango_attr_list_insert(list, attribute);
+  };
+  for (const auto& attribute : attributes) {
+    if (attribute.weight == FontWeight::Bold) {
+      insert(pango_attr_weight_new(PANGO_WEIGHT_BOLD), attribute);
+    }
+    if (attribute.style == FontStyle::Italic) {
+      insert(pango_attr_style_new(PANGO_STYLE_ITALIC), attribute);
+    }
+    if (attribute.underline) {
+      insert(pango_attr_underline_new(PANGO_UNDERLINE_SINGLE), attribute);
+    }
+  }
+  return list;
+}
+}  // namespace
+
+PangoShapedText::PangoShapedText(PangoLayout* layout) : layout(layout) {
+  PangoRectangle rectangle;
+  pango_layout_get_extents(layout, nullptr, &rectangle);
+  line_count = pango_layout_get_line_count(layout);
+  width = static_cast<float>(rectangle.x + rectangle.width) / PANGO_SCALE;
+  height = static_cast<float>(rectangle.height) / PANGO_SCALE;
+}
+
+PangoShapedText::~PangoShapedText() { g_object_unref(layout); }
+
+std::size_t PangoTextLayoutCache::KeyHash::operator()(const Key& key) const {
+  std::size_t result = 0;
+  hash_combine(result, key.text);
+  hash_combine(result, key.font_family);
+  hash_combine(result, key.font_size);
+  hash_combine(result, key.width);
+  for (const auto& attribute : key.attributes) {
+    hash_combine(result, attribute.start);
+    hash_combine(result, attribute.end);
+    hash_combine(result, static_cast<int>(attribute.weight));
+    hash_combine(result, static_cast<int>(attribute.style));
+    hash_combine(result, attribute.underline);
+  }
+  return result;
+}
+
+bool PangoTextLayoutCache::Key::operator==(const Key& other) const {
+  return text == other.text && font_family == other.font_family &&
+         font_size == other.font_size && width == other.width &&
+         std::ranges::equal(attributes, other.attributes);
+}
+
+PangoTextLayoutCache::PangoTextLayoutCache(PangoContext* context,
+                                           std::size_t max_byte_size)
+    : context_(context), max_byte_size_(max_byte_size) {
+  g_object_ref(context_);
+}
+
+PangoTextLayoutCache::~PangoTextLayoutCache() {
+  map_.clear();
+  entries_.clear();
+  g_object_unref(context_);
+}
+
+std::shared_ptr<const PangoShapedText> PangoTextLayoutCache::Get(
+    std::string_view text, PangoFont* font, float max_width,
+    std::span<const PangoShapingAttribute> attributes) {
+  const auto font_family = font->GetFontName();
+  const Key key{text, font_family, font->GetFontSize(),
+                ConvertWidthToPango(max_width), attributes};
+
+  if (auto iter = map_.find(key); iter != map_.end()) {
+    hit_count_++;
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return iter->second->value;
+  }
+
+  miss_count_++;
+
+  auto layout = pango_layout_new(context_);
+  pango_layout_set_font_description(layout, font->GetPangoFontDescription());
+  pango_layout_set_width(layout, key.width);
+  pango_layout_set_text(layout, text.data(), static_cast<int>(text.size()));
+  if (!attributes.empty()) {
+    auto attribute_list = CreateAttributeList(attributes);
+    pango_layout_set_attributes(layout, attribute_list);
+    pango_attr_list_unref(attribute_list);
+  }
+  auto value = std::make_shared<const PangoShapedText>(layout);
+
+  const auto byte_size = EstimateByteSize(text, attributes);
+  if (byte_size > max_byte_size_) return value;
+
+  Evict(max_byte_size_ - byte_size);
+
+  auto& entry = entries_.emplace_front(
+      Entry{std::string(text), font_family,
+            std::vector(attributes.begin(), attributes.end()), key, value,
+            byte_size});
+  entry.key.text = entry.text;
+  entry.key.font_family = entry.font_family;
+  entry.key.attributes = entry.attributes;
+  map_.emplace(entry.key, entries_.begin());
+  byte_size_ += byte_size;
+
+  return value;
+}
+
+void PangoTextLayoutCache::SetMaxByteSize(std::size_t max_byte_size) {
+  max_byte_size_ = max_byte_size;
+  Evict(max_byte_size);
+}
+
+void PangoTextLayoutCache::Clear() {
+  map_.clear();
+  entries_.clear();
+  byte_size_ = 0;
+  generation_++;
+}
+
+void PangoTextLayoutCache::UpdateContext(cairo_t* cairo) {
+  // Translation does not affect shaping, so this rarely changes anything.
+  auto serial = pango_context_get_serial(context_);
+  pango_cairo_update_context(cairo, context_);
+  if (pango_context_get_serial(context_) != serial) {
+    Clear();
+  }
+}
+
+PangoTextLayoutCacheStatistics PangoTextLayoutCache::GetStatistics() const {
+  return {hit_count_, miss_count_, static_cast<Index>(entries_.size()),
+          byte_size_};
+}
+
+void PangoTextLayoutCache::Evict(std::size_t max_byte_size) {
+  while (byte_size_ > max_byte_size) {
+    const auto& entry = entries_.back();
+    byte_size_ -= entry.byte_size;
+    map_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+}  // namespace cru::platform::graphics::cairo
@@ -26,6 +26,8 @@ DWriteTextLayout::~DWriteTextLayout() = default;
 
 std::string DWriteTextLayout::GetText() { return text_; }
 
+std::string_view DWriteTextLayout::GetTextView() { return text_; }
+
 void DWriteTextLayout::SetText(std::string new_text) {
   text_ = std::move(new_text);
   utf16_text_ = string::ToUtf16WString(text_);
@@ -0,0 +1,71 @@
+#include "cru/platform/gui/FrameClock.h"
+#include "cru/base/Base.h"
+#include "cru/base/log/Logger.h"
+
+#include <chrono>
+
+namespace cru::platform::gui {
+FrameClock::FrameClock(double frame_rate) : frame_rate_(0) {
+  SetFrameRate(frame_rate);
+}
+
+FrameClock::~FrameClock() = default;
+
+void FrameClock::SetFrameRate(double frame_rate) {
+  if (frame_rate < 0) {
+    throw Exception("Frame rate can't be negative.");
+  }
+  frame_rate_ = frame_rate;
+}
+
+FrameClock::Clock::duration FrameClock::GetFrameInterval() const {
+  if (frame_rate_ == 0) return Clock::duration::zero();
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1 / frame_rate_));
+}
+
+void FrameClock::RequestFrame() {
+  if (IsFramePending()) return;
+
+  auto now = Clock::now();
+  scheduled_frame_time_ =
+      CalculateNextFrameTime(now, last_frame_time_, GetFrameInterval());
+  auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+      scheduled_frame_time_ - now);
+
+  auto application = IUiApplication::GetInstance();
+  frame_canceler_.Reset(
+      delay.count() <= 0
+          ? application->SetImmediate([this] { RunFrame(); })
+          : application->SetTimeout(delay, [this] { RunFrame(); }));
+}
+
+void FrameClock::CancelFrame() { frame_canceler_.Reset(); }
+
+void FrameClock::RunFrame() {
+  // Timer has fired, so release it without canceling. Requests made by frame
+  // handlers schedule the next frame.
+  frame_canceler_.Release();
+
+  auto begin = Clock::now();
+  auto late = begin - scheduled_frame_time_;
+  last_frame_time_ = begin;
+
+  FrameEvent_.Raise(nullptr);
+
+  auto interval = GetFrameInterval();
+  if (interval == Clock::duration::zero()) return;
+
+  auto duration = Clock::now() - begin;
+  auto dropped_frame_count = static_cast<int>((late + duration) / interval);
+  if (dropped_frame_count > 0) {
+    CruLogDebug(
+        kLogTag, "Frame is late by {}us and takes {}us, {} frame(s) dropped.",
+        std::chrono::duration_cast<std::chrono::microseconds>(late).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count(),
+        dropped_frame_count);
+    FrameLateEvent_.Raise({late, duration, dropped_frame_count});
+  }
+}
+}  // namespace cru::platform::gui
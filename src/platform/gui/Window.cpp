@@ -4,6 +4,12 @@
 namespace cru::platform::gui {
 bool INativeWindow::IsCreated() { NotImplemented(); }
 
+void INativeWindow::RequestPartialRepaint(const Rect& area) {
+  RequestRepaint();
+}
+
+FrameClock* INativeWindow::GetFrameClock() { return nullptr; }
+
 IEvent<const NativePaintEventArgs&>* INativeWindow::Paint1Event() {
   NotImplemented();
 }
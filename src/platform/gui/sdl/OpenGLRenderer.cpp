@@ -171,26 +171,58 @@ void SdlOpenGLRenderer::Resize(int width, int height) {
                                  GL_NEAREST);
   glad_gl_context_.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
                                  GL_NEAREST);
+  // Allocate storage once per size. Present only updates sub-rectangles.
+  glad_gl_context_.TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,
+                              GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+
+  // Whole texture is undefined now.
+  dirty_area_ = Rect(0, 0, width, height);
 }
 
-std::unique_ptr<graphics::IPainter> SdlOpenGLRenderer::BeginPaint() {
+std::unique_ptr<graphics::IPainter> SdlOpenGLRenderer::BeginPaint(
+    const std::optional<Rect>& paint_area) {
   assert(cairo_surface_);
   assert(gl_texture_);
 
+  AddDirtyArea(paint_area.value_or(Rect(0, 0, width_, height_)));
+
   auto painter = std::make_unique<SdlOpenGLCairoRendererPainter>(
       cairo_, cairo_surface_, this);
   return painter;
 }
 
+void SdlOpenGLRenderer::AddDirtyArea(const Rect& area) {
+  auto clipped_area = area.Intersect(Rect(0, 0, width_, height_)).RoundOut();
+  if (clipped_area.HasNoSize()) return;
+  dirty_area_ = dirty_area_ ? dirty_area_->Union(clipped_area) : clipped_area;
+}
+
 void SdlOpenGLRenderer::Present() {
   assert(cairo_surface_);
   assert(gl_texture_);
 
+  if (!dirty_area_) return;
+  auto area = *dirty_area_;
+  dirty_area_ = std::nullopt;
+
   auto context_guard = MakeContextCurrent();
 
+  // Upload straight from cairo memory, using unpack parameters to select the
+  // dirty rows and columns, so no intermediate copy is needed.
   auto data = cairo_image_surface_get_data(cairo_surface_);
-  glad_gl_context_.TexImage2D(GL_TEXTURE_2D, 0, GL_BGRA, width_, height_, 0,
-                              GL_BGRA, GL_UNSIGNED_BYTE, data);
+  auto stride = cairo_image_surface_get_stride(cairo_surface_);
+  auto x = static_cast<GLint>(area.left), y = static_cast<GLint>(area.top);
+  auto width = static_cast<GLsizei>(area.width),
+       height = static_cast<GLsizei>(area.height);
+
+  glad_gl_context_.PixelStorei(GL_UNPACK_ROW_LENGTH, stride / 4);
+  glad_gl_context_.PixelStorei(GL_UNPACK_SKIP_PIXELS, x);
+  glad_gl_context_.PixelStorei(GL_UNPACK_SKIP_ROWS, y);
+  glad_gl_context_.TexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+                                 GL_BGRA, GL_UNSIGNED_BYTE, data);
+  glad_gl_context_.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glad_gl_context_.PixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+  glad_gl_context_.PixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
   glad_gl_context_.DrawElements(
       GL_TRIANGLES, sizeof(kIndices) / sizeof(*kIndices), GL_UNSIGNED_INT, 0);
@@ -45,25 +45,61 @@ SdlUiApplication::~SdlUiApplication() {
   }
 }
 
-int SdlUiApplication::Run() {
-  while (true) {
-    auto timeout = timers_.NextTimeout(std::chrono::steady_clock::now());
-
-    SDL_Event event;
-    bool has_event = false;
-    if (timeout) {
-      if (*timeout == std::chrono::milliseconds::zero()) {
-        has_event = SDL_PollEvent(&event);
-      } else {
-        has_event = SDL_WaitEventTimeout(&event, timeout->count());
+namespace {
+constexpr int kEventBatchSize = 64;
+
+/**
+ * Merge event into last if it only supersedes it. Only adjacent events are
+ * merged, so the order against buttons and keys is kept.
+ */
+bool TryCoalesceEvent(SDL_Event& last, const SDL_Event& event) {
+  if (last.type != event.type) return false;
+
+  switch (event.type) {
+    case SDL_EVENT_MOUSE_MOTION: {
+      if (last.motion.windowID != event.motion.windowID ||
+          last.motion.which != event.motion.which ||
+          last.motion.state != event.motion.state) {
+        return false;
       }
-    } else {
-      CheckSdlReturn(SDL_WaitEvent(&event));
-      has_event = true;
+      auto xrel = last.motion.xrel + event.motion.xrel;
+      auto yrel = last.motion.yrel + event.motion.yrel;
+      last = event;
+      last.motion.xrel = xrel;
+      last.motion.yrel = yrel;
+      return true;
     }
+    case SDL_EVENT_WINDOW_RESIZED:
+    case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: {
+      if (last.window.windowID != event.window.windowID) return false;
+      last = event;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+}  // namespace
 
-    if (has_event) {
+int SdlUiApplication::Run() {
+  using Clock = std::chrono::steady_clock;
+
+  // Each round handles every queued event before any expired timer, so
+  // neither of them can starve the other.
+  while (true) {
+    SdlUiApplicationRoundInfo round_info{};
+    auto wait_begin = Clock::now();
+    WaitEvent(timers_.NextTimeout(wait_begin));
+
+    auto event_begin = Clock::now();
+    round_info.wait_duration = event_begin - wait_begin;
+    round_info.event_count = TakeEvents();
+    round_info.dispatched_event_count = pending_events_.size();
+
+    bool quit = false;
+    for (const auto& event : pending_events_) {
       if (event.type == SDL_EVENT_QUIT) {
+        quit = true;
         break;
       }
 
@@ -72,13 +108,17 @@ int SdlUiApplication::Run() {
       // CruLogDebug(kLogTag, "{}", buf);
 
       DispatchEvent(event);
-    } else {
-      if (auto result = timers_.Update(std::chrono::steady_clock::now())) {
-        result->data();
-      }
     }
+    pending_events_.clear();
+    if (quit) break;
 
+    auto timer_begin = Clock::now();
+    round_info.event_duration = timer_begin - event_begin;
+    round_info.timer_count = RunTimers();
     delete_later_pool_.Clean();
+    round_info.timer_duration = Clock::now() - timer_begin;
+
+    AfterEachRoundEvent_.Raise(round_info);
   }
 
   for (const auto& handler : this->quit_handlers_) {
@@ -88,6 +128,54 @@ int SdlUiApplication::Run() {
   return quit_code_;
 }
 
+void SdlUiApplication::WaitEvent(
+    std::optional<std::chrono::milliseconds> timeout) {
+  // Wait without taking the event, TakeEvents gets it with the others.
+  if (!timeout) {
+    CheckSdlReturn(SDL_WaitEvent(nullptr));
+  } else if (*timeout > std::chrono::milliseconds::zero()) {
+    SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(timeout->count()));
+  } else {
+    SDL_PumpEvents();
+  }
+}
+
+Index SdlUiApplication::TakeEvents() {
+  Index count = 0;
+  SDL_Event buffer[kEventBatchSize];
+  // Only events queued now are taken. Events pushed meanwhile by other threads
+  // are left to the next round.
+  auto remaining = SDL_PeepEvents(nullptr, 0, SDL_PEEKEVENT, SDL_EVENT_FIRST,
+                                  SDL_EVENT_LAST);
+  while (remaining > 0) {
+    auto batch_count =
+        SDL_PeepEvents(buffer, std::min(remaining, kEventBatchSize),
+                       SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST);
+    if (batch_count <= 0) break;
+
+    remaining -= batch_count;
+    count += batch_count;
+    for (int i = 0; i < batch_count; i++) {
+      if (pending_events_.empty() ||
+          !TryCoalesceEvent(pending_events_.back(), buffer[i])) {
+        pending_events_.push_back(buffer[i]);
+      }
+    }
+  }
+  return count;
+}
+
+Index SdlUiApplication::RunTimers() {
+  // Timers added by these actions are left to the next round.
+  auto now = std::chrono::steady_clock::now();
+  Index count = 0;
+  while (auto result = timers_.Update(now)) {
+    result->data();
+    count++;
+  }
+  return count;
+}
+
 void SdlUiApplication::RequestQuit(int quit_code) {
   quit_code_ = quit_code;
   SDL_Event event;
@@ -38,6 +38,10 @@ SdlWindow::SdlWindow(SdlUiApplication* application)
   application->RegisterWindow(this);
 
   input_context_ = std::make_unique<SdlInputMethodContext>(this);
+
+#ifdef __unix
+  frame_clock_.FrameEvent()->AddSpyOnlyHandler([this] { UnixOnFrame(); });
+#endif
 }
 
 SdlWindow::~SdlWindow() { application_->UnregisterWindow(this); }
@@ -184,23 +188,36 @@ void SdlWindow::SetToForeground() {
 }
 
 void SdlWindow::RequestRepaint() {
+  RequestPartialRepaint(Rect(Point{}, client_rect_.GetSize()));
+}
+
+void SdlWindow::RequestPartialRepaint(const Rect& area) {
   if (!sdl_window_) return;
 #ifdef __unix
-  repaint_timer_canceler_.Reset(application_->SetImmediate([this] {
-    PaintEvent_.Raise(nullptr);
-    NativePaintEventArgs args{{{}, GetClientSize()}};
-    Paint1Event_.Raise(args);
-    renderer_->Present();
-  }));
+  auto clipped_area = area.Intersect(Rect(Point{}, client_rect_.GetSize()));
+  if (clipped_area.HasNoSize()) return;
+
+  if (repaint_area_) {
+    // A paint is already pending, just merge the area into it.
+    repaint_area_ = repaint_area_->Union(clipped_area);
+    return;
+  }
+
+  repaint_area_ = clipped_area;
+  frame_clock_.RequestFrame();
 #endif
 }
 
+#ifdef __unix
+FrameClock* SdlWindow::GetFrameClock() { return &frame_clock_; }
+#endif
+
 std::unique_ptr<graphics::IPainter> SdlWindow::BeginPaint() {
   if (!sdl_window_) {
     return std::make_unique<graphics::NullPainter>();
   }
 #ifdef __unix
-  return renderer_->BeginPaint();
+  return renderer_->BeginPaint(painting_area_);
 #else
   NotImplemented();
 #endif
@@ -509,12 +526,28 @@ void SdlWindow::UnixOnCreate(int width, int height) {
   renderer_ = std::make_unique<SdlOpenGLRenderer>(this, width, height);
 }
 
-void SdlWindow::UnixOnDestroy() { renderer_ = nullptr; }
+void SdlWindow::UnixOnDestroy() {
+  frame_clock_.CancelFrame();
+  repaint_area_ = std::nullopt;
+  painting_area_ = std::nullopt;
+  renderer_ = nullptr;
+}
 
 void SdlWindow::UnixOnResize(int width, int height) {
   assert(sdl_window_);
   renderer_->Resize(width, height);
 }
+
+void SdlWindow::UnixOnFrame() {
+  if (!repaint_area_) return;
+  NativePaintEventArgs args{*repaint_area_};
+  repaint_area_ = std::nullopt;
+  painting_area_ = args.repaint_area;
+  PaintEvent_.Raise(nullptr);
+  Paint1Event_.Raise(args);
+  painting_area_ = std::nullopt;
+  renderer_->Present();
+}
 #endif
 
 }  // namespace cru::platform::gui::sdl
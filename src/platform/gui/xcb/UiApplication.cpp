@@ -12,6 +12,8 @@
 #include <poll.h>
 #include <xcb/xcb.h>
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 
 namespace cru::platform::gui::xcb {
 XcbUiApplication::XcbUiApplication(
@@ -154,21 +156,125 @@ void XcbUiApplication::DeleteLater(Object* object) {
 
 void XcbUiApplication::DispatchXEventToWindows(xcb_generic_event_t* event) {
   auto event_xcb_window = XcbWindow::GetEventWindow(event);
-  for (auto window : windows_) {
-    if (window->GetXcbWindow() == event_xcb_window) {
-      window->HandleEvent(event);
-      break;
-    }
+  if (!event_xcb_window) return;
+  auto iter = xcb_windows_.find(*event_xcb_window);
+  if (iter != xcb_windows_.end()) {
+    iter->second->HandleEvent(event);
   }
 }
 
 void XcbUiApplication::PollAllXEvents() {
-  xcb_generic_event_t* event;
-  while ((event = xcb_poll_for_event(xcb_connection_))) {
-    if (!input_method_manager_->HandleXEvent(event)) {
-      DispatchXEventToWindows(event);
+  HandleXEventBatches(
+      [this](bool queued_only) {
+        return queued_only ? xcb_poll_for_queued_event(xcb_connection_)
+                           : xcb_poll_for_event(xcb_connection_);
+      },
+      [this](xcb_window_t window) { return xcb_windows_.contains(window); },
+      [this](xcb_generic_event_t* event) {
+        if (!input_method_manager_->HandleXEvent(event)) {
+          DispatchXEventToWindows(event);
+        }
+      });
+}
+
+void HandleXEventBatches(
+    const std::function<xcb_generic_event_t*(bool queued_only)>& poll,
+    const std::function<bool(xcb_window_t)>& is_own_window,
+    const std::function<void(xcb_generic_event_t*)>& handle) {
+  for (bool queued_only = false;; queued_only = true) {
+    // Local, so that a handler polling again gets its own batch.
+    std::vector<AutoFreePtr<xcb_generic_event_t>> events;
+
+    // Drain first so superseded events are dropped before any of them runs.
+    while (auto event = poll(queued_only)) {
+      events.push_back(MakeAutoFree(event));
+    }
+    if (events.empty()) return;
+
+    CompressXEvents(events, is_own_window);
+
+    for (const auto& event : events) {
+      if (event) handle(event.get());
+    }
+  }
+}
+
+namespace {
+void UnionExposeArea(xcb_expose_event_t* target,
+                     const xcb_expose_event_t* other) {
+  int left = std::min(target->x, other->x);
+  int top = std::min(target->y, other->y);
+  int right = std::max(target->x + target->width, other->x + other->width);
+  int bottom = std::max(target->y + target->height, other->y + other->height);
+  target->x = static_cast<std::uint16_t>(left);
+  target->y = static_cast<std::uint16_t>(top);
+  target->width = static_cast<std::uint16_t>(right - left);
+  target->height = static_cast<std::uint16_t>(bottom - top);
+}
+}  // namespace
+
+void CompressXEvents(std::vector<AutoFreePtr<xcb_generic_event_t>>& events,
+                     const std::function<bool(xcb_window_t)>& is_own_window) {
+  if (events.size() < 2) return;
+
+  // Index of the kept event of each kind in events, or -1.
+  struct LatestEvents {
+    Index motion = -1;
+    Index expose = -1;
+    Index configure = -1;
+  };
+  std::unordered_map<xcb_window_t, LatestEvents> latest_events;
+
+  // The later event is kept, so it is handled after anything the earlier one
+  // was behind, e.g. an expose after the configure that made it.
+  auto supersede = [&events](Index& latest, Index index) {
+    if (latest != -1) events[latest].reset();
+    latest = index;
+  };
+
+  for (Index i = 0; i < std::ssize(events); i++) {
+    auto event = events[i].get();
+    auto window = XcbWindow::GetEventWindow(event);
+    // Leave windows of others, e.g. the input method server, untouched.
+    if (!window || !is_own_window(*window)) continue;
+
+    auto& latest = latest_events[*window];
+    switch (event->response_type & ~0x80) {
+      case XCB_MOTION_NOTIFY: {
+        supersede(latest.motion, i);
+        break;
+      }
+      case XCB_EXPOSE: {
+        if (latest.expose != -1) {
+          UnionExposeArea(
+              reinterpret_cast<xcb_expose_event_t*>(event),
+              reinterpret_cast<xcb_expose_event_t*>(
+                  events[latest.expose].get()));
+        }
+        supersede(latest.expose, i);
+        break;
+      }
+      case XCB_CONFIGURE_NOTIFY: {
+        supersede(latest.configure, i);
+        break;
+      }
+      case XCB_BUTTON_PRESS:
+      case XCB_BUTTON_RELEASE:
+      case XCB_KEY_PRESS:
+      case XCB_KEY_RELEASE:
+      case XCB_ENTER_NOTIFY:
+      case XCB_LEAVE_NOTIFY: {
+        // Keep the pointer position in order with buttons and crossings.
+        latest.motion = -1;
+        break;
+      }
+      case XCB_DESTROY_NOTIFY: {
+        latest = {};
+        break;
+      }
+      default:
+        break;
     }
-    ::free(event);
   }
 }
 
@@ -197,5 +303,17 @@ void XcbUiApplication::RegisterWindow(XcbWindow* window) {
 
 void XcbUiApplication::UnregisterWindow(XcbWindow* window) {
   std::erase(windows_, window);
+  if (auto id = window->GetXcbWindow()) {
+    UnregisterXcbWindowId(*id);
+  }
+}
+
+void XcbUiApplication::RegisterXcbWindowId(xcb_window_t id,
+                                           XcbWindow* window) {
+  xcb_windows_[id] = window;
+}
+
+void XcbUiApplication::UnregisterXcbWindowId(xcb_window_t id) {
+  xcb_windows_.erase(id);
 }
 }  // namespace cru::platform::gui::xcb
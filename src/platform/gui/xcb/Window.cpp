@@ -17,6 +17,7 @@
 #include <xcb/xcb.h>
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -38,15 +39,45 @@ MouseButton ConvertMouseButton(xcb_button_t button) {
 }
 }  // namespace
 
+class XcbWindow::XcbWindowPainter : public graphics::cairo::CairoPainter {
+ public:
+  XcbWindowPainter(XcbWindow* window, cairo_t* cairo, cairo_surface_t* surface,
+                   std::optional<Rect> present_area)
+      : CairoPainter(window->application_->GetCairoFactory(), cairo, true,
+                     surface),
+        window_(window),
+        present_area_(present_area),
+        begin_time_(std::chrono::steady_clock::now()) {}
+
+  void EndDraw() override {
+    CairoPainter::EndDraw();
+    window_->OnPainterEndDraw(this);
+  }
+
+  const std::optional<Rect>& GetPresentArea() const { return present_area_; }
+  std::chrono::steady_clock::time_point GetBeginTime() const {
+    return begin_time_;
+  }
+
+ private:
+  XcbWindow* window_;
+  std::optional<Rect> present_area_;
+  std::chrono::steady_clock::time_point begin_time_;
+};
+
 XcbWindow::XcbWindow(XcbUiApplication* application)
     : application_(application),
       xcb_window_(std::nullopt),
       cairo_surface_(nullptr),
-      parent_(nullptr) {
+      parent_(nullptr),
+      back_buffer_enabled_(true),
+      back_buffer_surface_(nullptr) {
   application->RegisterWindow(this);
   input_method_ = new XcbXimInputMethodContext(
       application->GetXcbXimInputMethodManager(), this);
 
+  frame_clock_.FrameEvent()->AddSpyOnlyHandler([this] { OnFrame(); });
+
   PaintEvent_.AddSpyOnlyHandler([this] {
     if (xcb_window_)
       CruLogDebug(kLogTag, "{:#x} Paint event triggered.", *xcb_window_);
@@ -286,13 +317,38 @@ void XcbWindow::SetToForeground() {
 }
 
 void XcbWindow::RequestRepaint() {
+  RequestPartialRepaint(Rect(Point{}, current_size_));
+}
+
+void XcbWindow::RequestPartialRepaint(const Rect& area) {
   if (!xcb_window_.has_value()) return;
-  CruLogDebug(kLogTag, "{:#x} Repaint requested.", *xcb_window_);
-  // TODO: true throttle
-  repaint_canceler_.Reset(application_->SetImmediate([this] {
-    PaintEvent_.Raise(nullptr);
-    Paint1Event_.Raise({{{}, GetClientSize()}});
-  }));
+
+  auto clipped_area = area.Intersect(Rect(Point{}, current_size_));
+  if (clipped_area.HasNoSize()) return;
+
+  CruLogDebug(kLogTag, "{:#x} Repaint requested for {}.", *xcb_window_,
+              clipped_area);
+
+  if (repaint_area_) {
+    // A paint is already pending, just merge the area into it.
+    repaint_area_ = repaint_area_->Union(clipped_area);
+    return;
+  }
+
+  repaint_area_ = clipped_area;
+  frame_clock_.RequestFrame();
+}
+
+FrameClock* XcbWindow::GetFrameClock() { return &frame_clock_; }
+
+void XcbWindow::OnFrame() {
+  if (!repaint_area_) return;
+  auto repaint_area = *repaint_area_;
+  repaint_area_ = std::nullopt;
+  painting_area_ = repaint_area;
+  PaintEvent_.Raise(nullptr);
+  Paint1Event_.Raise({repaint_area});
+  painting_area_ = std::nullopt;
 }
 
 std::unique_ptr<graphics::IPainter> XcbWindow::BeginPaint() {
@@ -300,11 +356,23 @@ std::unique_ptr<graphics::IPainter> XcbWindow::BeginPaint() {
     return std::make_unique<graphics::NullPainter>();
   }
 
-  auto factory = application_->GetCairoFactory();
-  cairo_t* cairo = cairo_create(cairo_surface_);
-  auto painter =
-      new graphics::cairo::CairoPainter(factory, cairo, true, cairo_surface_);
-  return std::unique_ptr<graphics::IPainter>(painter);
+  auto surface = back_buffer_surface_ ? back_buffer_surface_ : cairo_surface_;
+  cairo_t* cairo = cairo_create(surface);
+  return std::make_unique<XcbWindowPainter>(this, cairo, surface,
+                                            painting_area_);
+}
+
+void XcbWindow::SetBackBufferEnabled(bool enabled) {
+  if (back_buffer_enabled_ == enabled) return;
+  back_buffer_enabled_ = enabled;
+  if (!xcb_window_) return;
+  if (enabled) {
+    CreateBackBuffer();
+  } else {
+    DestroyBackBuffer();
+  }
+  // The back buffer starts empty, and the window may be stale.
+  RequestRepaint();
 }
 
 IInputMethodContext* XcbWindow::GetInputMethodContext() {
@@ -348,6 +416,7 @@ xcb_window_t XcbWindow::DoCreateWindow() {
   current_size_ = Size(width, height);
 
   xcb_window_ = window;
+  application_->RegisterXcbWindowId(window, this);
 
   std::vector<xcb_atom_t> wm_protocols{
       application_->GetXcbAtomWM_DELETE_WINDOW()};
@@ -377,6 +446,9 @@ xcb_window_t XcbWindow::DoCreateWindow() {
 
   cairo_surface_ =
       cairo_xcb_surface_create(connection, window, visual_type, width, height);
+  if (back_buffer_enabled_) {
+    CreateBackBuffer();
+  }
 
   CreateEvent_.Raise(nullptr);
   ResizeEvent_.Raise(current_size_);
@@ -388,14 +460,27 @@ xcb_window_t XcbWindow::DoCreateWindow() {
 void XcbWindow::HandleEvent(xcb_generic_event_t* event) {
   switch (event->response_type & ~0x80) {
     case XCB_EXPOSE: {
-      RequestRepaint();
+      xcb_expose_event_t* expose = (xcb_expose_event_t*)event;
+      Rect area(expose->x, expose->y, expose->width, expose->height);
+      if (back_buffer_surface_) {
+        // Back buffer always holds the latest painted content, and pending
+        // repaints present themselves when done.
+        PresentBackBuffer(area);
+      } else {
+        RequestPartialRepaint(area);
+      }
       break;
     }
     case XCB_DESTROY_NOTIFY: {
       DestroyEvent_.Raise(nullptr);
 
+      frame_clock_.CancelFrame();
+      repaint_area_ = std::nullopt;
+
+      DestroyBackBuffer();
       cairo_surface_destroy(cairo_surface_);
       cairo_surface_ = nullptr;
+      application_->UnregisterXcbWindowId(*xcb_window_);
       xcb_window_ = std::nullopt;
 
       if (application_->IsQuitOnAllWindowClosed() &&
@@ -417,6 +502,9 @@ void XcbWindow::HandleEvent(xcb_generic_event_t* event) {
         current_size_ = Size(width, height);
         assert(cairo_surface_);
         cairo_xcb_surface_set_size(cairo_surface_, width, height);
+        if (back_buffer_surface_) {
+          CreateBackBuffer();
+        }
         ResizeEvent_.Raise(current_size_);
       }
       break;
@@ -675,6 +763,96 @@ std::optional<Thickness> XcbWindow::Get_NET_FRAME_EXTENTS(xcb_window_t window) {
                    frame_properties[1], frame_properties[3]);
 }
 
+void XcbWindow::CreateBackBuffer() {
+  assert(cairo_surface_);
+
+  // An image surface similar to the window one. cairo's xcb backend uploads
+  // it with MIT-SHM when the server supports it, so present is a single
+  // shared-memory put instead of many small drawing requests.
+  auto new_surface = cairo_surface_create_similar_image(
+      cairo_surface_, CAIRO_FORMAT_RGB24,
+      static_cast<int>(current_size_.width),
+      static_cast<int>(current_size_.height));
+
+  if (back_buffer_surface_) {
+    // Keep old content so that a partial paint before the full relayout paint
+    // does not present garbage.
+    auto cairo = cairo_create(new_surface);
+    cairo_set_source_surface(cairo, back_buffer_surface_, 0, 0);
+    cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cairo);
+    cairo_destroy(cairo);
+    cairo_surface_destroy(back_buffer_surface_);
+  }
+
+  back_buffer_surface_ = new_surface;
+}
+
+void XcbWindow::DestroyBackBuffer() {
+  if (back_buffer_surface_) {
+    cairo_surface_destroy(back_buffer_surface_);
+    back_buffer_surface_ = nullptr;
+  }
+}
+
+void XcbWindow::PresentBackBuffer(const Rect& area) {
+  assert(back_buffer_surface_);
+  assert(cairo_surface_);
+
+  auto present_area = area.Intersect(Rect(Point{}, current_size_)).RoundOut();
+  if (present_area.HasNoSize()) return;
+
+  auto cairo = cairo_create(cairo_surface_);
+  cairo_set_source_surface(cairo, back_buffer_surface_, 0, 0);
+  cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+  cairo_rectangle(cairo, present_area.left, present_area.top,
+                  present_area.width, present_area.height);
+  cairo_fill(cairo);
+  cairo_destroy(cairo);
+
+  cairo_surface_flush(cairo_surface_);
+  application_->XcbFlush();
+}
+
+void XcbWindow::OnPainterEndDraw(XcbWindowPainter* painter) {
+  auto present_time = XcbWindowPaintStatistics::Duration::zero();
+
+  // The painter may outlive the surface it was created on if the window is
+  // destroyed in between, in which case there is nothing to present.
+  if (back_buffer_surface_ && xcb_window_) {
+    auto present_begin = std::chrono::steady_clock::now();
+    PresentBackBuffer(
+        painter->GetPresentArea().value_or(Rect(Point{}, current_size_)));
+    present_time = std::chrono::steady_clock::now() - present_begin;
+  }
+
+  auto frame_time = std::chrono::steady_clock::now() - painter->GetBeginTime();
+
+  auto& s = paint_statistics_;
+  s.frame_count++;
+  s.last_frame_time = frame_time;
+  s.max_frame_time = std::max(s.max_frame_time, frame_time);
+  s.total_frame_time += frame_time;
+  s.last_present_time = present_time;
+  s.total_present_time += present_time;
+
+  if (s.frame_count % 100 == 0) {
+    using std::chrono::microseconds, std::chrono::duration_cast;
+    CruLogDebug(kLogTag,
+                "{:#x} {} frames painted ({}), average {}us, max {}us, "
+                "present average {}us.",
+                xcb_window_.value_or(0), s.frame_count,
+                back_buffer_surface_ ? "back buffer" : "direct",
+                duration_cast<microseconds>(s.GetAverageFrameTime()).count(),
+                duration_cast<microseconds>(s.max_frame_time).count(),
+                duration_cast<microseconds>(
+                    s.total_present_time /
+                    static_cast<XcbWindowPaintStatistics::Duration::rep>(
+                        s.frame_count))
+                    .count());
+  }
+}
+
 Point XcbWindow::GetXcbWindowPosition(xcb_window_t window) {
   Point result;
 
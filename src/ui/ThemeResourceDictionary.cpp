@@ -1,18 +1,19 @@
 #include "cru/ui/ThemeResourceDictionary.h"
 #include "cru/base/StringUtil.h"
-#include "cru/base/io/CFileStream.h"
+#include "cru/base/io/MappedFileStream.h"
 #include "cru/base/log/Logger.h"
+#include "cru/base/xml/XmlDocument.h"
 #include "cru/base/xml/XmlNode.h"
-#include "cru/base/xml/XmlParser.h"
 
 namespace cru::ui {
 
 std::unique_ptr<ThemeResourceDictionary> ThemeResourceDictionary::FromFile(
     std::filesystem::path file_path) {
-  io::CFileStream stream(file_path.generic_string().c_str(), "r");
-  auto xml_string = stream.ReadToEndAsUtf8String();
-  auto parser = xml::XmlParser(xml_string);
-  return std::make_unique<ThemeResourceDictionary>(parser.Parse(), false);
+  auto stream = std::make_unique<io::MappedFileStream>(
+      file_path.generic_string().c_str());
+  auto xml_document = std::make_unique<xml::XmlDocument>(stream->GetSpan());
+  return std::make_unique<ThemeResourceDictionary>(std::move(stream),
+                                                   std::move(xml_document));
 }
 
 ThemeResourceDictionary::ThemeResourceDictionary(xml::XmlElementNode* xml_root,
@@ -22,8 +23,25 @@ ThemeResourceDictionary::ThemeResourceDictionary(xml::XmlElementNode* xml_root,
   UpdateResourceMap(xml_root_.get());
 }
 
+ThemeResourceDictionary::ThemeResourceDictionary(
+    std::unique_ptr<io::MappedFileStream> stream,
+    std::unique_ptr<xml::XmlDocument> xml_document)
+    : stream_(std::move(stream)), xml_document_(std::move(xml_document)) {
+  Expects(xml_document_ != nullptr);
+  UpdateResourceMap(xml_document_->GetRoot());
+}
+
 ThemeResourceDictionary::~ThemeResourceDictionary() = default;
 
+xml::XmlElementNode* ThemeResourceDictionary::GetXmlNode(
+    ResourceEntry& entry) {
+  if (!entry.xml_node) {
+    converted_nodes_.emplace_back(entry.xml_view->ToXmlNode()->AsElement());
+    entry.xml_node = converted_nodes_.back().get();
+  }
+  return entry.xml_node;
+}
+
 void ThemeResourceDictionary::UpdateResourceMap(xml::XmlElementNode* xml_root) {
   if (!cru::string::CaseInsensitiveEqual(xml_root->GetTag(), "Theme")) {
     throw Exception("Root tag of theme must be 'Theme'.");
@@ -56,4 +74,37 @@ void ThemeResourceDictionary::UpdateResourceMap(xml::XmlElementNode* xml_root) {
     }
   }
 }
+
+void ThemeResourceDictionary::UpdateResourceMap(
+    const xml::XmlNodeView* xml_root) {
+  if (!xml_root->IsElementNode() || !xml_root->HasTag("Theme")) {
+    throw Exception("Root tag of theme must be 'Theme'.");
+  }
+
+  for (auto c = xml_root->GetFirstChild(); c; c = c->GetNextSibling()) {
+    if (c->IsElementNode()) {
+      if (c->HasTag("Resource")) {
+        auto key_attr = c->GetOptionalAttributeValueCaseInsensitive("key");
+        if (!key_attr) {
+          throw Exception("'key' attribute is required for resource.");
+        }
+        if (c->GetChildElementCount() != 1) {
+          throw Exception("Resource must have only one child element.");
+        }
+
+        ResourceEntry entry;
+
+        entry.name = *key_attr;
+        entry.xml_view = c->GetFirstChildElement();
+
+        resource_map_[entry.name] = std::move(entry);
+      } else {
+        CruLogDebug(kLogTag, "Ignore unknown element {} of theme.",
+                    c->GetTag());
+      }
+    } else {
+      CruLogDebug(kLogTag, "Ignore text or comment node of theme.");
+    }
+  }
+}
 }  // namespace cru::ui
@@ -32,7 +32,7 @@ void Input::SetValidator(IInputValidator* validator) {
 
 InputValidateResult Input::Validate() {
   if (validator_)
-    last_validate_result_ = validator_->Validate(text_box_.GetTextView());
+    last_validate_result_ = validator_->Validate(text_box_.GetText());
   else
     last_validate_result_ = {true, "Good value"};
   return last_validate_result_;
@@ -99,6 +99,20 @@ controls::Control* Control::HitTest(const Point& point) {
 }
 
 void Control::InsertChildAt(Control* control, Index index) {
+  InsertChildWithoutRelayout(control, index);
+  if (host_) {
+    host_->ScheduleRelayout();
+  }
+}
+
+void Control::RemoveChildAt(Index index) {
+  RemoveChildWithoutRelayout(index);
+  if (host_) {
+    host_->ScheduleRelayout();
+  }
+}
+
+void Control::InsertChildWithoutRelayout(Control* control, Index index) {
   if (index < 0 || index > children_.size()) {
     throw Exception("Child control index out of range.");
   }
@@ -124,13 +138,9 @@ void Control::InsertChildAt(Control* control, Index index) {
         },
         true);
   }
-
-  if (host_) {
-    host_->ScheduleRelayout();
-  }
 }
 
-void Control::RemoveChildAt(Index index) {
+void Control::RemoveChildWithoutRelayout(Index index) {
   if (index < 0 || index >= children_.size()) {
     throw Exception("Child control index out of range.");
   }
@@ -153,10 +163,6 @@ void Control::RemoveChildAt(Index index) {
         },
         true);
   }
-
-  if (host_) {
-    host_->ScheduleRelayout();
-  }
 }
 
 void Control::AddChild(Control* control) {
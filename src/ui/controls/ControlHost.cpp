@@ -1,12 +1,15 @@
 #include "cru/ui/controls/ControlHost.h"
 
 #include "cru/base/log/Logger.h"
+#include "cru/platform/graphics/Factory.h"
 #include "cru/platform/gui/UiApplication.h"
 #include "cru/platform/gui/Window.h"
 #include "cru/ui/Base.h"
+#include "cru/ui/DebugFlags.h"
 #include "cru/ui/render/RenderObject.h"
 
 #include <cassert>
+#include <chrono>
 
 namespace cru::ui::controls {
 ControlHost::ControlHost(Control* root_control)
@@ -16,7 +19,12 @@ ControlHost::ControlHost(Control* root_control)
       focus_control_(root_control),
       mouse_hover_control_(nullptr),
       mouse_captured_control_(nullptr),
-      layout_prefer_to_fill_window_(true) {
+      layout_prefer_to_fill_window_(true),
+      paint_flashing_enabled_(debug_flags::paint_flashing),
+      paint_flashing_erasing_(false),
+      paint_flashing_color_index_(0),
+      relayout_pending_(false),
+      in_frame_relayout_(false) {
   root_control_->TraverseDescendents(
       [this](Control* control) { control->host_ = this; }, true);
 }
@@ -53,45 +61,36 @@ bool IsAncestor(Control* control, Control* ancestor) {
   return false;
 }
 
-// Ancestor at last.
-std::vector<Control*> GetAncestorList(Control* control) {
-  if (control == nullptr) return {};
+int GetDepth(Control* control) {
+  int depth = 0;
+  while ((control = control->GetParent()) != nullptr) depth++;
+  return depth;
+}
 
-  std::vector<Control*> l;
-  while (control != nullptr) {
-    l.push_back(control);
-    control = control->GetParent();
-  }
-  return l;
+// Empty rect means no area, so it should not contribute to the union.
+Rect UnionArea(const Rect& left, const Rect& right) {
+  if (left.HasNoSize()) return right;
+  if (right.HasNoSize()) return left;
+  return left.Union(right);
 }
 
+// Called on every mouse move, so walk up parents instead of building ancestor
+// lists to avoid allocation.
 Control* FindLowestCommonAncestor(Control* left, Control* right) {
   if (left == nullptr || right == nullptr) return nullptr;
 
-  auto&& left_list = GetAncestorList(left);
-  auto&& right_list = GetAncestorList(right);
-
-  // the root is different
-  if (left_list.back() != right_list.back()) return nullptr;
+  auto left_depth = GetDepth(left);
+  auto right_depth = GetDepth(right);
 
-  // find the last same control or the last control (one is ancestor of the
-  // other)
-  auto left_iter = left_list.crbegin();
-  auto right_iter = right_list.crbegin();
+  for (; left_depth > right_depth; left_depth--) left = left->GetParent();
+  for (; right_depth > left_depth; right_depth--) right = right->GetParent();
 
-  while (true) {
-    if (left_iter == left_list.crend()) {
-      return left_list.front();
-    }
-    if (right_iter == right_list.crend()) {
-      return right_list.front();
-    }
-    if (*left_iter != *right_iter) {
-      return *(--left_iter);
-    }
-    ++left_iter;
-    ++right_iter;
+  // Become nullptr together if the root is different.
+  while (left != right) {
+    left = left->GetParent();
+    right = right->GetParent();
   }
+  return left;
 }
 }  // namespace
 
@@ -128,9 +127,24 @@ ControlHost::CreateNativeWindow() {
   return std::unique_ptr<platform::gui::INativeWindow>(native_window);
 }
 
-void ControlHost::ScheduleRepaint() { native_window_->RequestRepaint(); }
+void ControlHost::ScheduleRepaint() {
+  if (in_frame_relayout_) {
+    paint_invalid_area_ = Rect(Point{}, native_window_->GetClientSize());
+    return;
+  }
+  native_window_->RequestRepaint();
+}
 
 void ControlHost::ScheduleRelayout() {
+  if (native_window_->GetFrameClock() && native_window_->IsCreated()) {
+    if (relayout_pending_) return;
+    relayout_pending_ = true;
+    // A relayout always ends with a full repaint, so request it now to get a
+    // frame.
+    native_window_->RequestRepaint();
+    return;
+  }
+
   relayout_schedule_canceler_.Reset(
       platform::gui::IUiApplication::GetInstance()->SetImmediate(
           [this] { Relayout(); }));
@@ -139,16 +153,35 @@ void ControlHost::ScheduleRelayout() {
 Rect ControlHost::GetPaintInvalidArea() { return paint_invalid_area_; }
 
 void ControlHost::AddPaintInvalidArea(const Rect& area) {
-  paint_invalid_area_ = paint_invalid_area_.Union(area);
+  if (area.HasNoSize()) return;
+  paint_invalid_area_ = UnionArea(paint_invalid_area_, area);
+  if (!in_frame_relayout_) {
+    native_window_->RequestPartialRepaint(area);
+  }
 }
 
 void ControlHost::Repaint() {
+  // Round to whole pixels so that anti-aliased edges are not left half-drawn.
+  auto area = paint_invalid_area_.RoundOut();
+  paint_invalid_area_ = {};
+  if (area.HasNoSize()) return;
+
+  if (!background_brush_) {
+    background_brush_ = platform::gui::IUiApplication::GetInstance()
+                            ->GetGraphicsFactory()
+                            ->CreateSolidColorBrush(colors::white);
+  }
+
   auto painter = native_window_->BeginPaint();
-  painter->Clear(colors::white);
-  render::RenderObjectDrawContext context{paint_invalid_area_, painter.get()};
+  painter->PushLayer(area);
+  painter->FillRectangle(area, background_brush_.get());
+  render::RenderObjectDrawContext context{area, painter.get()};
   root_control_->GetRenderObject()->Draw(context);
+  if (paint_flashing_enabled_) {
+    DrawPaintFlashing(painter.get(), area);
+  }
+  painter->PopLayer();
   painter->EndDraw();
-  paint_invalid_area_ = {};
 }
 
 void ControlHost::Relayout() {
@@ -161,6 +194,9 @@ void ControlHost::Relayout() {
 
 void ControlHost::RelayoutWithSize(const Size& available_size,
                                    bool set_window_size_to_fit_content) {
+  relayout_pending_ = false;
+  relayout_schedule_canceler_.Reset();
+
   auto render_object = root_control_->GetRenderObject();
   render_object->Measure(render::MeasureRequirement{
       available_size,
@@ -250,6 +286,58 @@ void ControlHost::SetOverrideCursor(
 
 bool ControlHost::IsInEventHandling() { return event_handling_count_; }
 
+bool ControlHost::IsPaintFlashingEnabled() const {
+  return paint_flashing_enabled_;
+}
+
+void ControlHost::SetPaintFlashingEnabled(bool value) {
+  if (value == paint_flashing_enabled_) return;
+  paint_flashing_enabled_ = value;
+  if (!value) {
+    paint_flashing_erase_canceler_.Reset();
+    paint_flashing_erasing_ = false;
+    paint_flashing_area_ = {};
+  }
+  ScheduleRepaint();
+}
+
+void ControlHost::DrawPaintFlashing(platform::graphics::IPainter* painter,
+                                    const Rect& area) {
+  if (paint_flashing_erasing_) {
+    // This repaint erases the flashing, do not flash it again.
+    paint_flashing_erasing_ = false;
+    return;
+  }
+
+  // Cycle colors so that consecutive repaints are distinguishable.
+  constexpr Color kFlashingColors[] = {
+      Color(255, 0, 0, 80), Color(0, 255, 0, 80), Color(0, 0, 255, 80),
+      Color(255, 255, 0, 80), Color(0, 255, 255, 80), Color(255, 0, 255, 80)};
+  constexpr int kFlashingColorCount =
+      sizeof(kFlashingColors) / sizeof(*kFlashingColors);
+
+  if (!paint_flashing_brush_) {
+    paint_flashing_brush_ = platform::gui::IUiApplication::GetInstance()
+                                ->GetGraphicsFactory()
+                                ->CreateSolidColorBrush();
+  }
+  paint_flashing_brush_->SetColor(
+      kFlashingColors[paint_flashing_color_index_]);
+  paint_flashing_color_index_ =
+      (paint_flashing_color_index_ + 1) % kFlashingColorCount;
+  painter->FillRectangle(area, paint_flashing_brush_.get());
+
+  paint_flashing_area_ = UnionArea(paint_flashing_area_, area);
+  paint_flashing_erase_canceler_.Reset(
+      platform::gui::IUiApplication::GetInstance()->SetTimeout(
+          std::chrono::milliseconds(300), [this] {
+            auto area = paint_flashing_area_;
+            paint_flashing_area_ = {};
+            paint_flashing_erasing_ = true;
+            AddPaintInvalidArea(area);
+          }));
+}
+
 void ControlHost::OnNativeDestroy(std::nullptr_t) {
   auto old_hover = mouse_hover_control_;
   mouse_hover_control_ = nullptr;
@@ -259,7 +347,12 @@ void ControlHost::OnNativeDestroy(std::nullptr_t) {
 
 void ControlHost::OnNativePaint1(
     const platform::gui::NativePaintEventArgs& args) {
-  AddPaintInvalidArea(args.repaint_area);
+  if (relayout_pending_) {
+    in_frame_relayout_ = true;
+    Guard in_frame_relayout_guard([this] { in_frame_relayout_ = false; });
+    Relayout();
+  }
+  paint_invalid_area_ = UnionArea(paint_invalid_area_, args.repaint_area);
   Repaint();
 }
 
@@ -397,6 +490,8 @@ void ControlHost::NotifyControlParentChange(Control* control,
                                             Control* old_parent,
                                             Control* new_parent) {
   if (new_parent == nullptr) {
+    event_dispatcher_.NotifyControlRemoved(control);
+
     if (focus_control_->HasAncestor(control)) {
       focus_control_ = old_parent;
     }
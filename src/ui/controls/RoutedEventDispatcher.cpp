@@ -0,0 +1,9 @@
+#include "cru/ui/controls/RoutedEventDispatcher.h"
+
+namespace cru::ui::controls {
+void RoutedEventDispatcher::NotifyControlRemoved(Control* control) {
+  for (auto& c : route_buffer_) {
+    if (c && c->HasAncestor(control)) c = nullptr;
+  }
+}
+}  // namespace cru::ui::controls
@@ -17,6 +17,7 @@
 #include "cru/ui/render/ScrollRenderObject.h"
 #include "cru/ui/render/TextRenderObject.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace cru::ui::controls {
@@ -25,13 +26,15 @@ using platform::gui::IUiApplication;
 
 TextControlMovePattern TextControlMovePattern::kLeft(
     "Left", helper::ShortcutKeyBind(platform::gui::KeyCode::Left),
-    [](TextHostControlService* service, [[maybe_unused]] std::string_view text,
+    [](TextHostControlService* service,
+       [[maybe_unused]] const PieceTable& text,
        [[maybe_unused]] Index current_position) {
       return service->PreviousNCharPosition(1);
     });
 TextControlMovePattern TextControlMovePattern::kRight(
     "Right", helper::ShortcutKeyBind(platform::gui::KeyCode::Right),
-    [](TextHostControlService* service, [[maybe_unused]] std::string_view text,
+    [](TextHostControlService* service,
+       [[maybe_unused]] const PieceTable& text,
        [[maybe_unused]] Index current_position) {
       return service->NextNCharPosition(1);
     });
@@ -39,7 +42,8 @@ TextControlMovePattern TextControlMovePattern::kCtrlLeft(
     "Ctrl+Left(Previous Word)",
     helper::ShortcutKeyBind(platform::gui::KeyCode::Left,
                             platform::gui::KeyModifiers::Ctrl),
-    [](TextHostControlService* service, [[maybe_unused]] std::string_view text,
+    [](TextHostControlService* service,
+       [[maybe_unused]] const PieceTable& text,
        [[maybe_unused]] Index current_position) {
       return service->PreviousNWordPosition(1);
     });
@@ -47,13 +51,14 @@ TextControlMovePattern TextControlMovePattern::kCtrlRight(
     "Ctrl+Right(Next Word)",
     helper::ShortcutKeyBind(platform::gui::KeyCode::Right,
                             platform::gui::KeyModifiers::Ctrl),
-    [](TextHostControlService* service, [[maybe_unused]] std::string_view text,
+    [](TextHostControlService* service,
+       [[maybe_unused]] const PieceTable& text,
        [[maybe_unused]] Index current_position) {
       return service->NextNWordPosition(1);
     });
 TextControlMovePattern TextControlMovePattern::kUp(
     "Up", helper::ShortcutKeyBind(platform::gui::KeyCode::Up),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       CRU_UNUSED(text)
       auto text_render_object = service->GetTextRenderObject();
@@ -68,14 +73,14 @@ TextControlMovePattern TextControlMovePattern::kUp(
     });
 TextControlMovePattern TextControlMovePattern::kDown(
     "Down", helper::ShortcutKeyBind(platform::gui::KeyCode::Down),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       auto text_render_object = service->GetTextRenderObject();
       auto current_line_index =
           text_render_object->GetLineIndexFromCharIndex(current_position);
       auto total_line_count = text_render_object->GetLineCount();
       if (current_line_index == total_line_count - 1) {
-        return static_cast<Index>(text.size());
+        return text.GetSize();
       }
       auto rect = text_render_object->TextSinglePoint(current_position, false);
       rect.top += rect.height +
@@ -86,33 +91,24 @@ TextControlMovePattern TextControlMovePattern::kDown(
     });
 TextControlMovePattern TextControlMovePattern::kHome(
     "Home(Line Begin)", helper::ShortcutKeyBind(platform::gui::KeyCode::Home),
-    []([[maybe_unused]] TextHostControlService* service, std::string_view text,
-       Index current_position) {
-      while (current_position > 0) {
-        if (text[current_position - 1] == '\n') {
-          break;
-        }
-        current_position--;
-      }
-      return current_position;
+    []([[maybe_unused]] TextHostControlService* service,
+       const PieceTable& text, Index current_position) {
+      return text.GetLineStart(text.GetLineIndex(current_position));
     });
 TextControlMovePattern TextControlMovePattern::kEnd(
     "End(Line End)", helper::ShortcutKeyBind(platform::gui::KeyCode::End),
-    []([[maybe_unused]] TextHostControlService* service, std::string_view text,
-       Index current_position) {
-      while (current_position < text.size()) {
-        if (text[current_position] == '\n') {
-          break;
-        }
-        current_position++;
-      }
-      return current_position;
+    []([[maybe_unused]] TextHostControlService* service,
+       const PieceTable& text, Index current_position) {
+      auto next_line = text.GetLineIndex(current_position) + 1;
+      if (next_line == text.GetLineCount()) return text.GetSize();
+      // Before the line feed.
+      return text.GetLineStart(next_line) - 1;
     });
 TextControlMovePattern TextControlMovePattern::kCtrlHome(
     "Ctrl+Home(Document Begin)",
     helper::ShortcutKeyBind(platform::gui::KeyCode::Home,
                             platform::gui::KeyModifiers::Ctrl),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       CRU_UNUSED(service)
       CRU_UNUSED(text)
@@ -123,16 +119,16 @@ TextControlMovePattern TextControlMovePattern::kCtrlEnd(
     "Ctrl+End(Document End)",
     helper::ShortcutKeyBind(platform::gui::KeyCode::End,
                             platform::gui::KeyModifiers::Ctrl),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       CRU_UNUSED(service)
       CRU_UNUSED(text)
       CRU_UNUSED(current_position)
-      return text.size();
+      return text.GetSize();
     });
 TextControlMovePattern TextControlMovePattern::kPageUp(
     "PageUp", helper::ShortcutKeyBind(platform::gui::KeyCode::PageUp),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       CRU_UNUSED(service)
       CRU_UNUSED(text)
@@ -141,7 +137,7 @@ TextControlMovePattern TextControlMovePattern::kPageUp(
     });
 TextControlMovePattern TextControlMovePattern::kPageDown(
     "PageDown", helper::ShortcutKeyBind(platform::gui::KeyCode::PageDown),
-    [](TextHostControlService* service, std::string_view text,
+    [](TextHostControlService* service, const PieceTable& text,
        Index current_position) {
       CRU_UNUSED(service)
       CRU_UNUSED(text)
@@ -223,9 +219,11 @@ void TextHostControlService::SetMultiLine(bool multi_line) {
 }
 
 void TextHostControlService::SetText(std::string text, bool stop_composition) {
-  this->text_ = std::move(text);
+  GetTextRenderObject()->SetText(text);
+  render_composition_range_ = std::nullopt;
+  this->text_.SetText(std::move(text));
   this->selection_ = TextRange{0, 0};
-  this->string_break_iterator_.SetText(this->text_);
+  break_window_valid_ = false;
   if (stop_composition) {
     CancelComposition();
   }
@@ -300,41 +298,97 @@ render::ScrollRenderObject* TextHostControlService::GetScrollRenderObject() {
   return this->text_host_control_->GetScrollRenderObject();
 }
 
-std::string_view TextHostControlService::GetSelectedText() {
+std::string TextHostControlService::GetSelectedText() {
   auto selection = this->GetSelection().Normalize();
-  return GetTextView().substr(selection.position, selection.count);
+  return text_.Substring(selection.position, selection.count);
 }
 
 Index TextHostControlService::NextNCharPosition(Index count) {
-  string_break_iterator_.SetCurrentPosition(GetCaretPosition());
+  auto offset = PrepareBreakIterator(GetCaretPosition());
   for (Index i = 0; i < count; ++i) {
     string_break_iterator_.NextChar();
   }
-  return string_break_iterator_.GetCurrentPosition();
+  return offset + string_break_iterator_.GetCurrentPosition();
 }
 
 Index TextHostControlService::PreviousNCharPosition(Index count) {
-  string_break_iterator_.SetCurrentPosition(GetCaretPosition());
+  auto offset = PrepareBreakIterator(GetCaretPosition());
   for (Index i = 0; i < count; ++i) {
     string_break_iterator_.PreviousChar();
   }
-  return string_break_iterator_.GetCurrentPosition();
+  return offset + string_break_iterator_.GetCurrentPosition();
 }
 
 Index TextHostControlService::NextNWordPosition(Index count) {
-  string_break_iterator_.SetCurrentPosition(GetCaretPosition());
+  auto offset = PrepareBreakIterator(GetCaretPosition());
   for (Index i = 0; i < count; ++i) {
     string_break_iterator_.NextWord();
   }
-  return string_break_iterator_.GetCurrentPosition();
+  return offset + string_break_iterator_.GetCurrentPosition();
 }
 
 Index TextHostControlService::PreviousNWordPosition(Index count) {
-  string_break_iterator_.SetCurrentPosition(GetCaretPosition());
+  auto offset = PrepareBreakIterator(GetCaretPosition());
   for (Index i = 0; i < count; ++i) {
     string_break_iterator_.PreviousWord();
   }
-  return string_break_iterator_.GetCurrentPosition();
+  return offset + string_break_iterator_.GetCurrentPosition();
+}
+
+namespace {
+// Break iterator window extends this far on each side of caret when built.
+constexpr Index kBreakWindowExtent = 4096;
+// Rebuild window when caret gets this close to an edge that is not an edge of
+// the text. So caret can move about extent minus margin before a rebuild.
+constexpr Index kBreakWindowMinMargin = 1024;
+
+bool IsUtf8ContinuationByte(char c) { return (c & 0xC0) == 0x80; }
+}  // namespace
+
+Index TextHostControlService::PrepareBreakIterator(Index position) {
+  const auto size = text_.GetSize();
+  const auto near_edge = [position, size](Index begin, Index end) {
+    return (begin != 0 && position - begin < kBreakWindowMinMargin) ||
+           (end != size && end - position < kBreakWindowMinMargin);
+  };
+
+  if (!break_window_valid_ || position < break_window_begin_ ||
+      position > break_window_end_ ||
+      near_edge(break_window_begin_, break_window_end_)) {
+    // Extend by bytes, not lines, so that the window always leaves room for
+    // the margin. Edges are moved outwards to char boundaries.
+    auto begin = std::max<Index>(position - kBreakWindowExtent, 0);
+    while (begin > 0 && IsUtf8ContinuationByte(text_.At(begin))) {
+      begin--;
+    }
+    auto end = std::min(position + kBreakWindowExtent, size);
+    while (end < size && IsUtf8ContinuationByte(text_.At(end))) {
+      end++;
+    }
+
+    string_break_iterator_.SetText(text_.Substring(begin, end - begin));
+    break_window_begin_ = begin;
+    break_window_end_ = end;
+    break_window_valid_ = true;
+    break_window_build_count_++;
+  }
+
+  string_break_iterator_.SetCurrentPosition(position - break_window_begin_);
+  return break_window_begin_;
+}
+
+void TextHostControlService::EditBreakWindow(Index position, Index count,
+                                             std::string_view text) {
+  if (!break_window_valid_) return;
+  const auto new_end =
+      break_window_end_ - count + static_cast<Index>(text.size());
+  if (position < break_window_begin_ || position + count > break_window_end_ ||
+      new_end - break_window_begin_ > 4 * kBreakWindowExtent) {
+    break_window_valid_ = false;
+    return;
+  }
+  string_break_iterator_.Replace(position - break_window_begin_, count, text);
+  break_window_end_ = new_end;
 }
 
 void TextHostControlService::SetSelection(Index caret_position) {
@@ -352,7 +406,7 @@ void TextHostControlService::SetSelection(TextRange selection,
 }
 
 void TextHostControlService::SelectAll() {
-  this->SetSelection(TextRange{0, static_cast<Index>(this->text_.size())});
+  this->SetSelection(TextRange{0, this->text_.GetSize()});
 }
 
 void TextHostControlService::ChangeSelectionEnd(Index new_end) {
@@ -371,11 +425,13 @@ void TextHostControlService::AbortSelection() {
 
 void TextHostControlService::ReplaceSelectedText(std::string_view text) {
   auto selection = GetSelection().Normalize();
-  this->text_.replace(selection.position, selection.count, text);
-  this->string_break_iterator_.SetText(this->text_);
+  RemoveRenderComposition();
+  this->text_.Replace(selection.position, selection.count, text);
+  GetTextRenderObject()->ReplaceText(selection.position, selection.count,
+                                     text);
+  EditBreakWindow(selection.position, selection.count, text);
   this->SetSelection(
       TextRange{selection.position + static_cast<Index>(text.size()), 0});
-  SyncTextRenderObject();
   text_change_event_.Raise(nullptr);
 }
 
@@ -387,10 +443,12 @@ void TextHostControlService::DeleteTextToFromCaret(Index to_position) {
 
   auto delete_range =
       TextRange::FromTwoSides(GetCaretPosition(), to_position).Normalize();
-  this->text_.erase(delete_range.position, delete_range.count);
-  this->string_break_iterator_.SetText(this->text_);
+  RemoveRenderComposition();
+  this->text_.Erase(delete_range.position, delete_range.count);
+  GetTextRenderObject()->ReplaceText(delete_range.position, delete_range.count,
+                                     {});
+  EditBreakWindow(delete_range.position, delete_range.count, {});
   this->SetSelection(TextRange{delete_range.position, 0});
-  SyncTextRenderObject();
   text_change_event_.Raise(nullptr);
 }
 
@@ -401,9 +459,9 @@ void TextHostControlService::Cut() {
 
 void TextHostControlService::Copy() {
   auto selected_text = GetSelectedText();
-  if (selected_text.size() == 0) return;
+  if (selected_text.empty()) return;
   auto clipboard = IUiApplication::GetInstance()->GetClipboard();
-  clipboard->SetText(std::string(selected_text));
+  clipboard->SetText(std::move(selected_text));
 }
 
 void TextHostControlService::Paste() {
@@ -427,25 +485,31 @@ void TextHostControlService::TearDownCaret() {
 }
 
 void TextHostControlService::CoerceSelection() {
-  this->selection_ = this->selection_.CoerceInto(0, text_.size());
+  this->selection_ = this->selection_.CoerceInto(0, text_.GetSize());
+}
+
+void TextHostControlService::RemoveRenderComposition() {
+  if (!render_composition_range_) return;
+  GetTextRenderObject()->ReplaceText(render_composition_range_->position,
+                                     render_composition_range_->count, {});
+  render_composition_range_ = std::nullopt;
 }
 
 void TextHostControlService::SyncTextRenderObject() {
   const auto text_render_object = this->GetTextRenderObject();
   const auto composition_info = this->GetCompositionInfo();
+  RemoveRenderComposition();
   if (composition_info) {
     const auto caret_position = GetCaretPosition();
-    auto text = this->text_;
-    text.insert(text.cbegin() + caret_position, composition_info->text.cbegin(),
-                composition_info->text.cend());
-    text_render_object->SetText(text);
+    text_render_object->ReplaceText(caret_position, 0, composition_info->text);
+    render_composition_range_ = TextRange{
+        caret_position, static_cast<Index>(composition_info->text.size())};
     text_render_object->SetCaretPosition(caret_position +
                                          composition_info->selection.GetEnd());
     auto selection = composition_info->selection;
     selection.position += caret_position;
     text_render_object->SetSelectionRange(selection);
   } else {
-    text_render_object->SetText(this->text_);
     text_render_object->SetCaretPosition(this->GetCaretPosition());
     text_render_object->SetSelectionRange(this->GetSelection());
   }
@@ -666,9 +730,8 @@ void TextHostControlService::SetUpShortcuts() {
     auto name = pattern.GetName();
     shortcut_hub_.RegisterShortcut(
         "Move " + name, pattern.GetKeyBind(), [this, &pattern] {
-          auto text = this->GetTextView();
           auto caret = this->GetCaretPosition();
-          auto new_position = pattern.Move(this, text, caret);
+          auto new_position = pattern.Move(this, text_, caret);
           this->SetSelection(new_position);
           return true;
         });
@@ -677,9 +740,8 @@ void TextHostControlService::SetUpShortcuts() {
         "Move And Select " + name,
         pattern.GetKeyBind().AddModifier(platform::gui::KeyModifiers::Shift),
         [this, &pattern] {
-          auto text = this->GetTextView();
           auto caret = this->GetCaretPosition();
-          auto new_position = pattern.Move(this, text, caret);
+          auto new_position = pattern.Move(this, text_, caret);
           this->ChangeSelectionEnd(new_position);
           return true;
         });
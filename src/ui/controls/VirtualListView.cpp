@@ -0,0 +1,105 @@
+#include "cru/ui/controls/VirtualListView.h"
+
+#include "cru/base/log/Logger.h"
+
+#include <cassert>
+
+namespace cru::ui::controls {
+using render::ScrollRenderObject;
+using render::VirtualListRenderObject;
+
+VirtualListView::VirtualListView()
+    : Control(kControlName),
+      scroll_render_object_(new ScrollRenderObject()),
+      list_render_object_(new VirtualListRenderObject()) {
+  scroll_render_object_->SetChild(list_render_object_.get());
+
+  scroll_render_object_->SetAttachedControl(this);
+  list_render_object_->SetAttachedControl(this);
+
+  scroll_render_object_->ScrollOffsetChangeEvent()->AddSpyOnlyHandler(
+      [this] { list_render_object_->OnViewportChanged(); });
+}
+
+VirtualListView::~VirtualListView() {
+  // Unrealize all rows while this is still alive.
+  list_render_object_->SetRowProvider(nullptr);
+  item_controls_.clear();
+}
+
+void VirtualListView::SetModel(
+    std::shared_ptr<model::IVirtualListModel> model) {
+  if (model_ == model) return;
+
+  list_render_object_->SetRowProvider(nullptr);
+  model_change_revoker_.Reset();
+
+  model_ = std::move(model);
+
+  if (model_) {
+    assert(item_control_factory_ && item_control_binder_);
+    // Rows are recalculated lazily on next layout so a burst of changes costs
+    // only once.
+    model_change_revoker_.Reset(model_->ItemsChangedEvent()->AddSpyOnlyHandler(
+        [this] { list_render_object_->InvalidateRows(); }));
+    list_render_object_->SetRowProvider(this);
+  }
+}
+
+void VirtualListView::SetItemControlFactory(ItemControlFactory factory) {
+  item_control_factory_ = std::move(factory);
+}
+
+void VirtualListView::SetItemControlBinder(ItemControlBinder binder) {
+  item_control_binder_ = std::move(binder);
+}
+
+Control* VirtualListView::GetItemControl(Index index) {
+  auto render_object = list_render_object_->GetRealizedRow(index);
+  return render_object ? render_object->GetAttachedControl() : nullptr;
+}
+
+void VirtualListView::ScrollIntoView(Index index) {
+  auto top = list_render_object_->GetContentRect().top +
+             list_render_object_->GetRowTop(index);
+  scroll_render_object_->ScrollToContain(
+      Rect(scroll_render_object_->GetScrollOffset().x, top, 0,
+           list_render_object_->GetRowHeight(index)));
+}
+
+Index VirtualListView::GetRowCount() {
+  return model_ ? model_->GetItemCount() : 0;
+}
+
+int VirtualListView::GetRowDepth(Index index) {
+  return model_->GetItemDepth(index);
+}
+
+render::RenderObject* VirtualListView::RealizeRow(Index index) {
+  Control* control;
+  if (recycled_item_controls_.empty()) {
+    auto new_control = item_control_factory_();
+    control = new_control.get();
+    item_controls_.push_back(std::move(new_control));
+    CruLogDebug(kLogTag, "Create item control, total {}.",
+                item_controls_.size());
+  } else {
+    control = recycled_item_controls_.back();
+    recycled_item_controls_.pop_back();
+  }
+
+  item_control_binder_(control, index);
+  // Rows are realized right before measure or in layout, and laid out there,
+  // so relayout of host is not needed.
+  InsertChildWithoutRelayout(control, GetChildCount());
+  return control->GetRenderObject();
+}
+
+void VirtualListView::UnrealizeRow(Index index,
+                                   render::RenderObject* render_object) {
+  auto control = render_object->GetAttachedControl();
+  assert(control);
+  RemoveChildWithoutRelayout(IndexOfChild(control));
+  recycled_item_controls_.push_back(control);
+}
+}  // namespace cru::ui::controls
@@ -0,0 +1,115 @@
+#include "cru/ui/render/HitTestGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cru::ui::render {
+namespace {
+constexpr int kMaxColumnOrRowCount = 64;
+// Above this ratio of changed rects, rebuilding is cheaper than moving them.
+constexpr Index kUpdateMaxChangedRatio = 4;
+}  // namespace
+
+template <typename F>
+void HitTestGrid::ForEachCell(const Rect& rect, F&& f) {
+  auto column_of = [this](float x) {
+    return std::clamp(static_cast<int>((x - bounds_.left) / cell_width_), 0,
+                      column_count_ - 1);
+  };
+  auto row_of = [this](float y) {
+    return std::clamp(static_cast<int>((y - bounds_.top) / cell_height_), 0,
+                      row_count_ - 1);
+  };
+
+  auto column_end = column_of(rect.GetRight());
+  auto row_end = row_of(rect.GetBottom());
+  for (auto row = row_of(rect.top); row <= row_end; row++) {
+    for (auto column = column_of(rect.left); column <= column_end; column++) {
+      f(row * column_count_ + column);
+    }
+  }
+}
+
+void HitTestGrid::Clear() {
+  bounds_ = {};
+  column_count_ = row_count_ = 0;
+  rects_.clear();
+  cells_.clear();
+  unsized_indexes_.clear();
+}
+
+void HitTestGrid::Build(std::span<const Rect> rects) {
+  Clear();
+  rects_.assign(rects.begin(), rects.end());
+
+  bool has_bounds = false;
+  for (Index i = 0; i < static_cast<Index>(rects.size()); i++) {
+    if (rects[i].HasNoSize()) {
+      unsized_indexes_.push_back(i);
+      continue;
+    }
+    bounds_ = has_bounds ? bounds_.Union(rects[i]) : rects[i];
+    has_bounds = true;
+  }
+  if (!has_bounds) return;
+
+  auto side = std::clamp(
+      static_cast<int>(std::ceil(std::sqrt(static_cast<double>(rects.size())))),
+      1, kMaxColumnOrRowCount);
+  column_count_ = side;
+  row_count_ = side;
+  cell_width_ = bounds_.width / column_count_;
+  cell_height_ = bounds_.height / row_count_;
+
+  cells_.resize(column_count_ * row_count_);
+  for (Index i = 0; i < static_cast<Index>(rects.size()); i++) {
+    if (rects[i].HasNoSize()) continue;
+    ForEachCell(rects[i], [this, i](int cell) { cells_[cell].push_back(i); });
+  }
+}
+
+void HitTestGrid::Update(std::span<const Rect> rects) {
+  if (rects.size() != rects_.size() || cells_.empty()) {
+    Build(rects);
+    return;
+  }
+
+  std::vector<Index> changed;
+  for (Index i = 0; i < static_cast<Index>(rects.size()); i++) {
+    const auto& old_rect = rects_[i];
+    const auto& new_rect = rects[i];
+    if (old_rect == new_rect) continue;
+    if (old_rect.HasNoSize() || new_rect.HasNoSize() ||
+        bounds_.Union(new_rect) != bounds_ ||
+        static_cast<Index>(changed.size()) * kUpdateMaxChangedRatio >=
+            static_cast<Index>(rects.size())) {
+      Build(rects);
+      return;
+    }
+    changed.push_back(i);
+  }
+
+  for (auto i : changed) {
+    ForEachCell(rects_[i], [this, i](int cell) {
+      auto& indexes = cells_[cell];
+      indexes.erase(std::ranges::lower_bound(indexes, i));
+    });
+    rects_[i] = rects[i];
+    ForEachCell(rects_[i], [this, i](int cell) {
+      auto& indexes = cells_[cell];
+      indexes.insert(std::ranges::lower_bound(indexes, i), i);
+    });
+  }
+}
+
+std::span<const Index> HitTestGrid::Query(const Point& point) const {
+  if (cells_.empty() || !bounds_.IsPointInside(point)) return {};
+  auto column = std::min(
+      static_cast<int>((point.x - bounds_.left) / cell_width_),
+      column_count_ - 1);
+  auto row = std::min(static_cast<int>((point.y - bounds_.top) / cell_height_),
+                      row_count_ - 1);
+  return cells_[row * column_count_ + column];
+}
+
+}  // namespace cru::ui::render
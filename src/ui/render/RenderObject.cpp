@@ -49,10 +49,11 @@ Point RenderObject::GetTotalOffset() {
   RenderObject* render_object = this;
 
   while (render_object != nullptr) {
-    const auto o = render_object->GetOffset();
-    result.x += o.x;
-    result.y += o.y;
+    result += render_object->GetOffset();
     render_object = render_object->GetParent();
+    if (render_object != nullptr) {
+      result += render_object->GetChildTranslation();
+    }
   }
 
   return result;
@@ -171,6 +172,12 @@ Rect RenderObject::GetContentRect() {
 
 Rect RenderObject::GetRenderRect() { return GetContentRect(); }
 
+Rect RenderObject::UnionHitTestBounds(const Rect& bounds, const Rect& other) {
+  if (other.width <= 0 || other.height <= 0) return bounds;
+  if (bounds.width <= 0 || bounds.height <= 0) return other;
+  return bounds.Union(other);
+}
+
 void RenderObject::Draw(RenderObjectDrawContext& context) {
   if (!context.paint_invalid_area.IsIntersect(GetRenderRect())) {
     return;
@@ -194,8 +201,10 @@ void RenderObject::InvalidateLayout() {
 
 void RenderObject::InvalidatePaint() {
   if (auto host = GetControlHost()) {
-    host->AddPaintInvalidArea(GetRenderRect().WithOffset(GetTotalOffset()));
-    host->ScheduleRepaint();
+    // Expand a little to cover anti-aliased edges and caret drawn on border.
+    host->AddPaintInvalidArea(GetRenderRect()
+                                  .WithOffset(GetTotalOffset())
+                                  .Expand(Thickness(kPaintInvalidAreaMargin)));
   }
 }
 
@@ -6,6 +6,7 @@
 #include "cru/ui/render/ScrollBar.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <optional>
 
@@ -73,14 +74,30 @@ void ScrollRenderObject::ApplyScroll(const struct Scroll& scroll) {
 
 RenderObject* ScrollRenderObject::HitTest(const Point& point) {
   if (auto child = GetChild()) {
-    const auto offset = child->GetOffset();
+    const auto offset = child->GetOffset() + GetChildTranslation();
     const auto r = child->HitTest(point - offset);
     if (r != nullptr) return r;
   }
 
   const auto rect = GetPaddingRect();
   return rect.IsPointInside(point) ? this : nullptr;
-}  // namespace cru::ui::render
+}
+
+Rect ScrollRenderObject::GetHitTestBounds() {
+  auto bounds = RenderObject::GetHitTestBounds();
+  if (auto child = GetChild()) {
+    const auto child_bounds =
+        child->GetHitTestBounds().WithOffset(child->GetOffset());
+    const auto max_scroll = CoerceScroll(
+        Point(std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max()),
+        GetContentRect().GetSize(), child->GetSize());
+    bounds = UnionHitTestBounds(bounds, child_bounds);
+    bounds = UnionHitTestBounds(bounds,
+                                child_bounds.WithOffset(max_scroll.Negate()));
+  }
+  return bounds;
+}
 
 Point ScrollRenderObject::GetScrollOffset() {
   if (auto child = GetChild()) {
@@ -92,25 +109,27 @@ Point ScrollRenderObject::GetScrollOffset() {
 }
 
 void ScrollRenderObject::SetScrollOffset(const Point& offset) {
-  scroll_offset_ = offset;
-  InvalidateLayout();
+  SetScrollOffset(std::optional<float>(offset.x),
+                  std::optional<float>(offset.y));
 }
 
 void ScrollRenderObject::SetScrollOffset(std::optional<float> x,
                                          std::optional<float> y) {
-  bool dirty = false;
+  const auto old_offset = GetScrollOffset();
 
   if (x.has_value()) {
-    dirty = true;
     scroll_offset_.x = *x;
   }
 
   if (y.has_value()) {
-    dirty = true;
     scroll_offset_.y = *y;
   }
 
-  if (dirty) InvalidateLayout();
+  // Layout of child does not depend on scroll offset, only repaint.
+  if (GetScrollOffset() != old_offset) {
+    InvalidatePaint();
+    ScrollOffsetChangeEvent_.Raise(nullptr);
+  }
 }
 
 void ScrollRenderObject::ScrollToContain(const Rect& rect,
@@ -167,15 +186,23 @@ Size ScrollRenderObject::OnMeasureContent(
 
 void ScrollRenderObject::OnLayoutContent(const Rect& content_rect) {
   if (auto child = GetChild()) {
-    child->Layout(content_rect.GetLeftTop() - GetScrollOffset());
+    child->Layout(content_rect.GetLeftTop());
   }
 }
 
 void ScrollRenderObject::OnDraw(RenderObjectDrawContext& context) {
   auto painter = context.painter;
   if (auto child = GetChild()) {
+    const auto translation = GetChildTranslation();
     painter->PushLayer(this->GetContentRect());
+    painter->PushState();
+    painter->ConcatTransform(Matrix::Translation(translation));
+    context.paint_invalid_area = context.paint_invalid_area.WithOffset(
+        translation.Negate());
     context.DrawChild(child);
+    context.paint_invalid_area =
+        context.paint_invalid_area.WithOffset(translation);
+    painter->PopState();
     painter->PopLayer();
   }
   scroll_bar_delegate_->DrawScrollBar(painter);
@@ -19,6 +19,16 @@ void SingleChildRenderObject::SetChild(RenderObject* new_child) {
   OnChildChanged(old_child, new_child);
 }
 
+Rect SingleChildRenderObject::GetHitTestBounds() {
+  auto bounds = RenderObject::GetHitTestBounds();
+  if (child_) {
+    bounds = UnionHitTestBounds(
+        bounds, child_->GetHitTestBounds().WithOffset(child_->GetOffset() +
+                                                      GetChildTranslation()));
+  }
+  return bounds;
+}
+
 void SingleChildRenderObject::OnChildChanged(RenderObject* old_child,
                                              RenderObject* new_child) {
   InvalidateLayout();
@@ -5,6 +5,7 @@
 #include "cru/platform/gui/UiApplication.h"
 #include "cru/ui/render/RenderObject.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace cru::ui::render {
@@ -32,7 +33,19 @@ TextRenderObject::TextRenderObject(
 std::string TextRenderObject::GetText() { return text_layout_->GetText(); }
 
 void TextRenderObject::SetText(std::string new_text) {
+  text_size_ = static_cast<Index>(new_text.size());
   text_layout_->SetText(std::move(new_text));
+  InvalidateTextMeasure();
+  InvalidateLayout();
+}
+
+void TextRenderObject::ReplaceText(Index position, Index count,
+                                   std::string_view text) {
+  CheckArgumentRange(position, 0, text_size_, "position", true);
+  CheckArgumentRange(count, 0, text_size_ - position, "count", true);
+  text_layout_->ReplaceText(position, count, text);
+  text_size_ += static_cast<Index>(text.size()) - count;
+  InvalidateTextMeasure();
   InvalidateLayout();
 }
 
@@ -51,6 +64,7 @@ void TextRenderObject::SetFont(
     std::shared_ptr<platform::graphics::IFont> font) {
   Expects(font);
   text_layout_->SetFont(std::move(font));
+  InvalidateTextMeasure();
   InvalidateLayout();
 }
 
@@ -61,6 +75,23 @@ void TextRenderObject::SetEditMode(bool enable) {
   InvalidateLayout();
 }
 
+void TextRenderObject::SetAttributes(
+    std::vector<platform::graphics::TextAttribute> attributes) {
+  const auto has_shaping_attributes = std::ranges::any_of(
+      attributes, [](const platform::graphics::TextAttribute& attribute) {
+        return attribute.weight != platform::graphics::FontWeight::Normal ||
+               attribute.style != platform::graphics::FontStyle::Normal;
+      });
+  const auto relayout = has_shaping_attributes || has_shaping_attributes_;
+  has_shaping_attributes_ = has_shaping_attributes;
+  text_layout_->SetAttributes(std::move(attributes));
+  if (relayout) {
+    InvalidateLayout();
+  } else {
+    InvalidatePaint();
+  }
+}
+
 Index TextRenderObject::GetLineCount() { return text_layout_->GetLineCount(); }
 
 Index TextRenderObject::GetLineIndexFromCharIndex(Index char_index) {
@@ -134,7 +165,7 @@ void TextRenderObject::SetCaretWidth(const float width) {
 
 Rect TextRenderObject::GetCaretRectInContent() {
   auto caret_pos = this->caret_position_;
-  Index text_size = this->GetText().size();
+  Index text_size = this->text_size_;
   if (caret_pos < 0) {
     caret_pos = 0;
   } else if (caret_pos > text_size) {
@@ -176,18 +207,60 @@ RenderObject* TextRenderObject::HitTest(const Point& point) {
 Size TextRenderObject::OnMeasureContent(const MeasureRequirement& requirement) {
   float measure_width = requirement.suggest.width.GetLengthOr(
       requirement.max.width.GetLengthOrMaxFloat());
+  measure_width_ = measure_width;
+
+  Size result;
+  if (IsEditMode() || is_measure_including_trailing_space_ ||
+      has_shaping_attributes_) {
+    SetTextLayoutMaxWidth(measure_width);
+    result = Size(
+        text_layout_->GetTextBounds(is_measure_including_trailing_space_)
+            .GetRightBottom());
+  } else {
+    result = MeasureText(measure_width);
+  }
 
-  text_layout_->SetMaxWidth(measure_width);
-  text_layout_->SetMaxHeight(std::numeric_limits<float>::max());
-
-  Size result(text_layout_->GetTextBounds(is_measure_including_trailing_space_)
-                  .GetRightBottom());
   result = requirement.ExpandToSuggestAndCoerce(result);
   return result;
 }
 
 void TextRenderObject::OnLayoutContent(const Rect& content_rect) {
   CRU_UNUSED(content_rect)
+  SetTextLayoutMaxWidth(measure_width_);
+}
+
+Size TextRenderObject::MeasureText(float max_width) {
+  const auto graph_factory =
+      platform::gui::IUiApplication::GetInstance()->GetGraphicsFactory();
+
+  if (!text_measure_) {
+    text_measure_ =
+        graph_factory->MeasureText(GetFont(), text_layout_->GetTextView());
+  }
+  if (max_width >= text_measure_->max_content_width) {
+    return Size(text_measure_->max_content_width,
+                text_measure_->max_content_height);
+  }
+
+  if (!width_measure_ || width_measure_->first != max_width) {
+    width_measure_.emplace(
+        max_width,
+        graph_factory->MeasureTextForWidth(
+            GetFont(), text_layout_->GetTextView(), max_width));
+  }
+  return width_measure_->second;
+}
+
+void TextRenderObject::SetTextLayoutMaxWidth(float max_width) {
+  if (text_layout_max_width_ == max_width) return;
+  text_layout_max_width_ = max_width;
+  text_layout_->SetMaxWidth(max_width);
+  text_layout_->SetMaxHeight(std::numeric_limits<float>::max());
+}
+
+void TextRenderObject::InvalidateTextMeasure() {
+  text_measure_.reset();
+  width_measure_.reset();
 }
 
 void TextRenderObject::OnDraw(RenderObjectDrawContext& context) {
@@ -76,6 +76,27 @@ RenderObject* TreeRenderObject::HitTest(const Point& point) {
   return TreeRenderObjectItemHitTest(root_item_, point);
 }
 
+static Rect TreeRenderObjectItemHitTestBounds(TreeRenderObjectItem* item,
+                                              Rect bounds) {
+  auto render_object = item->GetRenderObject();
+  if (render_object) {
+    bounds = RenderObject::UnionHitTestBounds(
+        bounds, render_object->GetHitTestBounds().WithOffset(
+                    render_object->GetOffset()));
+  }
+
+  for (auto child : item->GetChildren()) {
+    bounds = TreeRenderObjectItemHitTestBounds(child, bounds);
+  }
+
+  return bounds;
+}
+
+Rect TreeRenderObject::GetHitTestBounds() {
+  return TreeRenderObjectItemHitTestBounds(root_item_,
+                                           RenderObject::GetHitTestBounds());
+}
+
 void TreeRenderObjectItemDraw(TreeRenderObjectItem* item,
                               RenderObjectDrawContext& context) {
   auto render_object = item->GetRenderObject();
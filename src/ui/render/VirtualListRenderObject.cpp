@@ -0,0 +1,262 @@
+#include "cru/ui/render/VirtualListRenderObject.h"
+#include "cru/base/log/Logger.h"
+#include "cru/ui/render/MeasureRequirement.h"
+#include "cru/ui/render/RenderObject.h"
+#include "cru/ui/render/ScrollRenderObject.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace cru::ui::render {
+namespace {
+// Extra height above and below viewport to realize, relative to viewport
+// height, so that small scrolls need no relayout.
+constexpr float kOverscanRatio = 0.5f;
+}  // namespace
+
+VirtualListRenderObject::VirtualListRenderObject()
+    : RenderObject(kRenderObjectName) {}
+
+VirtualListRenderObject::~VirtualListRenderObject() {
+  // Provider may already be gone, so just detach.
+  for (auto row : realized_rows_) {
+    row->SetParent(nullptr);
+  }
+}
+
+void VirtualListRenderObject::SetRowProvider(
+    IVirtualListRowProvider* provider) {
+  if (row_provider_ == provider) return;
+  UnrealizeAllRows();
+  row_provider_ = provider;
+  InvalidateRows();
+}
+
+void VirtualListRenderObject::SetEstimatedRowHeight(float height) {
+  if (estimated_row_height_ == height) return;
+  estimated_row_height_ = height;
+  InvalidateRows();
+}
+
+void VirtualListRenderObject::SetIndentWidth(float width) {
+  if (indent_width_ == width) return;
+  indent_width_ = width;
+  // Widths include indent, so realized rows measure them again.
+  std::ranges::fill(row_widths_, 0.f);
+  max_row_width_ = 0.f;
+  InvalidateLayout();
+}
+
+void VirtualListRenderObject::InvalidateRows() {
+  UnrealizeAllRows();
+  rows_valid_ = false;
+  InvalidateLayout();
+}
+
+void VirtualListRenderObject::OnViewportChanged() {
+  if (!rows_valid_) return;
+  auto range = CalculateRowRange(0);
+  if (range.GetStart() < realized_start_ ||
+      range.GetEnd() > realized_start_ + GetRealizedRowCount()) {
+    // Realize here instead of in layout, so that the coming relayout measures
+    // new rows in one pass.
+    RealizeRows(CalculateRowRange(kOverscanRatio));
+    InvalidateLayout();
+  }
+}
+
+RenderObject* VirtualListRenderObject::GetRealizedRow(Index index) {
+  auto i = index - realized_start_;
+  if (i < 0 || i >= GetRealizedRowCount()) return nullptr;
+  return realized_rows_[i];
+}
+
+float VirtualListRenderObject::GetRowTop(Index index) {
+  EnsureRows();
+  return row_heights_.GetPrefixSum(index);
+}
+
+float VirtualListRenderObject::GetRowHeight(Index index) {
+  EnsureRows();
+  return row_heights_.Get(index);
+}
+
+Index VirtualListRenderObject::GetRowIndexAt(float y) {
+  EnsureRows();
+  return row_heights_.FindIndex(y);
+}
+
+RenderObject* VirtualListRenderObject::HitTest(const Point& point) {
+  for (auto row : realized_rows_) {
+    auto result = row->HitTest(point - row->GetOffset());
+    if (result) return result;
+  }
+  return GetPaddingRect().IsPointInside(point) ? this : nullptr;
+}
+
+Rect VirtualListRenderObject::GetHitTestBounds() {
+  auto bounds = RenderObject::GetHitTestBounds();
+  for (auto row : realized_rows_) {
+    bounds = UnionHitTestBounds(
+        bounds, row->GetHitTestBounds().WithOffset(row->GetOffset()));
+  }
+  return bounds;
+}
+
+Size VirtualListRenderObject::OnMeasureContent(
+    const MeasureRequirement& requirement) {
+  EnsureRows();
+  // Usually a no-op. Realize before measuring so that layout finds rows
+  // already realized and measured.
+  RealizeRows(CalculateRowRange(kOverscanRatio));
+
+  for (Index i = 0; i < GetRealizedRowCount(); i++) {
+    auto index = realized_start_ + i;
+    auto row = realized_rows_[i];
+    row->Measure(GetRowMeasureRequirement());
+    auto size = row->GetMeasureResultSize();
+    row_heights_.Set(index, size.height);
+    SetRowWidth(index,
+                row_provider_->GetRowDepth(index) * indent_width_ + size.width);
+  }
+
+  return requirement.ExpandToSuggestAndCoerce(
+      Size(max_row_width_, row_heights_.GetTotal()));
+}
+
+void VirtualListRenderObject::OnLayoutContent(const Rect& content_rect) {
+  EnsureRows();
+
+  auto old_total_height = row_heights_.GetTotal();
+  auto old_max_row_width = max_row_width_;
+
+  // Only does something if viewport is resized by this layout.
+  RealizeRows(CalculateRowRange(kOverscanRatio));
+
+  float top = row_heights_.GetPrefixSum(realized_start_);
+  for (Index i = 0; i < GetRealizedRowCount(); i++) {
+    auto index = realized_start_ + i;
+    auto row = realized_rows_[i];
+    // Cached if the row is already measured.
+    row->Measure(GetRowMeasureRequirement());
+    auto size = row->GetMeasureResultSize();
+    auto indent = row_provider_->GetRowDepth(index) * indent_width_;
+    row_heights_.Set(index, size.height);
+    SetRowWidth(index, indent + size.width);
+    row->Layout(Point(content_rect.left + indent, content_rect.top + top));
+    top += size.height;
+  }
+
+  if (row_heights_.GetTotal() != old_total_height ||
+      max_row_width_ != old_max_row_width) {
+    CruLogDebug(kLogTag,
+                "Estimated row heights are replaced by real ones, measure "
+                "again to update scroll extent.");
+    relayout_canceler_.Reset(
+        platform::gui::IUiApplication::GetInstance()->SetImmediate(
+            [this] { InvalidateLayout(); }));
+  }
+}
+
+void VirtualListRenderObject::OnDraw(RenderObjectDrawContext& context) {
+  for (auto row : realized_rows_) {
+    context.DrawChild(row);
+  }
+}
+
+Rect VirtualListRenderObject::GetViewport() {
+  if (auto scroll = dynamic_cast<ScrollRenderObject*>(GetParent())) {
+    return scroll->GetViewRect().WithOffset(
+        GetContentRect().GetLeftTop().Negate());
+  }
+  constexpr auto kMax = std::numeric_limits<float>::max();
+  return Rect(0, 0, kMax, kMax);
+}
+
+Range VirtualListRenderObject::CalculateRowRange(float overscan_ratio) {
+  auto count = row_heights_.GetCount();
+  if (count == 0) return {};
+
+  auto viewport = GetViewport();
+  if (viewport.height == std::numeric_limits<float>::max()) {
+    return Range(0, count);
+  }
+
+  auto overscan = viewport.height * overscan_ratio;
+  auto start = row_heights_.FindIndex(std::max(viewport.top - overscan, 0.f));
+  auto end = row_heights_.FindIndex(viewport.GetBottom() + overscan) + 1;
+  return Range::FromTwoSides(std::min(start, count), std::min(end, count));
+}
+
+void VirtualListRenderObject::EnsureRows() {
+  if (rows_valid_) return;
+  assert(realized_rows_.empty());
+  const auto count = row_provider_ ? row_provider_->GetRowCount() : 0;
+  row_heights_.Reset(count, estimated_row_height_);
+  row_widths_.assign(count, 0.f);
+  max_row_width_ = 0.f;
+  rows_valid_ = true;
+}
+
+void VirtualListRenderObject::RealizeRows(const Range& range) {
+  if (range.GetStart() == realized_start_ &&
+      range.count == GetRealizedRowCount()) {
+    return;
+  }
+
+  std::vector<RenderObject*> new_rows(range.count, nullptr);
+
+  for (Index i = 0; i < GetRealizedRowCount(); i++) {
+    auto index = realized_start_ + i;
+    auto row = realized_rows_[i];
+    if (index >= range.GetStart() && index < range.GetEnd()) {
+      new_rows[index - range.GetStart()] = row;
+    } else {
+      row->SetParent(nullptr);
+      row_provider_->UnrealizeRow(index, row);
+    }
+  }
+
+  for (Index i = 0; i < range.count; i++) {
+    if (new_rows[i] == nullptr) {
+      auto row = row_provider_->RealizeRow(range.GetStart() + i);
+      assert(row->GetParent() == nullptr);
+      row->SetParent(this);
+      new_rows[i] = row;
+    }
+  }
+
+  realized_start_ = range.GetStart();
+  realized_rows_ = std::move(new_rows);
+}
+
+void VirtualListRenderObject::UnrealizeAllRows() {
+  for (Index i = 0; i < GetRealizedRowCount(); i++) {
+    auto row = realized_rows_[i];
+    row->SetParent(nullptr);
+    if (row_provider_) {
+      row_provider_->UnrealizeRow(realized_start_ + i, row);
+    }
+  }
+  realized_rows_.clear();
+  realized_start_ = 0;
+}
+
+void VirtualListRenderObject::SetRowWidth(Index index, float width) {
+  auto old_width = row_widths_[index];
+  row_widths_[index] = width;
+  if (width >= max_row_width_) {
+    max_row_width_ = width;
+  } else if (old_width == max_row_width_) {
+    // The widest row narrowed, which is rare enough for a full scan.
+    max_row_width_ = std::ranges::max(row_widths_);
+  }
+}
+
+MeasureRequirement VirtualListRenderObject::GetRowMeasureRequirement() {
+  return MeasureRequirement(MeasureSize::NotSpecified(),
+                            MeasureSize::NotSpecified(),
+                            MeasureSize::NotSpecified());
+}
+}  // namespace cru::ui::render
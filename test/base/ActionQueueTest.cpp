@@ -0,0 +1,77 @@
+#include "cru/base/ActionQueue.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using cru::MpscActionQueue;
+
+TEST_CASE("MpscActionQueue Works", "[action-queue]") {
+  MpscActionQueue queue;
+  std::vector<int> result;
+
+  REQUIRE(queue.Push([&] { result.push_back(1); }) == 0);
+  REQUIRE(queue.Push([&] { result.push_back(2); }) == 1);
+
+  // Too large to be stored inline.
+  std::array<int, 64> large{};
+  large[63] = 3;
+  queue.Push([&result, large] { result.push_back(large[63]); });
+  REQUIRE(queue.GetSize() == 3);
+
+  REQUIRE(queue.RunSome(2) == 2);
+  REQUIRE(result == std::vector<int>{1, 2});
+  REQUIRE(queue.RunSome(10) == 1);
+  REQUIRE(result == std::vector<int>{1, 2, 3});
+  REQUIRE(queue.RunSome(10) == 0);
+  REQUIRE(queue.GetSize() == 0);
+}
+
+TEST_CASE("MpscActionQueue Drops Actions On Destruction", "[action-queue]") {
+  auto counter = std::make_shared<int>(0);
+  {
+    MpscActionQueue queue;
+    queue.Push([counter] { (*counter)++; });
+    REQUIRE(counter.use_count() == 2);
+  }
+  REQUIRE(counter.use_count() == 1);
+  REQUIRE(*counter == 0);
+}
+
+TEST_CASE("MpscActionQueue Multiple Producers", "[action-queue]") {
+  constexpr int kProducerCount = 4;
+  constexpr int kActionCount = 20000;
+
+  MpscActionQueue queue;
+  std::vector<int> last(kProducerCount, -1);
+  bool in_order = true;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducerCount; p++) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kActionCount; i++) {
+        queue.Push([&, p, i] {
+          if (last[p] + 1 != i) in_order = false;
+          last[p] = i;
+        });
+      }
+    });
+  }
+
+  int total = 0;
+  while (total < kProducerCount * kActionCount) {
+    total += queue.RunSome(100);
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  REQUIRE(in_order);
+  REQUIRE(queue.GetSize() == 0);
+  for (int p = 0; p < kProducerCount; p++) {
+    REQUIRE(last[p] == kActionCount - 1);
+  }
+}
@@ -0,0 +1,97 @@
+#include "cru/base/PieceTable.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+using cru::Index;
+using cru::PieceTable;
+
+namespace {
+Index CountLineFeeds(const std::string& str, Index end) {
+  return std::count(str.cbegin(), str.cbegin() + end, '\n');
+}
+}  // namespace
+
+TEST_CASE("PieceTable", "[piece-table]") {
+  PieceTable table("ab\ncd\nef");
+
+  SECTION("Constructor should keep the text.") {
+    REQUIRE(table.GetSize() == 8);
+    REQUIRE(table.ToString() == "ab\ncd\nef");
+    REQUIRE(table.GetLineCount() == 3);
+    REQUIRE(table.At(3) == 'c');
+  }
+
+  SECTION("Insert and erase should edit the text.") {
+    table.Insert(4, "XY\nZ");
+    REQUIRE(table.ToString() == "ab\ncXY\nZd\nef");
+    REQUIRE(table.GetLineCount() == 4);
+    table.Erase(1, 5);
+    REQUIRE(table.ToString() == "a\nZd\nef");
+    table.Replace(0, 1, "123");
+    REQUIRE(table.ToString() == "123\nZd\nef");
+  }
+
+  SECTION("Line start and index should map line feeds.") {
+    REQUIRE(table.GetLineStart(0) == 0);
+    REQUIRE(table.GetLineStart(1) == 3);
+    REQUIRE(table.GetLineStart(2) == 6);
+    REQUIRE(table.GetLineIndex(2) == 0);
+    REQUIRE(table.GetLineIndex(3) == 1);
+    REQUIRE(table.GetLineIndex(8) == 2);
+  }
+
+  SECTION("Substring and ForEachChunk should read across pieces.") {
+    table.Insert(2, "__");
+    REQUIRE(table.Substring(1, 4) == "b__\n");
+    std::string chunks;
+    table.ForEachChunk(1, 4, [&chunks](std::string_view chunk) {
+      chunks.append(chunk);
+      chunks.push_back('|');
+    });
+    REQUIRE(chunks == "b|__|\n|");
+  }
+
+  SECTION("Out of range should throw.") {
+    REQUIRE_THROWS(table.Insert(9, "x"));
+    REQUIRE_THROWS(table.Erase(7, 2));
+    REQUIRE_THROWS(table.GetLineStart(3));
+  }
+}
+
+TEST_CASE("PieceTable random edits", "[piece-table]") {
+  std::mt19937 random(42);
+  std::string expected = "0123\n4567\n89";
+  PieceTable table(expected);
+
+  for (int i = 0; i < 2000; i++) {
+    auto size = static_cast<Index>(expected.size());
+    auto position = std::uniform_int_distribution<Index>(0, size)(random);
+    if (random() % 3 != 0 || size == 0) {
+      std::string text(random() % 5 + 1, static_cast<char>('a' + random() % 26));
+      if (random() % 4 == 0) text.back() = '\n';
+      expected.insert(position, text);
+      table.Insert(position, text);
+    } else {
+      auto count = std::uniform_int_distribution<Index>(
+          0, std::min<Index>(8, size - position))(random);
+      expected.erase(position, count);
+      table.Erase(position, count);
+    }
+  }
+
+  REQUIRE(table.ToString() == expected);
+  auto size = static_cast<Index>(expected.size());
+  REQUIRE(table.GetLineCount() == CountLineFeeds(expected, size) + 1);
+  for (Index position = 0; position <= size; position++) {
+    REQUIRE(table.GetLineIndex(position) == CountLineFeeds(expected, position));
+  }
+  for (Index line = 1; line < table.GetLineCount(); line++) {
+    auto start = table.GetLineStart(line);
+    REQUIRE(expected[start - 1] == '\n');
+    REQUIRE(CountLineFeeds(expected, start) == line);
+  }
+}
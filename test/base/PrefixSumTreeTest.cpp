@@ -0,0 +1,58 @@
+#include "cru/base/PrefixSumTree.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using cru::PrefixSumTree;
+
+TEST_CASE("PrefixSumTree", "[prefix-sum-tree]") {
+  PrefixSumTree<int> tree(5, 10);
+
+  SECTION("Reset should fill all values.") {
+    REQUIRE(tree.GetCount() == 5);
+    REQUIRE(tree.Get(3) == 10);
+    REQUIRE(tree.GetPrefixSum(0) == 0);
+    REQUIRE(tree.GetPrefixSum(3) == 30);
+    REQUIRE(tree.GetTotal() == 50);
+  }
+
+  SECTION("Set should update prefix sums.") {
+    tree.Set(1, 20);
+    tree.Set(4, 0);
+    REQUIRE(tree.Get(1) == 20);
+    REQUIRE(tree.GetPrefixSum(1) == 10);
+    REQUIRE(tree.GetPrefixSum(2) == 30);
+    REQUIRE(tree.GetTotal() == 50);
+  }
+
+  SECTION("FindIndex should find the containing index.") {
+    tree.Set(1, 20);
+    REQUIRE(tree.FindIndex(0) == 0);
+    REQUIRE(tree.FindIndex(9) == 0);
+    REQUIRE(tree.FindIndex(10) == 1);
+    REQUIRE(tree.FindIndex(29) == 1);
+    REQUIRE(tree.FindIndex(30) == 2);
+    REQUIRE(tree.FindIndex(59) == 4);
+    REQUIRE(tree.FindIndex(60) == 5);
+  }
+
+  SECTION("Assign should replace all values.") {
+    tree.Assign({1, 2, 3});
+    REQUIRE(tree.GetCount() == 3);
+    REQUIRE(tree.Get(2) == 3);
+    REQUIRE(tree.GetPrefixSum(2) == 3);
+    REQUIRE(tree.GetTotal() == 6);
+    REQUIRE(tree.FindIndex(3) == 2);
+  }
+
+  SECTION("Out of range index should throw.") {
+    REQUIRE_THROWS(tree.Get(5));
+    REQUIRE_THROWS(tree.Set(-1, 0));
+  }
+}
+
+TEST_CASE("PrefixSumTree empty", "[prefix-sum-tree]") {
+  PrefixSumTree<float> tree;
+  REQUIRE(tree.GetCount() == 0);
+  REQUIRE(tree.GetTotal() == 0.f);
+  REQUIRE(tree.FindIndex(1.f) == 0);
+}
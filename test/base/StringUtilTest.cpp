@@ -1,6 +1,9 @@
 #include "cru/base/StringUtil.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <format>
+#include <random>
 #include <string_view>
 
 using cru::Index;
@@ -13,6 +16,24 @@ TEST_CASE("StringUtil Split", "[string]") {
   REQUIRE(Split("aaa", "a") == std::vector<std::string>{"", "", "", ""});
 }
 
+TEST_CASE("StringUtil SplitView", "[string]") {
+  std::string_view text = " a , b ,, ";
+  auto result = SplitView(text, ",", SplitOptions::RemoveEmptyAndSpace |
+                                         SplitOptions::Trim);
+  REQUIRE(result == std::vector<std::string_view>{"a", "b"});
+  REQUIRE(result[0].data() == text.data() + 1);
+}
+
+TEST_CASE("StringUtil CaseInsensitiveEqual", "[string]") {
+  REQUIRE(CaseInsensitiveEqual("", ""));
+  REQUIRE(CaseInsensitiveEqual("Theme", "tHEME"));
+  REQUIRE(!CaseInsensitiveEqual("Theme", "Themes"));
+  REQUIRE(!CaseInsensitiveEqual("Theme", "Thema"));
+  REQUIRE(CaseInsensitiveEqual("A\xC3\x84", "a\xC3\xA4"));  // "AÄ", "aä"
+  REQUIRE(CaseInsensitiveEqual("stra\xC3\x9F" "e", "STRASSE"));  // "straße"
+  REQUIRE(CaseInsensitiveEqual("\xE2\x84\xAA", "k"));  // Kelvin sign
+}
+
 TEST_CASE("StringUtil TrimBegin", "[string]") {
   const std::string k_zh = "\xE4\xBD\xA0\xE5\xA5\xBD";  // "你好"
 
@@ -47,6 +68,15 @@ TEST_CASE("StringUtil Trim", "[string]") {
   REQUIRE(Trim(k_zh) == k_zh);
 }
 
+TEST_CASE("StringUtil TrimView", "[string]") {
+  std::string_view text = "\x1C abc\xE3\x80\x80";
+  auto result = TrimView(text);
+  REQUIRE(result == "abc");
+  REQUIRE(result.data() == text.data() + 2);
+  REQUIRE(TrimBeginView(text) == "abc\xE3\x80\x80");
+  REQUIRE(TrimEndView(text) == "\x1C abc");
+}
+
 TEST_CASE("StringUtil IsSpace", "[string]") {
   REQUIRE(IsSpace(""));
   REQUIRE(IsSpace("   \t\n"));
@@ -246,6 +276,24 @@ TEST_CASE("StringBreakIterator set text", "[string]") {
   REQUIRE(iter.GetCurrentPosition() == 0);
 }
 
+TEST_CASE("StringBreakIterator replace", "[string]") {
+  StringBreakIterator iter("hello world");
+  iter.Replace(5, 1, "π, ");
+  REQUIRE(iter.GetText() == "helloπ, world");
+  REQUIRE(iter.GetCurrentPosition() == 9);
+
+  REQUIRE(iter.NextWord() == 14);
+  REQUIRE(iter.PreviousWord() == 9);
+  REQUIRE(iter.PreviousWord() == 8);
+  REQUIRE(iter.PreviousChar() == 7);
+  REQUIRE(iter.PreviousChar() == 5);
+
+  iter.Replace(0, 9, "");
+  REQUIRE(iter.GetText() == "world");
+  REQUIRE(iter.GetCurrentPosition() == 0);
+  REQUIRE(iter.NextWord() == 5);
+}
+
 TEST_CASE("StringBreakIterator unicode char", "[string]") {
   // "aπ你🤣!" byte offsets: a=0, π=1, 你=3, 🤣=6, !=10, end=11.
   StringBreakIterator iter("aπ你🤣!");
@@ -540,3 +588,147 @@ TEST_CASE("String ParseToNumberList", "[string]") {
 //   REQUIRE(IndexUtf16ToUtf8(utf16_string, 5, utf8_string), 10);
 //   REQUIRE(IndexUtf16ToUtf8(utf16_string, 6, utf8_string), 11);
 // }
+
+namespace {
+const UtfSimdLevel kUtfSimdLevels[] = {UtfSimdLevel::Scalar,
+                                       UtfSimdLevel::Sse2, UtfSimdLevel::Avx2};
+
+std::string GenerateUtf8Text(std::minstd_rand& random, int code_point_count) {
+  // ASCII, 2-byte, 3-byte (CJK) and 4-byte (emoji) code points.
+  const CodePoint starts[] = {0x20, 0x3C0, 0x4F60, 0x1F923};
+  std::string result;
+  for (int i = 0; i < code_point_count; i++) {
+    auto code_point =
+        starts[random() % 4] + static_cast<CodePoint>(random() % 16);
+    Utf8EncodeCodePointAppend(code_point, [&result](char c) { result += c; });
+  }
+  return result;
+}
+}  // namespace
+
+TEST_CASE("StringUtil bulk UTF routines", "[string]") {
+  const auto detected_level = GetUtfSimdLevel();
+  std::minstd_rand random(1);
+
+  for (auto level : kUtfSimdLevels) {
+    SetUtfSimdLevel(level);
+
+    for (int length : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+      auto text = GenerateUtf8Text(random, length);
+      REQUIRE(Utf8IsValid(text));
+      REQUIRE(Utf8CountCodePoints(text) == length);
+
+      std::u16string expected_utf16;
+      for (auto code_point : Utf8CodePointIterator(text.data(), text.size())) {
+        Utf16EncodeCodePointAppend(
+            code_point, [&expected_utf16](char16_t c) { expected_utf16 += c; });
+      }
+      auto utf16 = Utf8ToUtf16(text);
+      REQUIRE(utf16 == expected_utf16);
+      REQUIRE(Utf16CountCodePoints(utf16) == length);
+
+      Utf8CodePointIterator utf8_iter(text.data(), text.size());
+      Utf16CodePointIterator utf16_iter(utf16.data(), utf16.size());
+      for (Index i = 0; i <= length; i++) {
+        REQUIRE(Utf8IndexCodePointToCodeUnit(text, i) ==
+                utf8_iter.GetPosition());
+        REQUIRE(Utf8IndexCodeUnitToCodePoint(text, utf8_iter.GetPosition()) ==
+                i);
+        REQUIRE(Utf16IndexCodePointToCodeUnit(utf16, i) ==
+                utf16_iter.GetPosition());
+        REQUIRE(Utf16IndexCodeUnitToCodePoint(utf16,
+                                              utf16_iter.GetPosition()) == i);
+        if (i < length) {
+          ++utf8_iter;
+          ++utf16_iter;
+        }
+      }
+    }
+
+    const std::string_view invalid_sequences[] = {
+        "\x80",
+        "\xC0\x80",
+        "\xC3",
+        "\xE2\x82",
+        "\xE0\x80\x80",      // overlong
+        "\xED\xA0\x80",      // surrogate
+        "\xF0\x80\x80\x80",  // overlong
+        "\xF4\x90\x80\x80",  // over U+10FFFF
+        "\xF5\x80\x80\x80",
+        "\xFF",
+    };
+    for (auto sequence : invalid_sequences) {
+      for (int offset : {0, 13, 30, 31, 32, 60}) {
+        auto text = std::string(offset, 'a') + std::string(sequence) +
+                    std::string(offset % 2 ? 40 : 0, 'b');
+        REQUIRE_FALSE(Utf8IsValid(text));
+        REQUIRE_THROWS_AS(Utf8ToUtf16(text), TextEncodeException);
+      }
+    }
+  }
+
+  SetUtfSimdLevel(detected_level);
+}
+
+TEST_CASE("StringUtil bulk UTF routines benchmark", "[string][!benchmark]") {
+  const auto detected_level = GetUtfSimdLevel();
+  std::minstd_rand random(1);
+
+  const std::pair<const char*, std::string> corpora[] = {
+      {"ASCII", std::string(1 << 20, 'a')},
+      {"CJK", [] {
+         std::string text;
+         while (text.size() < (1 << 20)) text += "你好世界";
+         return text;
+       }()},
+      {"emoji", [] {
+         std::string text;
+         while (text.size() < (1 << 20)) text += "🤣a🎉 ";
+         return text;
+       }()},
+  };
+
+  for (const auto& [corpus_name, text] : corpora) {
+    const auto utf16 = Utf8ToUtf16(text);
+    const auto code_point_count = Utf8CountCodePoints(text);
+
+    BENCHMARK(std::format("{} count code points by iterator", corpus_name)) {
+      Index count = 0;
+      for (auto code_point : Utf8CodePointIterator(text.data(), text.size())) {
+        CRU_UNUSED(code_point)
+        count++;
+      }
+      return count;
+    };
+
+    for (auto level : kUtfSimdLevels) {
+      SetUtfSimdLevel(level);
+      if (GetUtfSimdLevel() != level) continue;
+      const auto level_name = level == UtfSimdLevel::Scalar ? "scalar"
+                              : level == UtfSimdLevel::Sse2 ? "SSE2"
+                                                            : "AVX2";
+
+      BENCHMARK(std::format("{} validate {}", corpus_name, level_name)) {
+        return Utf8IsValid(text);
+      };
+      BENCHMARK(std::format("{} count code points {}", corpus_name,
+                            level_name)) {
+        return Utf8CountCodePoints(text);
+      };
+      BENCHMARK(std::format("{} transcode to UTF-16 {}", corpus_name,
+                            level_name)) {
+        return Utf8ToUtf16(text);
+      };
+      BENCHMARK(std::format("{} UTF-8 code point to code unit {}",
+                            corpus_name, level_name)) {
+        return Utf8IndexCodePointToCodeUnit(text, code_point_count - 1);
+      };
+      BENCHMARK(std::format("{} UTF-16 code point to code unit {}",
+                            corpus_name, level_name)) {
+        return Utf16IndexCodePointToCodeUnit(utf16, code_point_count - 1);
+      };
+    }
+  }
+
+  SetUtfSimdLevel(detected_level);
+}
@@ -1,7 +1,14 @@
 #include "cru/base/Timer.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
 #include <chrono>
+#include <format>
+#include <list>
+#include <ranges>
+#include <vector>
 
 using cru::TimerRegistry;
 using std::chrono::milliseconds;
@@ -41,3 +48,141 @@ TEST_CASE("TimerRegistry Works", "[timer]") {
   while (registry.Update(mock_now)) { count++;}
   REQUIRE(count == 6);
 }
+
+TEST_CASE("TimerRegistry UpdateAll", "[timer]") {
+  TimerRegistry<int> registry;
+  auto mock_now = std::chrono::steady_clock::now();
+
+  auto timer1 = registry.Add(1, 30ms, false, mock_now);
+  auto timer2 = registry.Add(2, 10ms, true, mock_now);
+  auto timer3 = registry.Add(3, 10ms, false, mock_now);
+  auto timer4 = registry.Add(4, 5ms, false, mock_now);
+  registry.Remove(timer4);
+
+  std::vector<TimerRegistry<int>::UpdateResult> results;
+  registry.UpdateAll(mock_now + 25ms, results);
+  REQUIRE(results == std::vector<TimerRegistry<int>::UpdateResult>{
+                         {timer2, 2}, {timer3, 3}, {timer2, 2}});
+  REQUIRE(registry.NextTimeout(mock_now + 25ms) == 5ms);
+
+  results.clear();
+  registry.UpdateAll(mock_now + 30ms, results);
+  REQUIRE(results == std::vector<TimerRegistry<int>::UpdateResult>{
+                         {timer1, 1}, {timer2, 2}});
+
+  registry.Remove(timer2);
+  REQUIRE(registry.NextTimeout(mock_now) == std::nullopt);
+  REQUIRE(registry.Update(mock_now + 1000ms) == std::nullopt);
+}
+
+TEST_CASE("TimerRegistry Remove Many", "[timer]") {
+  TimerRegistry<int> registry;
+  auto mock_now = std::chrono::steady_clock::now();
+
+  std::vector<int> ids;
+  for (int i = 0; i < 1000; i++) {
+    ids.push_back(registry.Add(i, milliseconds(i + 1), false, mock_now));
+  }
+  // Removing most of them compacts the heap, the rest must survive.
+  for (int i = 0; i < 1000; i++) {
+    if (i % 10 != 0) registry.Remove(ids[i]);
+  }
+
+  std::vector<TimerRegistry<int>::UpdateResult> results;
+  registry.UpdateAll(mock_now + 2000ms, results);
+  REQUIRE(results.size() == 100);
+  for (int i = 0; i < 100; i++) {
+    REQUIRE(results[i].data == i * 10);
+  }
+}
+
+namespace {
+// The list based registry TimerRegistry replaced, kept for comparison.
+class ListTimerRegistry {
+ public:
+  int Add(int data, milliseconds interval,
+          std::chrono::steady_clock::time_point created) {
+    timers_.push_back({next_id_, data, created + interval});
+    return next_id_++;
+  }
+
+  void Remove(int id) {
+    timers_.remove_if([id](const Timer& timer) { return timer.id == id; });
+  }
+
+  std::optional<milliseconds> NextTimeout(
+      std::chrono::steady_clock::time_point now) {
+    if (timers_.empty()) return std::nullopt;
+    return std::ranges::min(
+        timers_ | std::views::transform([now](const Timer& timer) {
+          return timer.trigger <= now
+                     ? 0ms
+                     : std::chrono::duration_cast<milliseconds>(
+                           timer.trigger - now);
+        }));
+  }
+
+  std::optional<int> Update(std::chrono::steady_clock::time_point now) {
+    for (auto iter = timers_.begin(); iter != timers_.end(); ++iter) {
+      if (iter->trigger <= now) {
+        auto data = iter->data;
+        timers_.erase(iter);
+        return data;
+      }
+    }
+    return std::nullopt;
+  }
+
+ private:
+  struct Timer {
+    int id;
+    int data;
+    std::chrono::steady_clock::time_point trigger;
+  };
+
+  int next_id_ = 1;
+  std::list<Timer> timers_;
+};
+
+template <typename Registry>
+int ChurnTimers(Registry& registry, std::vector<int>& ids,
+                std::chrono::steady_clock::time_point now) {
+  // Cancel and re-add a timer, like caret blink does on every key press, then
+  // run one loop iteration.
+  int fired = 0;
+  for (int i = 0; i < 100; i++) {
+    auto index = (i * 7919) % ids.size();
+    registry.Remove(ids[index]);
+    if constexpr (std::is_same_v<Registry, ListTimerRegistry>) {
+      ids[index] = registry.Add(i, milliseconds(500 + i), now);
+    } else {
+      ids[index] = registry.Add(i, milliseconds(500 + i), false, now);
+    }
+    if (registry.NextTimeout(now) == 0ms) {
+      while (registry.Update(now)) fired++;
+    }
+  }
+  return fired;
+}
+}  // namespace
+
+TEST_CASE("TimerRegistry Benchmark", "[timer][!benchmark]") {
+  auto now = std::chrono::steady_clock::now();
+
+  for (int count : {100, 10000}) {
+    TimerRegistry<int> heap_registry;
+    ListTimerRegistry list_registry;
+    std::vector<int> heap_ids, list_ids;
+    for (int i = 0; i < count; i++) {
+      heap_ids.push_back(heap_registry.Add(i, 1000ms, false, now));
+      list_ids.push_back(list_registry.Add(i, 1000ms, now));
+    }
+
+    BENCHMARK(std::format("Churn 100 of {} timers (heap)", count)) {
+      return ChurnTimers(heap_registry, heap_ids, now);
+    };
+    BENCHMARK(std::format("Churn 100 of {} timers (list)", count)) {
+      return ChurnTimers(list_registry, list_ids, now);
+    };
+  }
+}
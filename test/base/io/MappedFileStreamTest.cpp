@@ -0,0 +1,76 @@
+#include "cru/base/io/MappedFileStream.h"
+#include "cru/base/io/Stream.h"
+#include "cru/base/xml/XmlParser.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::filesystem::path WriteTempFile(std::string_view name,
+                                    std::string_view content) {
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream file(path, std::ios::binary);
+  file.write(content.data(), content.size());
+  return path;
+}
+}  // namespace
+
+TEST_CASE("MappedFileStream should work.", "[io][stream]") {
+  using namespace cru::io;
+  auto path = WriteTempFile("CruMappedFileStreamTest", "0123456789");
+
+  {
+    MappedFileStream stream(path.string().c_str());
+    REQUIRE(stream.CanRead());
+    REQUIRE(!stream.CanWrite());
+    REQUIRE(stream.GetSize() == 10);
+    REQUIRE(stream.GetStringView() == "0123456789");
+    REQUIRE(stream.GetSpan().size() == 10);
+
+    std::byte buffer[4];
+    REQUIRE(stream.Read(buffer, 4) == 4);
+    REQUIRE(buffer[3] == std::byte('3'));
+    REQUIRE(stream.Seek(-2, Stream::SeekOrigin::End) == 8);
+    REQUIRE(stream.ReadToEndAsUtf8String() == "89");
+    REQUIRE(stream.Read(buffer, 4) == Stream::kEOF);
+
+    stream.Rewind();
+    REQUIRE(stream.ReadToEndAsUtf8String() == "0123456789");
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("MappedFileStream should handle empty file.", "[io][stream]") {
+  using namespace cru::io;
+  auto path = WriteTempFile("CruMappedFileStreamEmptyTest", "");
+
+  {
+    MappedFileStream stream(path.string().c_str());
+    REQUIRE(stream.GetSize() == 0);
+    REQUIRE(stream.GetSpan().empty());
+    REQUIRE(stream.ReadToEnd().empty());
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("MappedFileStream can be parsed in place.", "[io][stream]") {
+  using namespace cru::io;
+  auto path = WriteTempFile("CruMappedFileStreamXmlTest",
+                            "<root a=\"v\"><c/></root>");
+
+  {
+    MappedFileStream stream(path.string().c_str());
+    cru::xml::XmlParser parser(stream.GetSpan());
+    auto root = parser.Parse();
+    REQUIRE(root->GetTag() == "root");
+    REQUIRE(root->GetAttributeValue("a") == "v");
+    REQUIRE(root->GetChildCount() == 1);
+    delete root;
+  }
+
+  std::filesystem::remove(path);
+}
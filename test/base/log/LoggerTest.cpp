@@ -0,0 +1,144 @@
+#include "cru/base/log/Logger.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using cru::log::LogInfo;
+using cru::log::LogLevel;
+
+TEST_CASE("LogTagTrie should match prefix.", "[log]") {
+  cru::log::LogTagTrie trie;
+  REQUIRE(trie.IsEmpty());
+  REQUIRE_FALSE(trie.MatchPrefix("cru"));
+
+  trie.Add("cru::ui");
+  trie.Add("cru::platform::gui::xcb");
+  REQUIRE(trie.MatchPrefix("cru::ui"));
+  REQUIRE(trie.MatchPrefix("cru::ui::controls::ControlHost"));
+  REQUIRE(trie.MatchPrefix("cru::platform::gui::xcb::XcbWindow"));
+  REQUIRE_FALSE(trie.MatchPrefix("cru::u"));
+  REQUIRE_FALSE(trie.MatchPrefix("cru::platform::gui::sdl"));
+  REQUIRE_FALSE(trie.MatchPrefix(""));
+
+  trie.Add("");
+  REQUIRE(trie.MatchPrefix("anything"));
+}
+
+namespace {
+struct RecordLogWriter : cru::Object, cru::log::ILogWriter {
+  explicit RecordLogWriter(std::vector<std::string>* messages)
+      : messages(messages) {}
+
+  void Write(const LogInfo& log_info, std::string log_str) override {
+    messages->push_back(log_info.message);
+  }
+
+  std::vector<std::string>* messages;
+};
+
+// Slow enough that logging from a loop overflows the buffer.
+struct SlowLogWriter : RecordLogWriter {
+  using RecordLogWriter::RecordLogWriter;
+
+  void Write(const LogInfo& log_info, std::string log_str) override {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    RecordLogWriter::Write(log_info, std::move(log_str));
+  }
+};
+}  // namespace
+
+TEST_CASE("Logger should filter debug logs by tag.", "[log]") {
+  cru::log::SynchronousLogger logger;
+  std::vector<std::string> messages;
+  cru::log::ILogger* ilogger = &logger;
+  logger.AddWriter(std::make_unique<RecordLogWriter>(&messages));
+
+  REQUIRE_FALSE(logger.IsEnabled(LogLevel::Debug, "cru::ui"));
+  REQUIRE(logger.IsEnabled(LogLevel::Info, "cru::ui"));
+
+  logger.AddDebugTag("cru::ui");
+  REQUIRE(logger.IsEnabled(LogLevel::Debug, "cru::ui::render"));
+  REQUIRE_FALSE(logger.IsEnabled(LogLevel::Debug, "cru::platform"));
+
+  ilogger->Log(LogLevel::Debug, "cru::ui::render", "a");
+  ilogger->Log(LogLevel::Debug, "cru::platform", "b");
+  ilogger->Log(LogLevel::Info, "cru::platform", "c");
+  REQUIRE(messages == std::vector<std::string>{"a", "c"});
+
+  logger.RemoveDebugTag("cru::ui");
+  REQUIRE_FALSE(logger.IsEnabled(LogLevel::Debug, "cru::ui::render"));
+}
+
+TEST_CASE("AsynchronousLogger should write all logs when blocking.", "[log]") {
+  std::vector<std::string> messages;
+  cru::log::AsynchronousLogger logger(16);
+  cru::log::ILogger* ilogger = &logger;
+  logger.AddWriter(std::make_unique<RecordLogWriter>(&messages));
+
+  constexpr int kThreadCount = 4;
+  constexpr int kLogCount = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([ilogger] {
+      for (int j = 0; j < kLogCount; j++) {
+        ilogger->Log(LogLevel::Info, "test", "m");
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  logger.Flush();
+
+  auto statistics = logger.GetStatistics();
+  REQUIRE(statistics.enqueued == kThreadCount * kLogCount);
+  REQUIRE(statistics.dropped == 0);
+  REQUIRE(statistics.flushed == kThreadCount * kLogCount);
+  REQUIRE(messages.size() == kThreadCount * kLogCount);
+}
+
+TEST_CASE("AsynchronousLogger should count dropped logs.", "[log]") {
+  std::vector<std::string> messages;
+  cru::log::AsynchronousLogger logger(
+      4, cru::log::AsynchronousLogOverflowPolicy::Drop);
+  cru::log::ILogger* ilogger = &logger;
+  logger.AddWriter(std::make_unique<RecordLogWriter>(&messages));
+
+  constexpr int kLogCount = 10000;
+  for (int i = 0; i < kLogCount; i++) {
+    ilogger->Log(LogLevel::Info, "test", "m");
+  }
+  logger.Flush();
+
+  auto statistics = logger.GetStatistics();
+  REQUIRE(statistics.enqueued + statistics.dropped == kLogCount);
+  REQUIRE(statistics.flushed == statistics.enqueued);
+  REQUIRE(messages.size() == statistics.enqueued);
+}
+
+TEST_CASE("AsynchronousLogger should keep sampled logs on overflow.",
+          "[log]") {
+  std::vector<std::string> messages;
+  constexpr int kSampleInterval = 4;
+  cru::log::AsynchronousLogger logger(
+      4, cru::log::AsynchronousLogOverflowPolicy::Sample, kSampleInterval);
+  cru::log::ILogger* ilogger = &logger;
+  logger.AddWriter(std::make_unique<SlowLogWriter>(&messages));
+
+  constexpr int kLogCount = 1000;
+  for (int i = 0; i < kLogCount; i++) {
+    ilogger->Log(LogLevel::Info, "test", "m");
+  }
+  logger.Flush();
+
+  auto statistics = logger.GetStatistics();
+  REQUIRE(statistics.enqueued + statistics.dropped == kLogCount);
+  REQUIRE(statistics.dropped > 0);
+  // Each log is either enqueued directly or one of the overflowing ones, of
+  // which one of every sample interval waits for space.
+  REQUIRE(statistics.enqueued >= kLogCount / kSampleInterval);
+  REQUIRE(statistics.flushed == statistics.enqueued);
+  REQUIRE(messages.size() == statistics.enqueued);
+}
@@ -1,9 +1,17 @@
 #include "cru/base/platform/unix/EventLoop.h"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <format>
+#include <semaphore>
+#include <thread>
+#include <vector>
 
 TEST_CASE("UnixTimerFile Work", "[unix][time]") {
   using namespace cru;
@@ -108,3 +116,197 @@ TEST_CASE("UnixEventLoop Poll Work", "[unix][time]") {
   REQUIRE(exit_code == 0);
   REQUIRE(triggered);
 }
+
+namespace {
+std::vector<cru::platform::unix::UnixEventLoop::Backend> GetTestBackends() {
+  using Backend = cru::platform::unix::UnixEventLoop::Backend;
+#ifdef __linux__
+  return {Backend::Poll, Backend::Epoll};
+#else
+  return {Backend::Poll};
+#endif
+}
+
+const char* GetBackendName(
+    cru::platform::unix::UnixEventLoop::Backend backend) {
+  return backend == cru::platform::unix::UnixEventLoop::Backend::Poll
+             ? "poll"
+             : "epoll";
+}
+}  // namespace
+
+TEST_CASE("UnixEventLoop Dispatch All Ready Fds", "[unix]") {
+  using namespace cru;
+  using namespace cru::platform::unix;
+
+  for (auto backend : GetTestBackends()) {
+    UnixEventLoop loop(backend);
+    REQUIRE(loop.GetBackend() == backend);
+
+    auto pipe1 = OpenUniDirectionalPipe();
+    auto pipe2 = OpenUniDirectionalPipe();
+    auto pipe3 = OpenUniDirectionalPipe();
+    std::vector<int> triggered;
+
+    loop.SetPoll(pipe1.read, POLLIN, [&](auto) {
+      triggered.push_back(1);
+      // Removing another ready fd in a handler must be safe.
+      loop.RemovePoll(pipe2.read);
+    });
+    loop.SetPoll(pipe2.read, POLLIN, [&](auto) { triggered.push_back(2); });
+    loop.SetPoll(pipe3.read, POLLIN, [&](auto) {
+      triggered.push_back(3);
+      loop.RemovePoll(pipe3.read);
+    });
+    loop.AfterEachRoundEvent()->AddSpyOnlyHandler([&] {
+      if (!triggered.empty()) loop.RequestQuit();
+    });
+
+    char buffer = 0;
+    pipe1.write.Write(&buffer, 1);
+    pipe2.write.Write(&buffer, 1);
+    pipe3.write.Write(&buffer, 1);
+
+    REQUIRE(loop.Run() == 0);
+    std::ranges::sort(triggered);
+    REQUIRE((triggered == std::vector<int>{1, 3} ||
+             triggered == std::vector<int>{1, 2, 3}));
+  }
+}
+
+TEST_CASE("UnixEventLoop Cross Thread Work", "[unix][time]") {
+  using namespace cru;
+  using namespace cru::platform::unix;
+
+  for (auto backend : GetTestBackends()) {
+    UnixEventLoop loop(backend);
+
+    std::atomic_int counter = 0;
+    std::thread thread([&] {
+      for (int i = 0; i < 1000; i++) {
+        loop.QueueAction([&] { counter++; });
+      }
+      loop.RequestQuit(7);
+    });
+    REQUIRE(loop.Run() == 7);
+    thread.join();
+    REQUIRE(counter == 1000);
+
+    // A timer set from another thread must wake the sleeping loop.
+    auto start = std::chrono::steady_clock::now();
+    thread = std::thread([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      loop.SetTimeout([&] { loop.RequestQuit(); },
+                      std::chrono::milliseconds(50));
+    });
+    REQUIRE(loop.Run() == 0);
+    thread.join();
+    REQUIRE(std::chrono::steady_clock::now() - start <
+            std::chrono::milliseconds(1000));
+  }
+}
+
+TEST_CASE("UnixEventLoop Benchmark", "[unix][!benchmark]") {
+  using namespace cru;
+  using namespace cru::platform::unix;
+
+  for (auto backend : GetTestBackends()) {
+    auto backend_name = GetBackendName(backend);
+    UnixEventLoop loop(backend);
+
+    std::counting_semaphore<> request(0);
+    std::atomic_bool stop = false;
+    std::thread waker([&] {
+      while (true) {
+        request.acquire();
+        if (stop) break;
+        loop.QueueAction([&] { loop.RequestQuit(); });
+      }
+    });
+
+    BENCHMARK(std::format("Cross-thread wakeup latency ({})", backend_name)) {
+      request.release();
+      return loop.Run();
+    };
+
+    stop = true;
+    request.release();
+    waker.join();
+
+    for (int fd_count : {16, 1024}) {
+      std::vector<UniDirectionalUnixPipeResult> pipes;
+      for (int i = 0; i < fd_count; i++) {
+        auto& pipe = pipes.emplace_back(OpenUniDirectionalPipe());
+        int fd = pipe.read;
+        loop.SetPoll(fd, POLLIN, [&loop, fd](auto) {
+          char buffer;
+          CRU_UNUSED(::read(fd, &buffer, 1))
+          loop.RequestQuit();
+        });
+      }
+
+      auto& active = pipes[fd_count / 2];
+      BENCHMARK(std::format("One ready fd among {} ({})", fd_count,
+                            backend_name)) {
+        char buffer = 0;
+        active.write.Write(&buffer, 1);
+        return loop.Run();
+      };
+
+      for (auto& pipe : pipes) {
+        loop.RemovePoll(pipe.read);
+      }
+    }
+  }
+}
+
+TEST_CASE("UnixEventLoop Batched Actions", "[unix]") {
+  using namespace cru;
+  using namespace cru::platform::unix;
+
+  UnixEventLoop loop;
+  loop.SetMaxActionsPerRound(100);
+  REQUIRE_THROWS(loop.SetMaxActionsPerRound(0));
+
+  int counter = 0;
+  std::vector<UnixEventLoopRoundInfo> rounds;
+  loop.AfterEachRoundEvent()->AddHandler(
+      [&](const UnixEventLoopRoundInfo& info) { rounds.push_back(info); });
+
+  std::thread thread([&] {
+    for (int i = 0; i < 1000; i++) {
+      loop.QueueAction([&] { counter++; });
+    }
+    loop.RequestQuit();
+  });
+  // Let all actions pile up before the loop starts.
+  thread.join();
+
+  REQUIRE(loop.Run() == 0);
+  REQUIRE(counter == 1000);
+  REQUIRE(rounds.size() == 11);
+  REQUIRE(rounds[0].action_count == 100);
+  REQUIRE(rounds[0].queued_action_count == 901);
+  REQUIRE(rounds[10].action_count == 1);
+  REQUIRE(rounds[10].queued_action_count == 0);
+}
+
+TEST_CASE("UnixEventLoop Action Benchmark", "[unix][!benchmark]") {
+  using namespace cru;
+  using namespace cru::platform::unix;
+
+  UnixEventLoop loop;
+
+  BENCHMARK("Post 100k actions from a worker thread") {
+    int counter = 0;
+    std::thread thread([&] {
+      for (int i = 0; i < 100000; i++) {
+        loop.QueueAction([&counter] { counter++; });
+      }
+      loop.RequestQuit();
+    });
+    loop.Run();
+    thread.join();
+    return counter;
+  };
+}
@@ -1,8 +1,13 @@
+#include "cru/base/xml/XmlDocument.h"
 #include "cru/base/xml/XmlNode.h"
 #include "cru/base/xml/XmlParser.h"
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 using namespace cru::xml;
 
 TEST_CASE("CruXmlParserTest Simple", "[xml]") {
@@ -114,3 +119,111 @@ TEST_CASE("CruXmlParserTest Complex", "[xml]") {
   REQUIRE(n->GetChildAt(2)->AsComment()->GetText() == "comment");
   delete n;
 }
+
+TEST_CASE("CruXmlParserTest Error", "[xml]") {
+  auto parse = [](std::string xml) {
+    XmlParser parser(std::move(xml));
+    delete parser.Parse();
+  };
+  REQUIRE_THROWS_AS(parse("<root></other>"), XmlParsingException);
+  REQUIRE_THROWS_AS(parse("<root>"), XmlParsingException);
+  REQUIRE_THROWS_AS(parse("<root a=\"v></root>"), XmlParsingException);
+  REQUIRE_THROWS_AS(parse("<r1/><r2/>"), XmlParsingException);
+  REQUIRE_THROWS_AS(parse("<!-- comment"), XmlParsingException);
+}
+
+TEST_CASE("CruXmlParserTest Sax", "[xml]") {
+  struct Handler : IXmlSaxHandler {
+    std::vector<std::string> events;
+
+    void OnStartElement(std::string_view tag,
+                        std::span<const XmlAttributeView> attributes) override {
+      std::string event = "<" + std::string(tag);
+      for (const auto& attribute : attributes) {
+        event += " " + std::string(attribute.name) + "=" +
+                 std::string(attribute.value);
+      }
+      events.push_back(event);
+    }
+    void OnEndElement(std::string_view tag) override {
+      events.push_back("/" + std::string(tag));
+    }
+    void OnText(std::string_view text) override {
+      events.push_back(std::string(text));
+    }
+  };
+
+  Handler handler;
+  ParseXml("<root a=\"1\" b=\"2\"> t1 <c/><!-- x --></root>", &handler);
+  REQUIRE(handler.events ==
+          std::vector<std::string>{"<root a=1 b=2", "t1", "<c", "/c", "/root"});
+}
+
+TEST_CASE("CruXmlDocumentTest Complex", "[xml]") {
+  std::string xml = R"(
+<root a1="v1">
+  <c1 A2="v2"/>
+  text
+  <!-- comment -->
+  <c2><d1></d1></c2>
+</root>
+)";
+  XmlDocument document(xml);
+  auto source = document.GetSource();
+  auto in_source = [source](std::string_view s) {
+    return s.data() >= source.data() &&
+           s.data() + s.size() <= source.data() + source.size();
+  };
+
+  auto root = document.GetRoot();
+  REQUIRE(root->IsElementNode());
+  REQUIRE(root->GetTag() == "root");
+  REQUIRE(in_source(root->GetTag()));
+  REQUIRE(root->GetOptionalAttributeValue("a1") == "v1");
+  REQUIRE(in_source(*root->GetOptionalAttributeValue("a1")));
+  REQUIRE(root->GetOptionalAttributeValue("a2") == std::nullopt);
+  REQUIRE(root->GetChildCount() == 4);
+
+  auto c1 = root->GetFirstChild();
+  REQUIRE(c1->HasTag("C1"));
+  REQUIRE(c1->GetParent() == root);
+  REQUIRE(c1->GetChildCount() == 0);
+  REQUIRE(c1->GetOptionalAttributeValueCaseInsensitive("a2") == "v2");
+
+  auto text = c1->GetNextSibling();
+  REQUIRE(text->IsTextNode());
+  REQUIRE(text->GetText() == "text");
+  REQUIRE(in_source(text->GetText()));
+
+  auto comment = text->GetNextSibling();
+  REQUIRE(comment->IsCommentNode());
+  REQUIRE(comment->GetText() == "comment");
+
+  auto c2 = comment->GetNextSibling();
+  REQUIRE(c2->GetTag() == "c2");
+  REQUIRE(c2->GetNextSibling() == nullptr);
+  REQUIRE(c2->GetFirstChildElement()->GetTag() == "d1");
+  REQUIRE(root->GetFirstChildElement() == c1);
+}
+
+TEST_CASE("CruXmlDocumentTest Error", "[xml]") {
+  REQUIRE_THROWS_AS(XmlDocument("<root></other>"), XmlParsingException);
+  REQUIRE_THROWS_AS(XmlDocument("<r1/><r2/>"), XmlParsingException);
+  REQUIRE_THROWS_AS(XmlDocument(""), XmlParsingException);
+}
+
+TEST_CASE("CruXmlDocumentTest ToXmlNode", "[xml]") {
+  XmlDocument document(R"(<root a="1"><c b="2">text</c><!-- x --></root>)");
+
+  std::unique_ptr<XmlNode> node(document.GetRoot()->ToXmlNode());
+  auto root = node->AsElement();
+  REQUIRE(root->GetTag() == "root");
+  REQUIRE(root->GetAttributeValue("a") == "1");
+  REQUIRE(root->GetChildCount() == 2);
+
+  auto c = root->GetChildAt(0)->AsElement();
+  REQUIRE(c->GetParent() == root);
+  REQUIRE(c->GetAttributeValue("b") == "2");
+  REQUIRE(c->GetChildAt(0)->AsText()->GetText() == "text");
+  REQUIRE(root->GetChildAt(1)->AsComment()->GetText() == "x");
+}
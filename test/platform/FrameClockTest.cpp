@@ -0,0 +1,29 @@
+#include "cru/platform/gui/FrameClock.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using cru::platform::gui::FrameClock;
+using namespace std::chrono_literals;
+
+TEST_CASE("FrameClock CalculateNextFrameTime", "[frame-clock]") {
+  FrameClock::Clock::time_point now{1s};
+
+  SECTION("First frame begins now.") {
+    REQUIRE(FrameClock::CalculateNextFrameTime(now, std::nullopt, 16ms) ==
+            now);
+  }
+
+  SECTION("Frame is delayed to one interval after last frame.") {
+    REQUIRE(FrameClock::CalculateNextFrameTime(now, now - 10ms, 16ms) ==
+            now + 6ms);
+  }
+
+  SECTION("Frame begins now if last frame is long ago.") {
+    REQUIRE(FrameClock::CalculateNextFrameTime(now, now - 100ms, 16ms) ==
+            now);
+  }
+
+  SECTION("Zero interval means no throttling.") {
+    REQUIRE(FrameClock::CalculateNextFrameTime(now, now, 0ms) == now);
+  }
+}
@@ -46,3 +46,23 @@ TEST_CASE("Rect Union", "[graphics][rect]") {
   test({0.f, 0.f, 1.f, 1.f}, {0.5f, 0.5f, 1.f, 1.f}, {0.f, 0.f, 1.5f, 1.5f});
   test({0.5f, 0.f, 1.f, 1.f}, {0.f, 0.5f, 1.f, 1.f}, {0.f, 0.f, 1.5f, 1.5f});
 }
+
+TEST_CASE("Rect Intersect", "[graphics][rect]") {
+  auto test = [](const Rect& left, const Rect& right, const Rect& result) {
+    REQUIRE(left.Intersect(right) == result);
+    REQUIRE(right.Intersect(left) == result);
+  };
+
+  test({}, {0.f, 0.f, 1.f, 1.f}, {});
+  test({0.f, 0.f, 1.f, 1.f}, {2.f, 2.f, 1.f, 1.f}, {});
+  test({0.f, 0.f, 1.f, 1.f}, {1.f, 0.f, 1.f, 1.f}, {});
+  test({0.f, 0.f, 1.f, 1.f}, {0.5f, 0.5f, 1.f, 1.f}, {0.5f, 0.5f, 0.5f, 0.5f});
+  test({0.f, 0.f, 3.f, 3.f}, {1.f, 1.f, 1.f, 1.f}, {1.f, 1.f, 1.f, 1.f});
+}
+
+TEST_CASE("Rect RoundOut", "[graphics][rect]") {
+  REQUIRE(Rect(0.f, 0.f, 1.f, 1.f).RoundOut() == Rect(0.f, 0.f, 1.f, 1.f));
+  REQUIRE(Rect(0.5f, 0.5f, 1.f, 1.f).RoundOut() == Rect(0.f, 0.f, 2.f, 2.f));
+  REQUIRE(Rect(-0.5f, 1.25f, 0.5f, 0.5f).RoundOut() ==
+          Rect(-1.f, 1.f, 1.f, 1.f));
+}
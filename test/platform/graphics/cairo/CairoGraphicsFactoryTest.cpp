@@ -0,0 +1,42 @@
+#include "cru/platform/graphics/cairo/CairoGraphicsFactory.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits>
+#include <memory>
+#include <string>
+
+using Catch::Approx;
+using namespace cru::platform::graphics;
+using namespace cru::platform::graphics::cairo;
+
+TEST_CASE("CairoGraphicsFactory measure should match text layout.",
+          "[pango]") {
+  CairoGraphicsFactory factory;
+  std::shared_ptr<IFont> font = factory.CreateFont("sans", 16);
+
+  for (std::string text : {"", "hello", "hello world, long line to wrap",
+                           "first paragraph\n\nthird one is longer\n",
+                           "crlf paragraph\r\n\r\nthird\r\n"}) {
+    auto text_layout = factory.CreateTextLayout(font, text);
+
+    for (float width : {0.f, 30.f, 80.f, 200.f,
+                        std::numeric_limits<float>::max()}) {
+      text_layout->SetMaxWidth(width);
+      auto expected = text_layout->GetTextBounds().GetRightBottom();
+      auto size = factory.MeasureTextForWidth(font, text, width);
+      REQUIRE(size.width == Approx(expected.x));
+      REQUIRE(size.height == Approx(expected.y));
+    }
+
+    auto measure = factory.MeasureText(font, text);
+    text_layout->SetMaxWidth(std::numeric_limits<float>::max());
+    auto max_content = text_layout->GetTextBounds().GetRightBottom();
+    text_layout->SetMaxWidth(0);
+    auto min_content = text_layout->GetTextBounds().GetRightBottom();
+    REQUIRE(measure.max_content_width == Approx(max_content.x));
+    REQUIRE(measure.max_content_height == Approx(max_content.y));
+    REQUIRE(measure.min_content_width == Approx(min_content.x));
+  }
+}
@@ -0,0 +1,198 @@
+#include "cru/platform/graphics/cairo/CairoGraphicsFactory.h"
+#include "cru/platform/graphics/cairo/PangoFont.h"
+#include "cru/platform/graphics/cairo/PangoTextLayoutCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace cru::platform::graphics;
+using namespace cru::platform::graphics::cairo;
+
+TEST_CASE("PangoTextLayoutCache", "[pango]") {
+  CairoGraphicsFactory factory;
+  PangoFont font(&factory, "sans", 16);
+  PangoTextLayoutCache cache(factory.GetDefaultPangoContext());
+
+  SECTION("Same key should share shaped text.") {
+    auto shaped1 = cache.Get("hello", &font, -1);
+    auto shaped2 = cache.Get("hello", &font, -1);
+    REQUIRE(shaped1 == shaped2);
+    REQUIRE(shaped1->line_count == 1);
+    REQUIRE(shaped1->width > 0);
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.hit_count == 1);
+    REQUIRE(statistics.miss_count == 1);
+    REQUIRE(statistics.entry_count == 1);
+  }
+
+  SECTION("Different width should not share shaped text.") {
+    auto shaped1 = cache.Get("hello world", &font, -1);
+    auto shaped2 = cache.Get("hello world", &font, 10);
+    REQUIRE(shaped1 != shaped2);
+    REQUIRE(shaped2->line_count > 1);
+  }
+
+  SECTION("Different attributes should not share shaped text.") {
+    PangoShapingAttribute bold{0, 5, FontWeight::Bold, FontStyle::Normal,
+                               false};
+    auto shaped1 = cache.Get("hello", &font, -1);
+    auto shaped2 = cache.Get("hello", &font, -1, {&bold, 1});
+    auto shaped3 = cache.Get("hello", &font, -1, {&bold, 1});
+    REQUIRE(shaped1 != shaped2);
+    REQUIRE(shaped2 == shaped3);
+  }
+
+  SECTION("Least recently used should be evicted.") {
+    cache.Get("a", &font, -1);
+    auto byte_size = cache.GetStatistics().byte_size;
+    cache.Get("b", &font, -1);
+    cache.Get("a", &font, -1);
+    cache.SetMaxByteSize(byte_size);
+    REQUIRE(cache.GetStatistics().entry_count == 1);
+    cache.Get("a", &font, -1);
+    REQUIRE(cache.GetStatistics().miss_count == 2);
+  }
+
+  SECTION("Clear should drop entries and bump generation.") {
+    auto shaped = cache.Get("hello", &font, -1);
+    auto generation = cache.GetGeneration();
+    cache.Clear();
+    REQUIRE(cache.GetGeneration() == generation + 1);
+    REQUIRE(cache.GetStatistics().entry_count == 0);
+    REQUIRE(cache.Get("hello", &font, -1) != shaped);
+  }
+}
+
+TEST_CASE("PangoTextLayout shares shaped text", "[pango]") {
+  CairoGraphicsFactory factory;
+  auto font = factory.CreateFont("sans", 16);
+  auto cache = factory.GetTextLayoutCache();
+
+  auto layout = factory.CreateTextLayout(std::move(font), "line\nline");
+  REQUIRE(layout->GetLineCount() == 2);
+  REQUIRE(cache->GetStatistics().miss_count == 1);
+  REQUIRE(cache->GetStatistics().hit_count == 1);
+}
+
+TEST_CASE("PangoTextLayout attributes", "[pango]") {
+  CairoGraphicsFactory factory;
+  auto font = factory.CreateFont("sans", 16);
+  auto cache = factory.GetTextLayoutCache();
+  std::shared_ptr<IBrush> brush =
+      static_cast<IGraphicsFactory&>(factory).CreateSolidColorBrush(
+          cru::platform::colors::red);
+
+  auto layout = factory.CreateTextLayout(std::move(font), "line1\nline2");
+  layout->GetLineCount();
+  const auto miss_count = cache->GetStatistics().miss_count;
+
+  SECTION("Brushes should not reshape text.") {
+    layout->SetAttributes({{cru::platform::TextRange(0, 8), brush, brush}});
+    layout->GetLineCount();
+    REQUIRE(cache->GetStatistics().miss_count == miss_count);
+  }
+
+  SECTION("Weight should only reshape paragraphs it covers.") {
+    layout->SetAttributes({{cru::platform::TextRange(6, 2), nullptr, nullptr,
+                            FontWeight::Bold}});
+    const auto hit_count = cache->GetStatistics().hit_count;
+    layout->GetLineCount();
+    REQUIRE(cache->GetStatistics().miss_count == miss_count + 1);
+    REQUIRE(cache->GetStatistics().hit_count == hit_count);
+  }
+
+  SECTION("Overlapping ranges should throw.") {
+    REQUIRE_THROWS_AS(
+        layout->SetAttributes(
+            {{cru::platform::TextRange(0, 4), nullptr, nullptr,
+              FontWeight::Bold},
+             {cru::platform::TextRange(2, 4), brush, nullptr}}),
+        cru::Exception);
+  }
+}
+
+TEST_CASE("PangoTextLayout attributes should move with edits.", "[pango]") {
+  CairoGraphicsFactory factory;
+  std::shared_ptr<IFont> font = factory.CreateFont("sans", 16);
+  auto cache = factory.GetTextLayoutCache();
+  auto bold = [](cru::Index position, cru::Index count) {
+    return std::vector<TextAttribute>{
+        {cru::platform::TextRange(position, count), nullptr, nullptr,
+         FontWeight::Bold}};
+  };
+  auto require_same = [](ITextLayout* layout, ITextLayout* expected) {
+    const auto size = static_cast<cru::Index>(expected->GetText().size());
+    for (cru::Index i = 0; i <= size; i++) {
+      REQUIRE(layout->TextSinglePoint(i, false) ==
+              expected->TextSinglePoint(i, false));
+    }
+    REQUIRE(layout->GetTextBounds() == expected->GetTextBounds());
+  };
+
+  // Bold covers "ne2\nli".
+  auto layout = factory.CreateTextLayout(font, "line1\nline2\nline3");
+  layout->SetAttributes(bold(8, 6));
+  layout->GetLineCount();
+
+  SECTION("Only the edited paragraph should be reshaped.") {
+    const auto miss_count = cache->GetStatistics().miss_count;
+    layout->ReplaceText(0, 0, "ab");
+    layout->GetLineCount();
+    REQUIRE(cache->GetStatistics().miss_count == miss_count + 1);
+
+    auto expected = factory.CreateTextLayout(font, "abline1\nline2\nline3");
+    expected->SetAttributes(bold(10, 6));
+    require_same(layout.get(), expected.get());
+  }
+
+  SECTION("Text replaced inside a range should join it.") {
+    layout->ReplaceText(9, 4, "xy");
+    auto expected = factory.CreateTextLayout(font, "line1\nlinxyine3");
+    expected->SetAttributes(bold(8, 4));
+    require_same(layout.get(), expected.get());
+  }
+
+  SECTION("Text replaced at an edge of a range should not join it.") {
+    layout->ReplaceText(6, 4, "xy");
+    auto expected = factory.CreateTextLayout(font, "line1\nxy2\nline3");
+    expected->SetAttributes(bold(8, 4));
+    require_same(layout.get(), expected.get());
+  }
+}
+
+TEST_CASE("PangoTextLayout should lay out CRLF like LF.", "[pango]") {
+  CairoGraphicsFactory factory;
+  std::shared_ptr<IFont> font = factory.CreateFont("sans", 16);
+  auto lf = factory.CreateTextLayout(font, "line1\nline2\n\nline4");
+  auto crlf = factory.CreateTextLayout(font, "line1\r\nline2\r\n\r\nline4");
+
+  auto require_same = [&] {
+    REQUIRE(crlf->GetLineCount() == lf->GetLineCount());
+    REQUIRE(crlf->GetTextBounds() == lf->GetTextBounds());
+    // Each line break of crlf is one byte longer.
+    const auto size = static_cast<cru::Index>(lf->GetText().size());
+    cru::Index offset = 0;
+    for (cru::Index i = 0; i <= size; i++) {
+      REQUIRE(crlf->TextSinglePoint(i + offset, false) ==
+              lf->TextSinglePoint(i, false));
+      if (i < size && lf->GetText()[i] == '\n') {
+        offset++;
+        REQUIRE(crlf->TextSinglePoint(i + offset, false) ==
+                lf->TextSinglePoint(i, false));
+      }
+    }
+  };
+
+  require_same();
+
+  SECTION("Editing around CRLF should keep it one line break.") {
+    // Split CRLF, then join it again.
+    crlf->ReplaceText(6, 0, "x");
+    REQUIRE(crlf->GetLineCount() == lf->GetLineCount() + 1);
+    crlf->ReplaceText(6, 1, "");
+    require_same();
+  }
+}
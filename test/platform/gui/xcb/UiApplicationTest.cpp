@@ -0,0 +1,188 @@
+#include "cru/platform/gui/xcb/UiApplication.h"
+#include "cru/platform/gui/xcb/Window.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <vector>
+
+using cru::AutoFreePtr;
+using cru::MakeAutoFree;
+using cru::platform::gui::xcb::CompressXEvents;
+using cru::platform::gui::xcb::HandleXEventBatches;
+using cru::platform::gui::xcb::XcbWindow;
+
+namespace {
+using EventList = std::vector<AutoFreePtr<xcb_generic_event_t>>;
+
+// Allocated like events from xcb_poll_for_event.
+template <typename Event>
+void AddEvent(EventList& events, std::uint8_t type, Event event) {
+  static_assert(sizeof(Event) <= sizeof(xcb_generic_event_t));
+  event.response_type = type;
+  auto result = std::calloc(1, sizeof(xcb_generic_event_t));
+  *static_cast<Event*>(result) = event;
+  events.push_back(MakeAutoFree(static_cast<xcb_generic_event_t*>(result)));
+}
+
+void AddMotion(EventList& events, xcb_window_t window) {
+  xcb_motion_notify_event_t event{};
+  event.event = window;
+  AddEvent(events, XCB_MOTION_NOTIFY, event);
+}
+
+void AddButtonPress(EventList& events, xcb_window_t window) {
+  xcb_button_press_event_t event{};
+  event.event = window;
+  AddEvent(events, XCB_BUTTON_PRESS, event);
+}
+
+void AddExpose(EventList& events, xcb_window_t window, std::uint16_t x,
+               std::uint16_t y, std::uint16_t width, std::uint16_t height) {
+  xcb_expose_event_t event{};
+  event.window = window;
+  event.x = x;
+  event.y = y;
+  event.width = width;
+  event.height = height;
+  AddEvent(events, XCB_EXPOSE, event);
+}
+
+void AddConfigure(EventList& events, xcb_window_t window,
+                  std::uint16_t width) {
+  xcb_configure_notify_event_t event{};
+  event.window = window;
+  event.width = width;
+  AddEvent(events, XCB_CONFIGURE_NOTIFY, event);
+}
+
+void AddDestroy(EventList& events, xcb_window_t window) {
+  xcb_destroy_notify_event_t event{};
+  event.window = window;
+  AddEvent(events, XCB_DESTROY_NOTIFY, event);
+}
+
+// Windows 1 and 2 are own windows, others are not.
+void Compress(EventList& events) {
+  CompressXEvents(events, [](xcb_window_t window) {
+    return window == 1 || window == 2;
+  });
+}
+
+std::vector<std::size_t> GetKeptIndexes(const EventList& events) {
+  std::vector<std::size_t> indexes;
+  for (std::size_t i = 0; i < events.size(); i++) {
+    if (events[i]) indexes.push_back(i);
+  }
+  return indexes;
+}
+}  // namespace
+
+TEST_CASE("CompressXEvents should keep the latest superseding events.",
+          "[xcb]") {
+  EventList events;
+  AddMotion(events, 1);                  // 0, superseded by 1
+  AddMotion(events, 1);                  // 1, kept before button press
+  AddExpose(events, 1, 0, 0, 10, 10);    // 2, unioned into 7
+  AddConfigure(events, 1, 100);          // 3, superseded by 8
+  AddMotion(events, 2);                  // 4
+  AddButtonPress(events, 1);             // 5
+  AddMotion(events, 1);                  // 6, superseded by 11
+  AddExpose(events, 1, 20, 20, 10, 10);  // 7
+  AddConfigure(events, 1, 200);          // 8
+  AddMotion(events, 3);                  // 9, not own window
+  AddMotion(events, 3);                  // 10
+  AddMotion(events, 1);                  // 11
+
+  Compress(events);
+
+  REQUIRE(GetKeptIndexes(events) ==
+          std::vector<std::size_t>{1, 4, 5, 7, 8, 9, 10, 11});
+  auto expose = reinterpret_cast<xcb_expose_event_t*>(events[7].get());
+  REQUIRE(expose->x == 0);
+  REQUIRE(expose->y == 0);
+  REQUIRE(expose->width == 30);
+  REQUIRE(expose->height == 30);
+  REQUIRE(reinterpret_cast<xcb_configure_notify_event_t*>(events[8].get())
+              ->width == 200);
+}
+
+TEST_CASE("CompressXEvents should not compress across destroy.", "[xcb]") {
+  EventList events;
+  AddConfigure(events, 1, 100);
+  AddDestroy(events, 1);
+  AddConfigure(events, 1, 200);
+
+  Compress(events);
+
+  REQUIRE(GetKeptIndexes(events) == std::vector<std::size_t>{0, 1, 2});
+}
+
+TEST_CASE("Compressed X events should be dispatched by window id in order.",
+          "[xcb]") {
+  EventList events;
+  AddMotion(events, 2);
+  AddExpose(events, 1, 0, 0, 10, 10);
+  AddButtonPress(events, 2);
+  AddMotion(events, 1);
+  AddMotion(events, 1);
+  AddExpose(events, 1, 5, 5, 10, 10);
+  AddMotion(events, 2);
+
+  Compress(events);
+
+  std::map<xcb_window_t, std::vector<std::uint8_t>> dispatched;
+  for (const auto& event : events) {
+    if (!event) continue;
+    auto window = XcbWindow::GetEventWindow(event.get());
+    REQUIRE(window.has_value());
+    dispatched[*window].push_back(event->response_type);
+  }
+
+  REQUIRE(dispatched[1] ==
+          std::vector<std::uint8_t>{XCB_MOTION_NOTIFY, XCB_EXPOSE});
+  REQUIRE(dispatched[2] == std::vector<std::uint8_t>{XCB_MOTION_NOTIFY,
+                                                     XCB_BUTTON_PRESS,
+                                                     XCB_MOTION_NOTIFY});
+}
+
+TEST_CASE("HandleXEventBatches should handle events queued by handlers.",
+          "[xcb]") {
+  // Events of a fake connection, in the order they are polled.
+  EventList connection;
+  AddMotion(connection, 1);
+  AddButtonPress(connection, 1);
+  std::deque<AutoFreePtr<xcb_generic_event_t>> queue;
+  for (auto& event : connection) queue.push_back(std::move(event));
+
+  std::vector<bool> polls;
+  std::vector<std::uint8_t> handled;
+  HandleXEventBatches(
+      [&](bool queued_only) -> xcb_generic_event_t* {
+        polls.push_back(queued_only);
+        if (queue.empty()) return nullptr;
+        auto event = queue.front().release();
+        queue.pop_front();
+        return event;
+      },
+      [](xcb_window_t window) { return window == 1; },
+      [&](xcb_generic_event_t* event) {
+        handled.push_back(event->response_type);
+        if (event->response_type == XCB_BUTTON_PRESS) {
+          // Like an event read while waiting for a reply in a handler.
+          EventList read;
+          AddExpose(read, 1, 0, 0, 10, 10);
+          AddExpose(read, 1, 5, 5, 10, 10);
+          for (auto& expose : read) queue.push_back(std::move(expose));
+        }
+      });
+
+  REQUIRE(handled == std::vector<std::uint8_t>{XCB_MOTION_NOTIFY,
+                                               XCB_BUTTON_PRESS, XCB_EXPOSE});
+  // Only the first batch may read the connection.
+  REQUIRE(polls ==
+          std::vector<bool>{false, false, false, true, true, true, true});
+}
@@ -0,0 +1,240 @@
+#include "MockUiApplication.h"
+#include "cru/ui/render/CanvasRenderObject.h"
+#include "cru/ui/render/HitTestGrid.h"
+#include "cru/ui/render/LayoutRenderObject.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using cru::Index;
+using cru::platform::Point;
+using cru::platform::Rect;
+using cru::platform::Size;
+using cru::ui::render::CanvasRenderObject;
+using cru::ui::render::HitTestGrid;
+using cru::ui::render::LayoutRenderObject;
+using cru::ui::render::MeasureRequirement;
+using cru::ui::render::MeasureSize;
+using cru::ui::render::RenderObject;
+
+namespace {
+// Places each child at the rect in its layout data.
+class RectLayoutRenderObject : public LayoutRenderObject<Rect> {
+ public:
+  RectLayoutRenderObject() : LayoutRenderObject("RectLayoutRenderObject") {}
+
+  void Relayout() {
+    Measure(MeasureRequirement(Size(1000, 1000), MeasureSize::NotSpecified(),
+                               Size(1000, 1000)));
+    Layout(Rect(0, 0, 1000, 1000));
+  }
+
+  // What HitTest returns without the grid.
+  RenderObject* LinearHitTest(const Point& point) {
+    for (auto i = GetChildCount() - 1; i >= 0; i--) {
+      auto child = GetChildAt(i);
+      if (auto result = child->HitTest(point - child->GetOffset())) {
+        return result;
+      }
+    }
+    return GetPaddingRect().IsPointInside(point) ? this : nullptr;
+  }
+
+ protected:
+  Size OnMeasureContent(const MeasureRequirement& requirement) override {
+    for (Index i = 0; i < GetChildCount(); i++) {
+      MeasureSize size(GetChildLayoutDataAt(i).GetSize());
+      GetChildAt(i)->Measure(MeasureRequirement(size, size, size));
+    }
+    return requirement.Coerce(requirement.suggest.GetSizeOr0());
+  }
+
+  void OnLayoutContent(const Rect& content_rect) override {
+    CRU_UNUSED(content_rect)
+    for (Index i = 0; i < GetChildCount(); i++) {
+      GetChildAt(i)->Layout(GetChildLayoutDataAt(i).GetLeftTop());
+    }
+  }
+};
+
+// Has no size, but its content overflows into a 10x10 square.
+class OverflowRenderObject : public CanvasRenderObject {
+ public:
+  RenderObject* HitTest(const Point& point) override {
+    return Rect(0, 0, 10, 10).IsPointInside(point) ? this : nullptr;
+  }
+  Rect GetHitTestBounds() override { return Rect(0, 0, 10, 10); }
+};
+
+struct TestLayout {
+  void Add(std::unique_ptr<RenderObject> child, const Rect& rect) {
+    layout.AddChild(child.get(), layout.GetChildCount());
+    layout.SetChildLayoutDataAt(layout.GetChildCount() - 1, rect);
+    children.push_back(std::move(child));
+  }
+
+  void Add(const Rect& rect) {
+    Add(std::make_unique<CanvasRenderObject>(), rect);
+  }
+
+  // Destroyed after layout, which doesn't expect them to go first.
+  std::vector<std::unique_ptr<RenderObject>> children;
+  RectLayoutRenderObject layout;
+};
+
+std::vector<Index> ToVector(std::span<const Index> indexes) {
+  return {indexes.begin(), indexes.end()};
+}
+}  // namespace
+
+TEST_CASE("HitTestGrid should find all rects containing a point.",
+          "[hit-test-grid]") {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(0, 900);
+  std::uniform_real_distribution<float> length(1, 300);
+  std::vector<Rect> rects;
+  for (int i = 0; i < 200; i++) {
+    rects.emplace_back(position(random), position(random), length(random),
+                       length(random));
+  }
+
+  HitTestGrid grid;
+  grid.Build(rects);
+
+  for (int i = 0; i < 1000; i++) {
+    Point point(position(random), position(random));
+    auto candidates = ToVector(grid.Query(point));
+    REQUIRE(std::ranges::is_sorted(candidates));
+    for (Index j = 0; j < static_cast<Index>(rects.size()); j++) {
+      if (rects[j].IsPointInside(point)) {
+        REQUIRE(std::ranges::binary_search(candidates, j));
+      }
+    }
+  }
+}
+
+TEST_CASE("HitTestGrid should keep unsized rects out of cells.",
+          "[hit-test-grid]") {
+  std::vector<Rect> rects{Rect(0, 0, 100, 100), Rect(10, 10, 0, 0),
+                          Rect(50, 50, 100, 100), Rect(20, 20, 0, 5)};
+  HitTestGrid grid;
+  grid.Build(rects);
+  REQUIRE(ToVector(grid.GetUnsizedIndexes()) == std::vector<Index>{1, 3});
+  auto candidates = ToVector(grid.Query(Point(10, 10)));
+  REQUIRE(std::ranges::binary_search(candidates, 0));
+  REQUIRE_FALSE(std::ranges::binary_search(candidates, 1));
+  REQUIRE_FALSE(std::ranges::binary_search(candidates, 3));
+}
+
+TEST_CASE("HitTestGrid update should match a rebuild.", "[hit-test-grid]") {
+  std::vector<Rect> rects;
+  for (int i = 0; i < 100; i++) {
+    rects.emplace_back((i % 10) * 100.f, (i / 10) * 100.f, 100, 100);
+  }
+  HitTestGrid grid;
+  grid.Build(rects);
+
+  // Swap two and span one over several cells, all inside bounds.
+  std::swap(rects[3], rects[77]);
+  rects[50] = Rect(150, 150, 500, 20);
+  grid.Update(rects);
+
+  HitTestGrid rebuilt;
+  rebuilt.Build(rects);
+  for (float x = 5; x < 1000; x += 25) {
+    for (float y = 5; y < 1000; y += 25) {
+      REQUIRE(ToVector(grid.Query(Point(x, y))) ==
+              ToVector(rebuilt.Query(Point(x, y))));
+    }
+  }
+}
+
+TEST_CASE("LayoutRenderObject hit test should let last child win.",
+          "[hit-test-grid]") {
+  MockUiApplication application;
+  TestLayout test;
+  // Overlapping cells, the later ones spanning many of them.
+  for (int i = 0; i < 30; i++) {
+    test.Add(Rect(i * 30.f, i * 30.f, 100, 100));
+  }
+  test.Add(Rect(0, 0, 1000, 50));
+  test.Add(Rect(0, 0, 50, 1000));
+  test.Add(std::make_unique<OverflowRenderObject>(), Rect(20, 20, 0, 0));
+  test.layout.Relayout();
+
+  REQUIRE(test.layout.HitTest(Point(25, 25)) == test.children[32].get());
+  REQUIRE(test.layout.HitTest(Point(5, 500)) == test.children[31].get());
+  REQUIRE(test.layout.HitTest(Point(500, 5)) == test.children[30].get());
+  REQUIRE(test.layout.HitTest(Point(95, 95)) == test.children[3].get());
+  REQUIRE(test.layout.HitTest(Point(999, 999)) == &test.layout);
+}
+
+TEST_CASE("LayoutRenderObject hit test should match the linear path.",
+          "[hit-test-grid]") {
+  MockUiApplication application;
+  TestLayout test;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> position(0, 900);
+  std::uniform_real_distribution<float> length(1, 200);
+  for (int i = 0; i < 100; i++) {
+    if (i % 10 == 0) {
+      test.Add(std::make_unique<OverflowRenderObject>(),
+               Rect(position(random), position(random), 0, 0));
+    } else {
+      test.Add(Rect(position(random), position(random), length(random),
+                    length(random)));
+    }
+  }
+
+  auto check = [&] {
+    test.layout.Relayout();
+    for (int i = 0; i < 2000; i++) {
+      Point point(position(random), position(random));
+      REQUIRE(test.layout.HitTest(point) == test.layout.LinearHitTest(point));
+    }
+    for (Index i = 0; i < test.layout.GetChildCount(); i += 10) {
+      auto point = test.layout.GetChildLayoutDataAt(i).GetLeftTop();
+      REQUIRE(test.layout.HitTest(point + Point(1, 1)) ==
+              test.layout.LinearHitTest(point + Point(1, 1)));
+    }
+  };
+
+  check();
+
+  // Few children move, so the grid is updated in place in layout.
+  test.layout.SetChildLayoutDataAt(5, Rect(10, 10, 300, 300));
+  test.layout.SetChildLayoutDataAt(20, Rect(400, 400, 0, 0));
+  check();
+}
+
+TEST_CASE("LayoutRenderObject hit test should find overflowing grandchildren.",
+          "[hit-test-grid]") {
+  // Same result below and above the grid threshold.
+  for (int sibling_count : {15, 16, 40}) {
+    MockUiApplication application;
+    // Destroyed after the nested layout, like children of TestLayout.
+    auto grandchild = std::make_unique<CanvasRenderObject>();
+    TestLayout test;
+    auto nested = std::make_unique<RectLayoutRenderObject>();
+    auto nested_ptr = nested.get();
+    nested->AddChild(grandchild.get(), 0);
+    // Outside of the 50x50 nested layout.
+    nested->SetChildLayoutDataAt(0, Rect(100, 100, 20, 20));
+    test.Add(std::move(nested), Rect(0, 0, 50, 50));
+    for (int i = 0; i < sibling_count; i++) {
+      test.Add(Rect(300 + (i % 10) * 50.f, (i / 10) * 50.f, 40, 40));
+    }
+    test.layout.Relayout();
+
+    REQUIRE(nested_ptr->GetHitTestBounds() == Rect(0, 0, 120, 120));
+    REQUIRE(test.layout.HitTest(Point(110, 110)) == grandchild.get());
+    REQUIRE(test.layout.HitTest(Point(110, 110)) ==
+            test.layout.LinearHitTest(Point(110, 110)));
+    REQUIRE(test.layout.HitTest(Point(10, 10)) == nested_ptr);
+    REQUIRE(test.layout.HitTest(Point(80, 80)) == &test.layout);
+  }
+}
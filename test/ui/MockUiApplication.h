@@ -0,0 +1,332 @@
+#pragma once
+#include "cru/platform/graphics/Factory.h"
+#include "cru/platform/gui/UiApplication.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class MockGraphicsResource
+    : public virtual cru::platform::graphics::IGraphicsResource {
+ public:
+  std::string GetPlatformId() const override { return "Mock"; }
+  cru::platform::graphics::IGraphicsFactory* GetGraphicsFactory() override {
+    return nullptr;
+  }
+};
+
+class MockSolidColorBrush
+    : public MockGraphicsResource,
+      public virtual cru::platform::graphics::ISolidColorBrush {
+ public:
+  cru::platform::Color GetColor() override { return color_; }
+  void SetColor(const cru::platform::Color& color) override { color_ = color; }
+
+ private:
+  cru::platform::Color color_;
+};
+
+class MockGeometry : public MockGraphicsResource,
+                     public virtual cru::platform::graphics::IGeometry {
+ public:
+  bool FillContains(const cru::platform::Point& point) override {
+    CRU_UNUSED(point)
+    return false;
+  }
+  cru::platform::Rect GetBounds() override { return {}; }
+  std::unique_ptr<IGeometry> Transform(
+      const cru::platform::Matrix& matrix) override {
+    CRU_UNUSED(matrix)
+    return std::make_unique<MockGeometry>();
+  }
+};
+
+class MockGeometryBuilder
+    : public MockGraphicsResource,
+      public virtual cru::platform::graphics::IGeometryBuilder {
+ public:
+  cru::platform::Point GetCurrentPosition() override { return position_; }
+  void MoveTo(const cru::platform::Point& point) override { position_ = point; }
+  void LineTo(const cru::platform::Point& point) override { position_ = point; }
+  void CubicBezierTo(const cru::platform::Point& start_control_point,
+                     const cru::platform::Point& end_control_point,
+                     const cru::platform::Point& end_point) override {
+    CRU_UNUSED(start_control_point)
+    CRU_UNUSED(end_control_point)
+    position_ = end_point;
+  }
+  void QuadraticBezierTo(const cru::platform::Point& control_point,
+                         const cru::platform::Point& end_point) override {
+    CRU_UNUSED(control_point)
+    position_ = end_point;
+  }
+  void CloseFigure(bool close) override { CRU_UNUSED(close) }
+  std::unique_ptr<cru::platform::graphics::IGeometry> Build() override {
+    return std::make_unique<MockGeometry>();
+  }
+
+ private:
+  cru::platform::Point position_;
+};
+
+class MockFont : public MockGraphicsResource,
+                 public virtual cru::platform::graphics::IFont {
+ public:
+  std::string GetFontName() override { return "Mock"; }
+  float GetFontSize() override { return 16; }
+};
+
+/**
+ * Every byte is 10 wide and every line is 20 high. Lines wrap before any byte
+ * that doesn't fit. Counts how text is pushed to it.
+ */
+class MockTextLayout : public MockGraphicsResource,
+                       public virtual cru::platform::graphics::ITextLayout {
+ public:
+  static constexpr float kCharWidth = 10;
+  static constexpr float kLineHeight = 20;
+
+  MockTextLayout(std::shared_ptr<cru::platform::graphics::IFont> font,
+                 std::string text)
+      : font_(std::move(font)), text_(std::move(text)) {}
+
+  std::string GetText() override {
+    get_text_count++;
+    return text_;
+  }
+  std::string_view GetTextView() override { return text_; }
+  void SetText(std::string new_text) override {
+    set_text_count++;
+    text_ = std::move(new_text);
+  }
+  void ReplaceText(cru::Index position, cru::Index count,
+                   std::string_view text) override {
+    replace_text_count++;
+    replaced_byte_count += count + static_cast<cru::Index>(text.size());
+    text_.replace(position, count, text);
+  }
+
+  std::shared_ptr<cru::platform::graphics::IFont> GetFont() override {
+    return font_;
+  }
+  void SetFont(std::shared_ptr<cru::platform::graphics::IFont> font) override {
+    font_ = std::move(font);
+  }
+
+  void SetMaxWidth(float max_width) override { this->max_width = max_width; }
+  void SetMaxHeight(float max_height) override { CRU_UNUSED(max_height) }
+
+  bool IsEditMode() override { return edit_mode_; }
+  void SetEditMode(bool enable) override { edit_mode_ = enable; }
+
+  cru::Index GetLineIndexFromCharIndex(cru::Index char_index) override {
+    auto lines = GetLines();
+    for (cru::Index i = 1; i < static_cast<cru::Index>(lines.size()); i++) {
+      if (lines[i].first > char_index) return i - 1;
+    }
+    return static_cast<cru::Index>(lines.size()) - 1;
+  }
+  cru::Index GetLineCount() override {
+    return static_cast<cru::Index>(GetLines().size());
+  }
+  float GetLineHeight(cru::Index line_index) override {
+    CRU_UNUSED(line_index)
+    return kLineHeight;
+  }
+
+  cru::platform::Rect GetTextBounds(
+      bool includingTrailingSpace = false) override {
+    CRU_UNUSED(includingTrailingSpace)
+    auto lines = GetLines();
+    cru::Index max_length = 0;
+    for (const auto& line : lines) {
+      max_length = std::max(max_length, line.second);
+    }
+    return cru::platform::Rect(0, 0, max_length * kCharWidth,
+                               lines.size() * kLineHeight);
+  }
+  std::vector<cru::platform::Rect> TextRangeRect(
+      const cru::platform::TextRange& text_range) override {
+    CRU_UNUSED(text_range)
+    return {};
+  }
+  cru::platform::Rect TextSinglePoint(cru::Index position,
+                                      bool trailing) override {
+    CRU_UNUSED(trailing)
+    auto line = GetLineIndexFromCharIndex(position);
+    auto column = position - GetLines()[line].first;
+    return cru::platform::Rect(column * kCharWidth, line * kLineHeight, 0,
+                               kLineHeight);
+  }
+  cru::platform::graphics::TextHitTestResult HitTest(
+      const cru::platform::Point& point) override {
+    CRU_UNUSED(point)
+    return {0, false, false, 0};
+  }
+
+  // Start and length of each line after wrapping.
+  std::vector<std::pair<cru::Index, cru::Index>> GetLines() {
+    const auto size = static_cast<cru::Index>(text_.size());
+    const auto line_length =
+        max_width >= kCharWidth * size
+            ? std::max<cru::Index>(size, 1)
+            : std::max(static_cast<cru::Index>(max_width / kCharWidth),
+                       cru::Index{1});
+    std::vector<std::pair<cru::Index, cru::Index>> lines;
+    for (cru::Index start = 0;;) {
+      auto line_feed = text_.find('\n', start);
+      auto end = line_feed == std::string::npos
+                     ? size
+                     : static_cast<cru::Index>(line_feed);
+      auto line_start = start;
+      do {
+        auto length = std::min(line_length, end - line_start);
+        lines.emplace_back(line_start, length);
+        line_start += length;
+      } while (line_start < end);
+      if (line_feed == std::string::npos) break;
+      start = end + 1;
+    }
+    return lines;
+  }
+
+ public:
+  float max_width = std::numeric_limits<float>::max();
+  int get_text_count = 0;
+  int set_text_count = 0;
+  int replace_text_count = 0;
+  cru::Index replaced_byte_count = 0;
+
+ private:
+  std::shared_ptr<cru::platform::graphics::IFont> font_;
+  std::string text_;
+  bool edit_mode_ = false;
+};
+
+class MockGraphicsFactory
+    : public virtual cru::platform::graphics::IGraphicsFactory {
+ public:
+  std::string GetPlatformId() const override { return "Mock"; }
+
+  std::unique_ptr<cru::platform::graphics::ISolidColorBrush>
+  CreateSolidColorBrush() override {
+    return std::make_unique<MockSolidColorBrush>();
+  }
+  std::unique_ptr<cru::platform::graphics::IGeometryBuilder>
+  CreateGeometryBuilder() override {
+    return std::make_unique<MockGeometryBuilder>();
+  }
+  std::unique_ptr<cru::platform::graphics::IFont> CreateFont(
+      std::string font_family, float font_size) override {
+    CRU_UNUSED(font_family)
+    CRU_UNUSED(font_size)
+    return std::make_unique<MockFont>();
+  }
+  std::unique_ptr<cru::platform::graphics::ITextLayout> CreateTextLayout(
+      std::shared_ptr<cru::platform::graphics::IFont> font,
+      std::string text) override {
+    auto text_layout =
+        std::make_unique<MockTextLayout>(std::move(font), std::move(text));
+    last_text_layout = text_layout.get();
+    return text_layout;
+  }
+  cru::platform::graphics::TextMeasure MeasureText(
+      std::shared_ptr<cru::platform::graphics::IFont> font,
+      std::string_view text) override {
+    measure_text_count++;
+    return IGraphicsFactory::MeasureText(std::move(font), text);
+  }
+  cru::platform::Size MeasureTextForWidth(
+      std::shared_ptr<cru::platform::graphics::IFont> font,
+      std::string_view text, float max_width) override {
+    measure_text_for_width_count++;
+    return IGraphicsFactory::MeasureTextForWidth(std::move(font), text,
+                                                 max_width);
+  }
+  cru::platform::graphics::IImageFactory* GetImageFactory() override {
+    return nullptr;
+  }
+
+ public:
+  // May be destroyed. Measuring creates text layouts too.
+  MockTextLayout* last_text_layout = nullptr;
+  int measure_text_count = 0;
+  int measure_text_for_width_count = 0;
+};
+
+/**
+ * Only runs immediates, when told to. Create one per test before any control
+ * or render object, as they may set timers.
+ */
+class MockUiApplication : public cru::platform::gui::IUiApplication {
+ public:
+  std::string GetPlatformId() const override { return "Mock"; }
+
+  int Run() override { return 0; }
+  void RequestQuit(int quit_code) override { CRU_UNUSED(quit_code) }
+  void AddOnQuitHandler(std::function<void()> handler) override {
+    CRU_UNUSED(handler)
+  }
+  bool IsQuitOnAllWindowClosed() override { return false; }
+  void SetQuitOnAllWindowClosed(bool quit_on_all_window_closed) override {
+    CRU_UNUSED(quit_on_all_window_closed)
+  }
+
+  long long SetImmediate(std::function<void()> action) override {
+    immediate_count++;
+    immediates_.emplace(++current_timer_id_, std::move(action));
+    return current_timer_id_;
+  }
+  long long SetTimeout(std::chrono::milliseconds milliseconds,
+                       std::function<void()> action) override {
+    CRU_UNUSED(milliseconds)
+    CRU_UNUSED(action)
+    return ++current_timer_id_;
+  }
+  long long SetInterval(std::chrono::milliseconds milliseconds,
+                        std::function<void()> action) override {
+    CRU_UNUSED(milliseconds)
+    CRU_UNUSED(action)
+    return ++current_timer_id_;
+  }
+  void CancelTimer(long long id) override { immediates_.erase(id); }
+
+  // Return count of immediates run.
+  int RunImmediates() {
+    auto immediates = std::move(immediates_);
+    immediates_.clear();
+    for (auto& [id, action] : immediates) action();
+    return static_cast<int>(immediates.size());
+  }
+
+  void DeleteLater(cru::Object* object) override { delete object; }
+
+  std::vector<cru::platform::gui::INativeWindow*> GetAllWindow() override {
+    return {};
+  }
+  cru::platform::gui::INativeWindow* CreateWindow() override {
+    return nullptr;
+  }
+
+  cru::platform::graphics::IGraphicsFactory* GetGraphicsFactory() override {
+    return &graphics_factory;
+  }
+  cru::platform::gui::ICursorManager* GetCursorManager() override {
+    return nullptr;
+  }
+  cru::platform::gui::IClipboard* GetClipboard() override { return nullptr; }
+
+ public:
+  MockGraphicsFactory graphics_factory;
+  int immediate_count = 0;
+
+ private:
+  long long current_timer_id_ = 0;
+  std::map<long long, std::function<void()>> immediates_;
+};
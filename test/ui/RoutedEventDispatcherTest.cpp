@@ -0,0 +1,129 @@
+#include "cru/ui/controls/RoutedEventDispatcher.h"
+#include "cru/ui/render/CanvasRenderObject.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using cru::ui::controls::Control;
+using cru::ui::controls::RoutedEventDispatcher;
+using cru::ui::events::MouseEventArgs;
+
+namespace {
+class TestControl : public Control {
+ public:
+  TestControl() : Control("TestControl") {
+    render_object_.SetAttachedControl(this);
+  }
+
+  using Control::AddChild;
+
+  cru::ui::render::RenderObject* GetRenderObject() override {
+    return &render_object_;
+  }
+
+ private:
+  cru::ui::render::CanvasRenderObject render_object_;
+};
+
+// Index 0 is root and the last one is the deepest.
+std::vector<std::unique_ptr<TestControl>> CreateChain(int depth) {
+  std::vector<std::unique_ptr<TestControl>> controls;
+  for (int i = 0; i < depth; i++) {
+    controls.push_back(std::make_unique<TestControl>());
+    if (i != 0) controls[i - 1]->AddChild(controls[i].get());
+  }
+  return controls;
+}
+}  // namespace
+
+TEST_CASE("RoutedEventDispatcher should route in order.",
+          "[routed-event]") {
+  auto controls = CreateChain(3);
+  std::string record;
+  for (int i = 0; i < 3; i++) {
+    auto event = controls[i]->MouseMoveEvent();
+    auto c = std::to_string(i);
+    event->Tunnel()->AddHandler([&, c](MouseEventArgs&) { record += "t" + c; });
+    event->Bubble()->AddHandler([&, c](MouseEventArgs&) { record += "b" + c; });
+    event->Direct()->AddHandler([&, c](MouseEventArgs& args) {
+      REQUIRE(args.GetSender() == controls[std::stoi(c)].get());
+      REQUIRE(args.GetOriginalSender() == controls[2].get());
+      record += "d" + c;
+    });
+  }
+
+  RoutedEventDispatcher dispatcher;
+  dispatcher.Dispatch(controls[2].get(), &Control::MouseMoveEvent, nullptr,
+                      cru::ui::Point{});
+  REQUIRE(record == "t0t1t2b2b1b0d2d1d0");
+  REQUIRE_FALSE(dispatcher.IsDispatching());
+
+  record.clear();
+  dispatcher.Dispatch(controls[2].get(), &Control::MouseMoveEvent,
+                      controls[0].get(), cru::ui::Point{});
+  REQUIRE(record == "t1t2b2b1d2d1");
+}
+
+TEST_CASE("RoutedEventDispatcher should stop at handled.", "[routed-event]") {
+  auto controls = CreateChain(3);
+  std::string record;
+  controls[1]->MouseMoveEvent()->Tunnel()->AddHandler(
+      [](MouseEventArgs& args) { args.SetHandled(); });
+  for (int i = 0; i < 3; i++) {
+    auto event = controls[i]->MouseMoveEvent();
+    auto c = std::to_string(i);
+    event->Tunnel()->AddHandler([&, c](MouseEventArgs&) { record += "t" + c; });
+    event->Bubble()->AddHandler([&, c](MouseEventArgs&) { record += "b" + c; });
+    event->Direct()->AddHandler([&, c](MouseEventArgs& args) {
+      REQUIRE_FALSE(args.IsHandled());
+      record += "d" + c;
+    });
+  }
+
+  RoutedEventDispatcher dispatcher;
+  dispatcher.Dispatch(controls[2].get(), &Control::MouseMoveEvent, nullptr,
+                      cru::ui::Point{});
+  REQUIRE(record == "t0t1d2d1d0");
+}
+
+TEST_CASE("RoutedEventDispatcher should skip removed controls.",
+          "[routed-event]") {
+  auto controls = CreateChain(3);
+  RoutedEventDispatcher dispatcher;
+  std::string record;
+  for (int i = 0; i < 3; i++) {
+    auto c = std::to_string(i);
+    controls[i]->MouseMoveEvent()->Bubble()->AddHandler(
+        [&, c](MouseEventArgs&) { record += "b" + c; });
+  }
+  controls[2]->MouseMoveEvent()->Tunnel()->AddHandler(
+      [&](MouseEventArgs&) {
+        controls[0]->RemoveChild(controls[1].get());
+        dispatcher.NotifyControlRemoved(controls[1].get());
+      });
+
+  dispatcher.Dispatch(controls[2].get(), &Control::MouseMoveEvent, nullptr,
+                      cru::ui::Point{});
+  REQUIRE(record == "b0");
+}
+
+TEST_CASE("RoutedEventDispatcher benchmark.", "[routed-event][!benchmark]") {
+  constexpr int kDepth = 50;
+  auto controls = CreateChain(kDepth);
+  int count = 0;
+  for (const auto& control : controls) {
+    control->MouseMoveEvent()->Bubble()->AddHandler(
+        [&count](MouseEventArgs&) { count++; });
+  }
+
+  RoutedEventDispatcher dispatcher;
+  BENCHMARK("Dispatch mouse move from depth 50") {
+    dispatcher.Dispatch(controls.back().get(), &Control::MouseMoveEvent,
+                        nullptr, cru::ui::Point{});
+    return count;
+  };
+}
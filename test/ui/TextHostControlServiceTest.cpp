@@ -0,0 +1,171 @@
+#include "MockUiApplication.h"
+#include "cru/ui/controls/TextHostControlService.h"
+#include "cru/ui/render/TextRenderObject.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using cru::Index;
+using cru::platform::TextRange;
+using cru::ui::controls::Control;
+using cru::ui::controls::ITextHostControl;
+using cru::ui::controls::TextHostControlService;
+using cru::ui::render::ScrollRenderObject;
+using cru::ui::render::TextRenderObject;
+
+namespace {
+class TestTextControl : public Control, public virtual ITextHostControl {
+ public:
+  explicit TestTextControl(MockUiApplication* application)
+      : Control("TestTextControl"),
+        text_render_object_(
+            application->graphics_factory.CreateSolidColorBrush(),
+            application->graphics_factory.CreateFont("", 16),
+            application->graphics_factory.CreateSolidColorBrush(),
+            application->graphics_factory.CreateSolidColorBrush()),
+        text_layout_(application->graphics_factory.last_text_layout),
+        service_(this) {
+    text_render_object_.SetAttachedControl(this);
+    service_.SetEditable(true);
+  }
+
+  cru::ui::render::RenderObject* GetRenderObject() override {
+    return &text_render_object_;
+  }
+  TextRenderObject* GetTextRenderObject() override {
+    return &text_render_object_;
+  }
+  ScrollRenderObject* GetScrollRenderObject() override { return nullptr; }
+
+  MockTextLayout* GetTextLayout() { return text_layout_; }
+  TextHostControlService* GetService() { return &service_; }
+
+ private:
+  TextRenderObject text_render_object_;
+  MockTextLayout* text_layout_;
+  TextHostControlService service_;
+};
+
+// Lines of 99 letters and a line feed.
+std::string CreateText(int line_count) {
+  std::string text;
+  for (int i = 0; i < line_count; i++) {
+    text.append(99, static_cast<char>('a' + i % 26));
+    text.push_back('\n');
+  }
+  return text;
+}
+
+// Caret positions after moving by char and by word from every char boundary.
+std::vector<Index> CollectBreaks(TextHostControlService* service) {
+  std::vector<Index> breaks;
+  service->SetSelection(0);
+  while (true) {
+    auto position = service->GetCaretPosition();
+    breaks.push_back(service->NextNWordPosition(1));
+    breaks.push_back(service->PreviousNWordPosition(1));
+    auto next = service->NextNCharPosition(1);
+    if (next == position) break;
+    service->SetSelection(next);
+  }
+  return breaks;
+}
+}  // namespace
+
+TEST_CASE("TextHostControlService should push edits as replaces.",
+          "[text-service]") {
+  MockUiApplication application;
+  TestTextControl control(&application);
+  auto service = control.GetService();
+  auto text_layout = control.GetTextLayout();
+
+  service->SetText(CreateText(10000));
+  REQUIRE(text_layout->set_text_count == 1);
+
+  service->SetSelection(500000);
+  for (int i = 0; i < 100; i++) {
+    service->ReplaceSelectedText("x");
+  }
+  for (int i = 0; i < 50; i++) {
+    service->DeleteTextToFromCaret(service->GetCaretPosition() - 1);
+  }
+  service->SetSelection(TextRange{1000, 200});
+  service->ReplaceSelectedText("yz");
+
+  // Only edited bytes reach the text layout, and it is never asked for the
+  // whole text.
+  REQUIRE(text_layout->set_text_count == 1);
+  REQUIRE(text_layout->get_text_count == 0);
+  REQUIRE(text_layout->replace_text_count == 151);
+  REQUIRE(text_layout->replaced_byte_count == 100 + 50 + 202);
+  REQUIRE(control.GetTextRenderObject()->GetTextSize() ==
+          service->GetTextBuffer().GetSize());
+  REQUIRE(control.GetTextRenderObject()->GetText() == service->GetText());
+}
+
+TEST_CASE("TextHostControlService should not rebuild break window on caret "
+          "moves inside it.",
+          "[text-service]") {
+  MockUiApplication application;
+  TestTextControl control(&application);
+  auto service = control.GetService();
+  service->SetText(CreateText(200));
+
+  service->SetSelection(5000);
+  for (int i = 0; i < 2000; i++) {
+    auto position = service->GetCaretPosition();
+    auto next = service->NextNCharPosition(1);
+    REQUIRE(next == position + 1);
+    service->SetSelection(next);
+  }
+  for (int i = 0; i < 20; i++) {
+    service->SetSelection(service->PreviousNWordPosition(1));
+  }
+  REQUIRE(service->GetBreakWindowBuildCount() == 1);
+
+  service->SetSelection(19000);
+  service->NextNCharPosition(1);
+  REQUIRE(service->GetBreakWindowBuildCount() == 2);
+}
+
+TEST_CASE("TextHostControlService break window edits should match a rebuild.",
+          "[text-service]") {
+  MockUiApplication application;
+  TestTextControl control(&application);
+  auto service = control.GetService();
+  std::string text;
+  for (int i = 0; i < 30; i++) {
+    text += "hello w\u00f6rld \u4f60\u597d \U0001F600 foo-bar, baz.\n";
+  }
+  service->SetText(text);
+
+  // Build the window, then edit inside it so edits go through Replace.
+  service->SetSelection(300);
+  service->NextNCharPosition(1);
+  std::mt19937 random(3);
+  const std::vector<std::string> inserts{"x", " new words ", "\U0001F600",
+                                         "\u4f60", "a.b", "\n"};
+  for (int i = 0; i < 100; i++) {
+    auto caret = service->NextNCharPosition(random() % 40);
+    service->SetSelection(caret == service->GetTextBuffer().GetSize() ? 0
+                                                                       : caret);
+    if (random() % 3 == 0) {
+      auto to = service->PreviousNCharPosition(random() % 5 + 1);
+      service->DeleteTextToFromCaret(to);
+    } else {
+      service->ReplaceSelectedText(inserts[random() % inserts.size()]);
+    }
+  }
+  REQUIRE(service->GetBreakWindowBuildCount() == 1);
+
+  TestTextControl rebuilt_control(&application);
+  auto rebuilt = rebuilt_control.GetService();
+  rebuilt->SetText(service->GetText());
+  REQUIRE(CollectBreaks(service) == CollectBreaks(rebuilt));
+  // The whole text fits in the window, so walking it doesn't rebuild.
+  REQUIRE(service->GetBreakWindowBuildCount() == 1);
+}
@@ -0,0 +1,64 @@
+#include "MockUiApplication.h"
+#include "cru/ui/render/TextRenderObject.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using cru::platform::Rect;
+using cru::platform::Size;
+using cru::ui::render::MeasureRequirement;
+using cru::ui::render::MeasureSize;
+using cru::ui::render::TextRenderObject;
+
+namespace {
+MeasureRequirement MaxWidthRequirement(float max_width, float min_height = 0) {
+  return MeasureRequirement(MeasureSize(max_width, 1000),
+                            MeasureSize(0, min_height),
+                            MeasureSize::NotSpecified());
+}
+}  // namespace
+
+TEST_CASE("TextRenderObject should lay out at the last measured width.",
+          "[text-render-object]") {
+  MockUiApplication application;
+  auto& factory = application.graphics_factory;
+  TextRenderObject render_object(
+      factory.CreateSolidColorBrush(), factory.CreateFont("", 16),
+      factory.CreateSolidColorBrush(), factory.CreateSolidColorBrush());
+  auto text_layout = factory.last_text_layout;
+  render_object.SetText("hello world foo");
+
+  auto layout = [&] {
+    render_object.Layout(Rect(0, 0, render_object.GetMeasureResultSize().width,
+                              render_object.GetMeasureResultSize().height));
+  };
+
+  render_object.Measure(MaxWidthRequirement(100));
+  layout();
+  REQUIRE(factory.measure_text_count == 1);
+  REQUIRE(factory.measure_text_for_width_count == 1);
+  // Measured from a view of the text instead of a copy.
+  REQUIRE(text_layout->get_text_count == 0);
+  REQUIRE(text_layout->max_width == 100);
+  REQUIRE(text_layout->GetLineCount() == 2);
+
+  // Measured at a new width, then again at the same width from cache.
+  render_object.Measure(MaxWidthRequirement(60));
+  REQUIRE(factory.measure_text_for_width_count == 2);
+  render_object.Measure(MaxWidthRequirement(60, 10));
+  REQUIRE(factory.measure_text_count == 1);
+  REQUIRE(factory.measure_text_for_width_count == 2);
+  layout();
+
+  REQUIRE(text_layout->max_width == 60);
+  REQUIRE(text_layout->GetLineCount() == 3);
+  REQUIRE(render_object.GetMeasureResultSize() == Size(60, 60));
+  REQUIRE(Size(text_layout->GetTextBounds().GetRightBottom()) ==
+          render_object.GetMeasureResultSize());
+
+  // Wide enough for the whole text, so no wrapped measure is needed.
+  render_object.Measure(MaxWidthRequirement(500));
+  layout();
+  REQUIRE(factory.measure_text_for_width_count == 2);
+  REQUIRE(text_layout->GetLineCount() == 1);
+  REQUIRE(render_object.GetMeasureResultSize() == Size(150, 20));
+}
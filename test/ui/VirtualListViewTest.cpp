@@ -0,0 +1,269 @@
+#include "MockUiApplication.h"
+#include "cru/ui/controls/VirtualListView.h"
+#include "cru/ui/model/VirtualTreeModel.h"
+#include "cru/ui/render/CanvasRenderObject.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+using cru::Index;
+using cru::platform::Rect;
+using cru::platform::Size;
+using cru::ui::controls::Control;
+using cru::ui::controls::VirtualListView;
+using cru::ui::model::VirtualTreeModel;
+using cru::ui::render::MeasureRequirement;
+using cru::ui::render::MeasureSize;
+
+namespace {
+constexpr float kRowHeight = 20;
+constexpr float kViewHeight = 100;
+
+class RowControl : public Control {
+ public:
+  RowControl() : Control("RowControl") {
+    render_object_.SetAttachedControl(this);
+    render_object_.SetSuggestSize(Size(50, kRowHeight));
+  }
+
+  cru::ui::render::RenderObject* GetRenderObject() override {
+    return &render_object_;
+  }
+
+  void SetWidth(float width) {
+    render_object_.SetSuggestSize(Size(width, kRowHeight));
+  }
+
+  Index bound_index = -1;
+
+ private:
+  cru::ui::render::CanvasRenderObject render_object_;
+};
+
+struct TestList {
+  explicit TestList(std::shared_ptr<VirtualTreeModel<int>> model)
+      : model(std::move(model)) {
+    view.SetItemControlFactory([this] {
+      created_count++;
+      return std::make_unique<RowControl>();
+    });
+    view.SetItemControlBinder([](Control* control, Index index) {
+      static_cast<RowControl*>(control)->bound_index = index;
+    });
+    view.SetModel(this->model);
+  }
+
+  void Layout() {
+    auto render_object = view.GetRenderObject();
+    MeasureSize size(Size(200, kViewHeight));
+    render_object->Measure(
+        MeasureRequirement(size, MeasureSize::NotSpecified(), size));
+    render_object->Layout(Rect(0, 0, 200, kViewHeight));
+  }
+
+  // Also run the relayout for estimated row heights, like a real host does.
+  void LayoutAndSettle(MockUiApplication& application) {
+    Layout();
+    while (application.RunImmediates() != 0) Layout();
+  }
+
+  void ScrollTo(float y) {
+    view.GetScrollRenderObject()->SetScrollOffset(std::nullopt, y);
+  }
+
+  std::shared_ptr<VirtualTreeModel<int>> model;
+  VirtualListView view;
+  int created_count = 0;
+};
+
+std::shared_ptr<VirtualTreeModel<int>> CreateFlatModel(int count) {
+  auto model = std::make_shared<VirtualTreeModel<int>>();
+  for (int i = 0; i < count; i++) model->AddNode(model->GetRoot(), i);
+  return model;
+}
+
+bool IsViewportRealized(VirtualListView& view) {
+  auto list = view.GetListRenderObject();
+  auto top = view.GetScrollRenderObject()->GetScrollOffset().y;
+  auto first = list->GetRowIndexAt(top);
+  auto last = list->GetRowIndexAt(top + kViewHeight - 1);
+  return list->GetRealizedRowStart() <= first &&
+         list->GetRealizedRowStart() + list->GetRealizedRowCount() > last;
+}
+}  // namespace
+
+TEST_CASE("VirtualListView should only realize rows around viewport.",
+          "[virtual-list]") {
+  MockUiApplication application;
+  TestList list(CreateFlatModel(1000));
+  list.LayoutAndSettle(application);
+
+  auto list_render_object = list.view.GetListRenderObject();
+  REQUIRE(list_render_object->GetRealizedRowStart() == 0);
+  REQUIRE(IsViewportRealized(list.view));
+  REQUIRE(list_render_object->GetRealizedRowCount() < 20);
+  REQUIRE(list.view.GetChildCount() ==
+          list_render_object->GetRealizedRowCount());
+
+  for (Index i = 0; i < list_render_object->GetRealizedRowCount(); i++) {
+    auto control =
+        static_cast<RowControl*>(list.view.GetItemControl(i));
+    REQUIRE(control != nullptr);
+    REQUIRE(control->bound_index == i);
+    REQUIRE(control->GetRenderObject()->GetOffset().y == i * kRowHeight);
+  }
+}
+
+TEST_CASE("VirtualListView should realize rows on scroll before layout.",
+          "[virtual-list]") {
+  MockUiApplication application;
+  TestList list(CreateFlatModel(1000));
+  // So that scrolling doesn't discover more rows to show after measuring.
+  list.view.GetListRenderObject()->SetEstimatedRowHeight(kRowHeight);
+  list.LayoutAndSettle(application);
+  auto immediate_count = application.immediate_count;
+
+  list.ScrollTo(kRowHeight * 200);
+  REQUIRE(IsViewportRealized(list.view));
+
+  // Realized rows are measured in the relayout scheduled by scrolling, so
+  // layout neither realizes rows nor asks for another relayout.
+  list.Layout();
+  REQUIRE(application.immediate_count == immediate_count);
+  REQUIRE(IsViewportRealized(list.view));
+  REQUIRE(list.view.GetChildCount() ==
+          list.view.GetListRenderObject()->GetRealizedRowCount());
+}
+
+TEST_CASE("VirtualListView should recycle item controls.", "[virtual-list]") {
+  MockUiApplication application;
+  TestList list(CreateFlatModel(1000));
+  list.LayoutAndSettle(application);
+  auto created_count = list.created_count;
+
+  for (int i = 1; i <= 50; i++) {
+    list.ScrollTo(kRowHeight * 10 * i);
+    list.LayoutAndSettle(application);
+    REQUIRE(IsViewportRealized(list.view));
+  }
+
+  // A few more controls may be needed as estimated height is bigger than the
+  // real one, but not one for each row scrolled through.
+  REQUIRE(list.created_count <= created_count * 2);
+
+  auto list_render_object = list.view.GetListRenderObject();
+  auto start = list_render_object->GetRealizedRowStart();
+  for (Index i = 0; i < list_render_object->GetRealizedRowCount(); i++) {
+    auto control =
+        static_cast<RowControl*>(list.view.GetItemControl(start + i));
+    REQUIRE(control->bound_index == start + i);
+  }
+}
+
+TEST_CASE("VirtualListView should follow expanding and collapsing of tree.",
+          "[virtual-list]") {
+  MockUiApplication application;
+  auto model = std::make_shared<VirtualTreeModel<int>>();
+  std::vector<VirtualTreeModel<int>::Node*> parents;
+  for (int i = 0; i < 3; i++) {
+    auto parent = model->AddNode(model->GetRoot(), i);
+    for (int j = 0; j < 4; j++) model->AddNode(parent, i * 10 + j);
+    parents.push_back(parent);
+  }
+
+  TestList list(model);
+  auto list_render_object = list.view.GetListRenderObject();
+  auto row_count = [&] {
+    return list_render_object->GetRowIndexAt(
+        std::numeric_limits<float>::max());
+  };
+
+  list.LayoutAndSettle(application);
+  REQUIRE(row_count() == 3);
+  REQUIRE(list.view.GetChildCount() == 3);
+
+  model->SetNodeExpanded(parents[1], true);
+  list.LayoutAndSettle(application);
+  REQUIRE(row_count() == 7);
+  REQUIRE(list_render_object->GetRealizedRowCount() == 7);
+  REQUIRE(list.view.GetChildCount() == 7);
+  auto child_row = list.view.GetItemControl(2)->GetRenderObject();
+  REQUIRE(child_row->GetOffset().x == list_render_object->GetIndentWidth());
+  REQUIRE(static_cast<RowControl*>(list.view.GetItemControl(2))->bound_index ==
+          2);
+
+  model->SetNodeExpanded(parents[0], true);
+  list.LayoutAndSettle(application);
+  REQUIRE(row_count() == 11);
+
+  model->SetNodeExpanded(parents[1], false);
+  model->SetNodeExpanded(parents[0], false);
+  list.LayoutAndSettle(application);
+  REQUIRE(row_count() == 3);
+  REQUIRE(list.view.GetChildCount() == 3);
+}
+
+TEST_CASE("VirtualTreeModel should splice rows of expanded nodes.",
+          "[virtual-list]") {
+  VirtualTreeModel<int> model;
+  auto a = model.AddNode(model.GetRoot(), 0);
+  auto a1 = model.AddNode(a, 1);
+  model.AddNode(a1, 2);
+  model.AddNode(a, 3);
+  auto b = model.AddNode(model.GetRoot(), 4);
+  model.AddNode(b, 5);
+
+  auto values = [&] {
+    std::vector<int> result;
+    for (Index i = 0; i < model.GetItemCount(); i++) {
+      result.push_back(model.GetItemAt(i));
+    }
+    return result;
+  };
+
+  REQUIRE(values() == std::vector<int>{0, 4});
+  model.SetNodeExpanded(a1, true);
+  REQUIRE(values() == std::vector<int>{0, 4});
+  model.SetItemExpanded(0, true);
+  REQUIRE(values() == std::vector<int>{0, 1, 2, 3, 4});
+  model.SetNodeExpanded(b, true);
+  REQUIRE(values() == std::vector<int>{0, 1, 2, 3, 4, 5});
+  model.SetItemExpanded(1, false);
+  REQUIRE(values() == std::vector<int>{0, 1, 3, 4, 5});
+  model.SetNodeExpanded(a, false);
+  REQUIRE(values() == std::vector<int>{0, 4, 5});
+
+  // Same as a rebuilt list.
+  model.SetNodeExpanded(a, true);
+  auto spliced = values();
+  model.NotifyChanged();
+  REQUIRE(values() == spliced);
+}
+
+TEST_CASE("VirtualListView width should shrink when the widest row narrows.",
+          "[virtual-list]") {
+  MockUiApplication application;
+  TestList list(CreateFlatModel(3));
+  auto list_render_object = list.view.GetListRenderObject();
+  auto row = [&](Index index) {
+    return static_cast<RowControl*>(list.view.GetItemControl(index));
+  };
+
+  list.LayoutAndSettle(application);
+  REQUIRE(list_render_object->GetMeasureResultSize().width == 50);
+
+  row(1)->SetWidth(150);
+  list.LayoutAndSettle(application);
+  REQUIRE(list_render_object->GetMeasureResultSize().width == 150);
+
+  row(1)->SetWidth(80);
+  list.LayoutAndSettle(application);
+  REQUIRE(list_render_object->GetMeasureResultSize().width == 80);
+
+  row(1)->SetWidth(10);
+  list.LayoutAndSettle(application);
+  REQUIRE(list_render_object->GetMeasureResultSize().width == 50);
+}